@@ -1,10 +1,12 @@
 if (NOT TARGET cereal::cereal)
   # find_package(cereal ${TTG_TRACKED_CEREAL_VERSION} QUIET)
   # homebrew on macos provides cereal-config with version "unknown"
-  find_package(cereal)
+  find_package(cereal QUIET)
   if (cereal_FOUND AND NOT TARGET cereal::cereal)
     if (TARGET cereal)
-      add_library(cereal::cereal ALIAS cereal)
+      # cereal < 1.3.1 only exports target cereal; N.B. CMake < 3.18 cannot alias imported targets
+      add_library(cereal::cereal INTERFACE IMPORTED)
+      set_target_properties(cereal::cereal PROPERTIES INTERFACE_LINK_LIBRARIES cereal)
     else ()
       message(FATAL_ERROR "cereal_FOUND=TRUE but no cereal target")
     endif()
@@ -14,7 +16,7 @@ endif(NOT TARGET cereal::cereal)
 if (TARGET cereal::cereal)
   message(STATUS "Found cereal at ${cereal_CONFIG}")
 else (TARGET cereal::cereal)
-  # going hungry today
+  message(STATUS "cereal not found, serialization via cereal disabled")
 endif()
 
 # fetchcontent is disabled for now
@@ -0,0 +1,54 @@
+// Measures the latency of ttg::fence(): every iteration sends a token around a ring of all processes, then fences.
+// The per-iteration time is dominated by the fence (termination detection, synchronization, and the restart of the
+// runtime) once the ring is short.
+//
+// usage: fence-latency [number of iterations = 100] [number of hops per iteration = number of processes]
+
+#include <ttg.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+  ttg::initialize(argc, argv);
+  auto world = ttg::default_execution_context();
+
+  const int niter = argc > 1 ? std::atoi(argv[1]) : 100;
+  const int nhops = argc > 2 ? std::atoi(argv[2]) : world.size();
+
+  ttg::Edge<int, void> ring("ring");
+  auto hop = ttg::make_tt(
+      [nhops](const int &h, std::tuple<ttg::Out<int, void>> &out) {
+        if (h + 1 < nhops) ttg::sendk<0>(h + 1, out);
+      },
+      ttg::edges(ring), ttg::edges(ring), "hop", {"ring"}, {"ring"});
+  hop->set_keymap([world](const int &h) { return h % world.size(); });
+
+  ttg::make_graph_executable(hop);
+  ttg::execute();
+
+  // warm up: the first epoch pays for the startup of the runtime
+  if (world.rank() == 0) hop->invoke(0);
+  ttg::fence();
+
+  double total = 0.0, min = 0.0, max = 0.0;
+  for (int i = 0; i != niter; ++i) {
+    ttg::execute();
+    const auto start = std::chrono::high_resolution_clock::now();
+    if (world.rank() == 0) hop->invoke(0);
+    ttg::fence();
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+    total += elapsed;
+    min = (i == 0 || elapsed < min) ? elapsed : min;
+    max = (i == 0 || elapsed > max) ? elapsed : max;
+  }
+
+  if (world.rank() == 0 && niter > 0)
+    std::cout << "fence-latency: nproc=" << world.size() << " niter=" << niter << " nhops=" << nhops
+              << " avg(us)=" << total / niter << " min(us)=" << min << " max(us)=" << max << std::endl;
+
+  ttg::finalize();
+  return 0;
+}
@@ -0,0 +1,213 @@
+// Compares the communication volume induced by the keymaps of ttg/base/keymaps.h and by the default (hash) keymap
+// for the dependency patterns of 3 typical TTG programs:
+//  - tiled Cholesky factorization (cf. potrf), keys are the tile indices {i,j};
+//  - tiled matrix multiplication C = A B, task keys are {i,j,k};
+//  - multiresolution analysis on a uniformly refined 2^3-tree (cf. mrattg), keys are the boxes {n,l}.
+// The volume is counted as the number of distinct (tile or box, destination process) pairs with the destination
+// process other than the owner of the data, i.e. assuming each datum is sent once to each process that needs it;
+// contributions to reductions are counted once per contributing process other than the owner of the result.
+// No runtime is needed: the processes are simulated, so any number of them can be studied.
+//
+// usage: keymap-comm [nproc=16] [ntiles=32] [tree levels=5] [replication factor=2]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ttg/base/keymap.h"
+#include "ttg/base/keymaps.h"
+#include "ttg/util/multiindex.h"
+
+namespace {
+
+  /// accumulates the transfers and the work of a simulated run
+  struct Tally {
+    explicit Tally(int nproc) : ntasks(nproc, 0) {}
+
+    /// datum \p id owned by \p owner is needed by a task on process \p dest
+    void use(std::size_t id, int owner, int dest) {
+      ++nuses;
+      if (owner != dest) transfers.emplace(id, dest);
+    }
+    /// a task on process \p source contributes to datum \p id reduced on process \p dest
+    void contribute(std::size_t id, int source, int dest) {
+      ++nuses;
+      if (source != dest) transfers.emplace(id, source);
+    }
+    void task(int proc) { ++ntasks[proc]; }
+
+    /// max / average number of tasks per process
+    double imbalance() const {
+      std::size_t total = 0, max = 0;
+      for (auto n : ntasks) {
+        total += n;
+        max = std::max(max, n);
+      }
+      return total == 0 ? 1.0 : static_cast<double>(max) * ntasks.size() / total;
+    }
+
+    std::set<std::pair<std::size_t, int>> transfers;
+    std::size_t nuses = 0;
+    std::vector<std::size_t> ntasks;
+  };
+
+  void report(const std::string &pattern, const std::string &keymap, const Tally &tally) {
+    std::cout << std::left << std::setw(10) << pattern << std::setw(22) << keymap << std::right << std::setw(12)
+              << tally.transfers.size() << std::setw(12) << std::fixed << std::setprecision(3)
+              << static_cast<double>(tally.transfers.size()) / std::max<std::size_t>(tally.nuses, 1) << std::setw(12)
+              << tally.imbalance() << std::endl;
+  }
+
+  using Key2 = ttg::MultiIndex<2>;
+  using Key3 = ttg::MultiIndex<3>;
+
+  /// tiled Cholesky factorization of an nt×nt lower-triangular matrix; each task owns its output tile
+  template <typename Keymap>
+  Tally cholesky(int nproc, int nt, const Keymap &keymap) {
+    Tally tally(nproc);
+    auto id = [nt](int i, int j) { return static_cast<std::size_t>(i) * nt + j; };
+    for (int k = 0; k != nt; ++k) {
+      // POTRF(k)
+      tally.task(keymap(Key2(k, k)));
+      for (int m = k + 1; m < nt; ++m) {
+        // TRSM(m,k) needs L(k,k)
+        const int trsm = keymap(Key2(m, k));
+        tally.task(trsm);
+        tally.use(id(k, k), keymap(Key2(k, k)), trsm);
+        for (int n = k + 1; n <= m; ++n) {
+          // SYRK/GEMM(m,n,k) updates tile {m,n} with L(m,k) and L(n,k)
+          const int update = keymap(Key2(m, n));
+          tally.task(update);
+          tally.use(id(m, k), trsm, update);
+          if (n != m) tally.use(id(n, k), keymap(Key2(n, k)), update);
+        }
+      }
+    }
+    return tally;
+  }
+
+  /// tiled C = A B with nt×nt tiles; the task computing A(i,k) B(k,j) is mapped by \p task_map , tiles of A and B
+  /// are owned by the processes \p a_map and \p b_map map them to, the contributions to C(i,j) are reduced on the
+  /// process \p c_map maps {i,j} to
+  template <typename TaskMap, typename AMap, typename BMap, typename CMap>
+  Tally gemm(int nproc, int nt, const TaskMap &task_map, const AMap &a_map, const BMap &b_map, const CMap &c_map) {
+    Tally tally(nproc);
+    const std::size_t ntiles = static_cast<std::size_t>(nt) * nt;
+    auto id = [nt](int i, int j) { return static_cast<std::size_t>(i) * nt + j; };
+    for (int i = 0; i != nt; ++i)
+      for (int j = 0; j != nt; ++j)
+        for (int k = 0; k != nt; ++k) {
+          const int proc = task_map(Key3(i, j, k));
+          tally.task(proc);
+          tally.use(id(i, k), a_map(Key2(i, k)), proc);
+          tally.use(ntiles + id(k, j), b_map(Key2(k, j)), proc);
+          // contributions are reduced locally first, hence one transfer per (tile of C, contributing process)
+          tally.contribute(2 * ntiles + id(i, j), proc, c_map(Key2(i, j)));
+        }
+    return tally;
+  }
+
+  /// box of the 2^3-tree
+  struct Box {
+    int n = 0;
+    std::array<std::uint64_t, 3> l{};
+
+    int level() const { return n; }
+    const auto &translation() const { return l; }
+    Box parent() const {
+      Box p{n - 1, l};
+      for (auto &x : p.l) x >>= 1;
+      return p;
+    }
+    std::size_t hash() const {
+      std::size_t h = n;
+      for (auto x : l) h = ttg::detail::hash_combine_impl::fn(h, x);
+      return h;
+    }
+    std::size_t id() const {
+      // boxes at level n are numbered after the (8^n - 1)/7 boxes at coarser levels
+      std::size_t result = ((std::size_t(1) << (3 * n)) - 1) / 7;
+      return result + ((l[0] << (2 * n)) | (l[1] << n) | l[2]);
+    }
+  };
+
+  /// multiresolution analysis on the tree refined uniformly to level \p nlevels : the children of each box are
+  /// compressed into their parent, and each box is needed by the tasks applying an operator to its face neighbors
+  template <typename Keymap>
+  Tally mra(int nproc, int nlevels, const Keymap &keymap) {
+    Tally tally(nproc);
+    for (int n = 1; n <= nlevels; ++n) {
+      const std::uint64_t extent = std::uint64_t(1) << n;
+      Box box{n, {}};
+      for (box.l[0] = 0; box.l[0] != extent; ++box.l[0])
+        for (box.l[1] = 0; box.l[1] != extent; ++box.l[1])
+          for (box.l[2] = 0; box.l[2] != extent; ++box.l[2]) {
+            const int owner = keymap(box);
+            tally.task(owner);
+            tally.use(box.id(), owner, keymap(box.parent()));
+            for (int d = 0; d != 3; ++d)
+              for (int shift : {-1, 1}) {
+                if ((shift < 0 && box.l[d] == 0) || (shift > 0 && box.l[d] + 1 == extent)) continue;
+                Box neighbor = box;
+                neighbor.l[d] += shift;
+                tally.use(box.id(), owner, keymap(neighbor));
+              }
+          }
+    }
+    return tally;
+  }
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int nproc = argc > 1 ? std::atoi(argv[1]) : 16;
+  const int nt = argc > 2 ? std::atoi(argv[2]) : 32;
+  const int nlevels = argc > 3 ? std::atoi(argv[3]) : 5;
+  const int c = argc > 4 ? std::atoi(argv[4]) : 2;
+  if (nproc < 1 || nt < 1 || nlevels < 1 || c < 1) {
+    std::cerr << "usage: " << argv[0] << " [nproc=16] [ntiles=32] [tree levels=5] [replication factor=2]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "nproc = " << nproc << ", ntiles = " << nt << ", tree levels = " << nlevels << std::endl;
+  std::cout << std::left << std::setw(10) << "pattern" << std::setw(22) << "keymap" << std::right << std::setw(12)
+            << "transfers" << std::setw(12) << "remote/use" << std::setw(12) << "imbalance" << std::endl;
+
+  using sfc = ttg::space_filling_curve;
+  const ttg::detail::default_keymap_impl<Key2> hash2(nproc);
+  const ttg::detail::default_keymap_impl<Key3> hash3(nproc);
+  const ttg::block_cyclic_keymap_2d cyclic2(nproc);
+  const std::array<std::size_t, 2> extents{static_cast<std::size_t>(nt), static_cast<std::size_t>(nt)};
+  const ttg::sfc_keymap<2> morton2(nproc, extents, sfc::morton);
+  const ttg::sfc_keymap<2> hilbert2(nproc, extents, sfc::hilbert);
+
+  report("potrf", "hash", cholesky(nproc, nt, hash2));
+  report("potrf", "block-cyclic 2d", cholesky(nproc, nt, cyclic2));
+  report("potrf", "morton", cholesky(nproc, nt, morton2));
+  report("potrf", "hilbert", cholesky(nproc, nt, hilbert2));
+
+  // the 2D distributions own the {i,j} task and the C(i,j) tile on the same process
+  auto ij = [](const auto &map) { return [&map](const Key3 &key) { return map(Key2(key[0], key[1])); }; };
+  report("gemm", "hash", gemm(nproc, nt, hash3, hash2, hash2, hash2));
+  report("gemm", "block-cyclic 2d", gemm(nproc, nt, ij(cyclic2), cyclic2, cyclic2, cyclic2));
+  report("gemm", "hilbert", gemm(nproc, nt, ij(hilbert2), hilbert2, hilbert2, hilbert2));
+  if (nproc % c == 0) {
+    // A(i,k) and B(k,j) live on layer k%c, C(i,j) on layer 0
+    const ttg::block_cyclic_keymap_3d cyclic3(nproc, c);
+    auto a_map = [&cyclic3](const Key2 &key) { return cyclic3(Key3(key[0], key[1], key[1])); };
+    auto b_map = [&cyclic3](const Key2 &key) { return cyclic3(Key3(key[0], key[1], key[0])); };
+    auto c_map = [&cyclic3](const Key2 &key) { return cyclic3(Key3(key[0], key[1], 0)); };
+    report("gemm", "block-cyclic 3d c=" + std::to_string(c), gemm(nproc, nt, cyclic3, a_map, b_map, c_map));
+  }
+
+  report("mra", "hash", mra(nproc, nlevels, ttg::detail::default_keymap_impl<Box>(nproc)));
+  report("mra", "level", mra(nproc, nlevels, ttg::level_keymap(nproc)));
+  report("mra", "morton", mra(nproc, nlevels, ttg::tree_sfc_keymap<3>(nproc, sfc::morton)));
+  report("mra", "hilbert", mra(nproc, nlevels, ttg::tree_sfc_keymap<3>(nproc, sfc::hilbert)));
+
+  return 0;
+}
@@ -36,14 +36,10 @@ namespace potrf {
       std::cout << "After POTRF(" << key << "), A(" << K << ", " << K << ") is " << tile_kk << std::endl;
 #endif
 
-      /* send the tile to outputs */
-      std::vector<Key2> keylist;
-      keylist.reserve(A.rows() - K);
-      /* TODO: reverse order of arrays */
-      for (int m = K + 1; m < A.rows(); ++m) {
-        /* send tile to trsm */
-        if (ttg::tracing()) ttg::print("POTRF(", key, "): sending output to TRSM(", Key2{m, K}, ")");
-        keylist.push_back(Key2(m, K));
+      /* send the tile to outputs, the TRSM keys are generated on the fly */
+      auto keylist = ttg::make_generated_range(A.rows() - K - 1, [K](std::size_t m) { return Key2(K + 1 + m, K); });
+      if (ttg::tracing()) {
+        for (auto&& trsm_key : keylist) ttg::print("POTRF(", key, "): sending output to TRSM(", trsm_key, ")");
       }
       ttg::broadcast<0, 1>(std::make_tuple(Key2(K, K), keylist), std::move(tile_kk), out);
     };
@@ -248,7 +244,8 @@ namespace potrf {
 
   template <typename MatrixT>
   auto make_potrf_ttg(MatrixT& A, ttg::Edge<Key2, MatrixTile<typename MatrixT::element_type>>& input,
-                      ttg::Edge<Key2, MatrixTile<typename MatrixT::element_type>>& output, bool defer_write) {
+                      ttg::Edge<Key2, MatrixTile<typename MatrixT::element_type>>& output, bool defer_write,
+                      bool tile_affinity = false) {
     using T = typename MatrixT::element_type;
     auto keymap1 = [&](const Key1& key) { return A.rank_of(key[0], key[0]); };
 
@@ -297,6 +294,15 @@ namespace potrf {
               6 * (key[0] - key[2]));
     });
 
+    if (tile_affinity) {
+      /* run all updates of a tile on the same thread to keep the tile in its cache */
+      auto tile_thread = [](int m, int n) { return static_cast<int>(ttg::detail::hash_combine_impl::fn(m, n)); };
+      tt_potrf->set_affinitymap([=](const Key1& key) { return tile_thread(key[0], key[0]); });
+      tt_trsm->set_affinitymap([=](const Key2& key) { return tile_thread(key[0], key[1]); });
+      tt_syrk->set_affinitymap([=](const Key2& key) { return tile_thread(key[0], key[0]); });
+      tt_gemm->set_affinitymap([=](const Key3& key) { return tile_thread(key[0], key[1]); });
+    }
+
     auto ins = std::make_tuple(tt_dispatch->template in<0>());
     auto outs = std::make_tuple(tt_potrf->template out<0>());
     std::vector<std::unique_ptr<ttg::TTBase>> ops(5);
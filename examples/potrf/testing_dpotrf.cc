@@ -54,6 +54,7 @@ int main(int argc, char **argv)
 
   bool check = !cmdOptionExists(argv+1, argv+argc, "-x");
   bool cow_hint = !cmdOptionExists(argv+1, argv+argc, "-w");
+  bool tile_affinity = cmdOptionExists(argv+1, argv+argc, "-a");
 
   ttg::initialize(argc, argv, nthreads);
 
@@ -108,7 +109,7 @@ int main(int argc, char **argv)
     init_tt->set_keymap([&]() {return world.rank();});
 
     auto plgsy_ttg = make_plgsy_ttg(A, N, random_seed, startup, topotrf, cow_hint);
-    auto potrf_ttg = potrf::make_potrf_ttg(A, topotrf, result, cow_hint);
+    auto potrf_ttg = potrf::make_potrf_ttg(A, topotrf, result, cow_hint, tile_affinity);
     auto result_ttg = make_result_ttg(A, result, cow_hint);
 
     auto connected = make_graph_executable(init_tt.get());
@@ -172,7 +173,7 @@ int main(int argc, char **argv)
     ttg::Edge<Key2, MatrixTile<double>> toresult("To Result");
 
     auto load_plgsy = make_load_tt(A, topotrf, cow_hint);
-    auto potrf_ttg = potrf::make_potrf_ttg(A, topotrf, toresult, cow_hint);
+    auto potrf_ttg = potrf::make_potrf_ttg(A, topotrf, toresult, cow_hint, tile_affinity);
     auto result2_ttg = make_result_ttg(A, toresult, cow_hint);
 
     connected = make_graph_executable(load_plgsy.get());
@@ -0,0 +1,90 @@
+// Measures the latency and bandwidth of task-graph reductions of a vector of doubles over all processes, for every
+// tree shape of ttg::TreeReduce and ttg::make_segmented_tree_reduce. Each measurement is one reduction followed by a
+// fence, hence includes the cost of the fence (see fence-latency).
+//
+// usage: tree-reduce-bench [number of iterations = 10] [maximum number of doubles = 2^20] [arity of k-ary trees = 4]
+
+#include <ttg.h>
+
+#include "ttg/serialization/std/vector.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Value = std::vector<double>;
+
+struct vector_plus {
+  Value operator()(const Value &a, const Value &b) const {
+    Value c(a);
+    for (std::size_t i = 0; i != c.size(); ++i) c[i] += b[i];
+    return c;
+  }
+};
+
+/// @return the duration of one reduction of @p n doubles, in seconds
+double reduce_once(ttg::TreeShape shape, int arity, std::size_t n, int nsegments) {
+  auto world = ttg::default_execution_context();
+  ttg::Edge<int, Value> G2R, R2C;
+  auto generator = ttg::make_tt<int>(
+      [n](const int &key, std::tuple<ttg::Out<int, Value>> &out) { ttg::send<0>(key, Value(n, key), out); },
+      ttg::edges(), ttg::edges(G2R), "generator");
+  auto consumer = ttg::make_tt([](const int &key, const Value &value, std::tuple<> &out) {}, ttg::edges(R2C),
+                               ttg::edges(), "consumer");
+  std::unique_ptr<ttg::TTBase> reduction;
+  if (nsegments == 0)
+    reduction = std::make_unique<ttg::TreeReduce<Value, vector_plus, int>>(G2R, R2C, shape, arity);
+  else
+    reduction = ttg::make_segmented_tree_reduce(G2R, R2C, nsegments, shape, arity, 0, 0, vector_plus{});
+  generator->make_executable();
+  reduction->make_executable();
+  consumer->make_executable();
+  ttg::fence();
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  generator->invoke(world.rank());
+  ttg::fence();
+  const auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  ttg::initialize(argc, argv);
+  auto world = ttg::default_execution_context();
+
+  const int niter = argc > 1 ? std::atoi(argv[1]) : 10;
+  const std::size_t max_n = argc > 2 ? std::atol(argv[2]) : (1 << 20);
+  const int arity = argc > 3 ? std::atoi(argv[3]) : 4;
+
+  ttg::execute();
+
+  const std::pair<ttg::TreeShape, std::string> shapes[] = {{ttg::TreeShape::binary, "binary"},
+                                                           {ttg::TreeShape::kary, std::to_string(arity) + "-ary"},
+                                                           {ttg::TreeShape::binomial, "binomial"}};
+  if (world.rank() == 0)
+    std::cout << "tree-reduce-bench: nproc=" << world.size() << " niter=" << niter << std::endl
+              << "shape\tsegments\tbytes\tlatency(us)\tbandwidth(MB/s)" << std::endl;
+  for (std::size_t n = 1; n <= max_n; n *= 32) {
+    // 0 = TreeReduce, whole values
+    for (int nsegments : {0, 1, 8}) {
+      if (nsegments > 0 && static_cast<std::size_t>(nsegments) > n) continue;
+      for (const auto &[shape, name] : shapes) {
+        reduce_once(shape, arity, n, nsegments);  // warm up
+        double elapsed = 0;
+        for (int i = 0; i != niter; ++i) elapsed += reduce_once(shape, arity, n, nsegments);
+        const double latency = elapsed / niter;
+        const double bytes = n * sizeof(double);
+        if (world.rank() == 0)
+          std::cout << name << "\t" << nsegments << "\t" << bytes << "\t" << latency * 1e6 << "\t"
+                    << bytes / latency / 1e6 << std::endl;
+      }
+    }
+  }
+
+  ttg::finalize();
+  return 0;
+}
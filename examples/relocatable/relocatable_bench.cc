@@ -0,0 +1,86 @@
+// Measures the benefit of the dynamic load balancing of relocatable TTs (see ttg::TTBase::set_relocatable()):
+// a producer on process 0 generates independent tasks of which the keymap puts the given fraction on process 0 and
+// spreads the others over all processes; every task spins for the given time. The same tasks are executed by a TT
+// that is not relocatable, then by one that is, in separate epochs, and the time to solution of both is reported,
+// together with the largest number of tasks executed by a process over the average (1 = perfect balance).
+//
+// usage: relocatable-bench [number of tasks = 10000] [task duration (us) = 100] [fraction on process 0 = 0.5]
+
+#include <ttg.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+namespace {
+
+  void spin(long duration_us) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(duration_us);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+
+  /// executes the tasks with a consumer TT that is relocatable or not
+  /// @return the time to solution (s) and the max/avg number of tasks per process
+  std::pair<double, double> run(ttg::World world, int ntasks, long duration_us, double fraction, bool relocatable) {
+    const int nskewed = static_cast<int>(fraction * ntasks);
+    std::atomic<int> nexecuted = 0;
+    ttg::Edge<int, int> tasks;
+    auto producer = ttg::make_tt<int>(
+        [ntasks](const int &, std::tuple<ttg::Out<int, int>> &out) {
+          for (int k = 0; k != ntasks; ++k) ttg::send<0>(k, k, out);
+        },
+        ttg::edges(), ttg::edges(tasks), "producer", {}, {"tasks"});
+    producer->set_keymap([](const int &) { return 0; });
+    auto consumer = ttg::make_tt(
+        [&nexecuted, duration_us](const int &, const int &, std::tuple<> &) {
+          spin(duration_us);
+          ++nexecuted;
+        },
+        ttg::edges(tasks), ttg::edges(), relocatable ? "relocatable consumer" : "consumer", {"tasks"}, {});
+    consumer->set_keymap([nskewed, world](const int &k) { return k < nskewed ? 0 : k % world.size(); });
+    consumer->set_relocatable(relocatable);
+
+    ttg::make_graph_executable(producer);
+    ttg::execute();
+    // the loads reported when the relocatable TT was made executable have arrived after the fence
+    ttg::fence();
+
+    ttg::execute();
+    const auto begin = std::chrono::high_resolution_clock::now();
+    if (world.rank() == 0) producer->invoke(0);
+    ttg::fence();
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    int nmax = nexecuted, ntotal = nexecuted;
+    world.allreduce(nmax, [](int a, int b) { return std::max(a, b); });
+    world.allreduce(ntotal, std::plus<>{});
+    return {std::chrono::duration<double>(end - begin).count(),
+            ntotal == 0 ? 1.0 : static_cast<double>(nmax) * world.size() / ntotal};
+  }
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ttg::initialize(argc, argv);
+  auto world = ttg::default_execution_context();
+
+  const int ntasks = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const long duration_us = argc > 2 ? std::atol(argv[2]) : 100;
+  const double fraction = argc > 3 ? std::atof(argv[3]) : 0.5;
+
+  const auto [time_static, imbalance_static] = run(world, ntasks, duration_us, fraction, false);
+  const auto [time_relocatable, imbalance_relocatable] = run(world, ntasks, duration_us, fraction, true);
+
+  if (world.rank() == 0)
+    std::cout << "relocatable-bench: nproc=" << world.size() << " ntasks=" << ntasks << " duration(us)=" << duration_us
+              << " fraction=" << fraction << " static: time(s)=" << time_static << " imbalance=" << imbalance_static
+              << " relocatable: time(s)=" << time_relocatable << " imbalance=" << imbalance_relocatable
+              << " speedup=" << time_static / time_relocatable << std::endl;
+
+  ttg::finalize();
+  return 0;
+}
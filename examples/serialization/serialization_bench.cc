@@ -0,0 +1,428 @@
+// Measures the pack/unpack throughput and latency of representative TTG payloads with every serialization method
+// available for each: the default data descriptor used by the PaRSEC backend (see ttg/serialization/data_descriptor.h)
+// as well as the MADNESS, Boost, Cereal, and TTG buffer archives directly. The split-metadata transfer is emulated by
+// copying the metadata and the iovecs into/out of a buffer. For the types that enable ttg::payload_compression the
+// compressed data descriptor is measured too; among these are the blocks exchanged by spmm (with BTAS) and the function
+// nodes exchanged by mrattg (with blaspp). The "message" method packs each payload into a message as the PaRSEC backend
+// sends it, i.e. with the descriptor selected for its type, which is the compressed one if enabled. The results are
+// written to stdout as JSON.
+//
+// usage: serialization-bench [minimum seconds per measurement=0.2]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "ttg/serialization.h"
+#include "ttg/serialization/data_descriptor.h"
+#include "ttg/serialization/std/array.h"
+#include "ttg/serialization/std/vector.h"
+#include "ttg/util/multiindex.h"
+
+#include "../blockmatrix.h"
+#include "../matrixtile.h"
+
+#ifdef TTG_HAS_BTAS
+#include <btas/serialization.h>
+#include <btas/tensor.h>
+#include <btas/util/mohndle.h>
+using tensor_t =
+    btas::Tensor<double, btas::DEFAULT::range, btas::mohndle<btas::varray<double>, btas::Handle::shared_ptr>>;
+namespace ttg::detail {
+  // BTAS defines all of its Boost serializers in boost::serialization namespace ... as explained in
+  // ttg/serialization/boost.h such functions are not detectable via SFINAE, so must explicitly define serialization
+  // traits here
+  template <typename Archive>
+  inline static constexpr bool is_boost_serializable_v<Archive, tensor_t> = is_boost_archive_v<Archive>;
+  template <typename Archive>
+  inline static constexpr bool is_boost_serializable_v<Archive, const tensor_t> = is_boost_archive_v<Archive>;
+}  // namespace ttg::detail
+
+template <>
+struct ttg::payload_compression<tensor_t> : ttg::enable_payload_compression<sizeof(double)> {};
+#endif
+
+#ifdef TTG_HAS_MRA
+#include "ttg/util/macro.h"
+
+#include "../mragl.h"
+#include "../mrakey.h"
+#include "../mratwoscale.h"
+#include "../mrafunctiondata.h"
+#include "../mrafunctionnode.h"
+
+/// the order of the multiwavelets used by mrattg
+constexpr std::size_t mra_k = 10;
+using rnode_t = mra::FunctionReconstructedNode<double, mra_k, 3>;
+using cnode_t = mra::FunctionCompressedNode<double, mra_k, 3>;
+
+template <>
+struct ttg::payload_compression<rnode_t> : ttg::enable_payload_compression<sizeof(double)> {};
+template <>
+struct ttg::payload_compression<cnode_t> : ttg::enable_payload_compression<sizeof(double)> {};
+#endif
+
+namespace {
+
+  /// a trivially-copyable struct (without padding, so that it can be compared bytewise)
+  struct POD {
+    std::int64_t id;
+    double values[7];
+  };
+
+  template <typename T>
+  bool equal(const T &a, const T &b) {
+    if constexpr (std::is_trivially_copyable_v<T>)
+      return std::memcmp(&a, &b, sizeof(T)) == 0;
+    else
+      return a == b;
+  }
+
+  template <typename T>
+  bool equal(const MatrixTile<T> &a, const MatrixTile<T> &b) {
+    return a.rows() == b.rows() && a.cols() == b.cols() && a.lda() == b.lda() &&
+           std::equal(a.data(), a.data() + a.size(), b.data());
+  }
+
+#ifdef TTG_HAS_MRA
+  /// the Gaussian projected by mrattg: exponent 3, centered at the origin, unit square norm
+  struct Gaussian {
+    const double expnt = 3.0;
+    const double fac = std::pow(2.0 * expnt / M_PI, 0.75);
+
+    template <std::size_t N>
+    void operator()(const mra::SimpleTensor<double, 3, N> &x, std::array<double, N> &values) const {
+      mra::distancesq(mra::Coordinate<double, 3>{0.0, 0.0, 0.0}, x, values);
+      for (double &value : values) value = fac * std::exp(-expnt * value);
+    }
+  };
+
+  /// @return the node at @p key , as sent by the projection of mrattg
+  rnode_t project(const mra::Key<3> &key) {
+    rnode_t node{};  // the neighbor fields are not set by the projection, they stay zero here
+    node.key = key;
+    node.is_leaf = mra::fcoeffs<Gaussian, double, mra_k>(Gaussian{}, key, 1e-6, node.coeffs);
+    return node;
+  }
+
+  /// @return the node at @p key , as sent by the compression of mrattg: the difference coefficients of the children
+  ///         of @p key
+  cnode_t compress(const mra::Key<3> &key) {
+    auto &child_slices = mra::FunctionData<double, mra_k, 3>::get_child_slices();
+    cnode_t node{};
+    node.key = key;
+    mra::FixedTensor<double, 2 * mra_k, 3> s;
+    mra::KeyChildren<3> children(key);
+    for (auto it = children.begin(); it != children.end(); ++it) {
+      const auto child = project(*it);
+      s(child_slices[it.index()]) = child.coeffs;
+      node.is_leaf[it.index()] = child.is_leaf;
+    }
+    mra::filter<double, mra_k, 3>(s, node.coeffs);
+    node.coeffs(child_slices[0]) = 0.0;
+    return node;
+  }
+#endif  // TTG_HAS_MRA
+
+  /// @return the name of the default_data_descriptor specialization that serializes @p T
+  template <typename T>
+  const char *descriptor_kind() {
+    if constexpr (ttg::has_split_metadata<T>::value)
+      return "split-metadata";
+    else if constexpr (ttg::detail::use_ttg_buffer_archive_v<T>)
+      return "ttg";
+    else if constexpr (std::is_trivially_copyable_v<T> && !ttg::detail::is_user_buffer_serializable_v<T>)
+      return "bitcopy";
+    else if constexpr (ttg::detail::is_madness_buffer_serializable_v<T>)
+      return "madness";
+    else if constexpr (ttg::detail::is_boost_buffer_serializable_v<T>)
+      return "boost";
+    else
+      return "cereal";
+  }
+
+  class Benchmark {
+   public:
+    explicit Benchmark(double min_seconds) : min_seconds_(min_seconds) {}
+
+    /// measures all methods that can serialize @p object
+    template <typename T>
+    void run(const std::string &payload, const T &object) {
+      measure_descriptor<ttg::default_data_descriptor<T>>(payload, std::string("descriptor:") + descriptor_kind<T>(),
+                                                          object);
+      if constexpr (ttg::payload_compression<T>::enabled)
+        measure_descriptor<ttg::detail::compressed_data_descriptor<T>>(payload, "descriptor:compressed", object);
+      measure_message(payload, object);
+
+      if constexpr (ttg::has_split_metadata<T>::value) {
+        // metadata followed by the payload of each iovec, as transferred by the PaRSEC backend
+        ttg::SplitMetadataDescriptor<T> descr;
+        T &obj = const_cast<T &>(object);
+        std::size_t size = sizeof(descr.get_metadata(obj));
+        for (auto &&iov : descr.get_data(obj)) size += iov.num_bytes;
+        measure(
+            payload, "split-metadata", object, size,
+            [](const T &obj, std::vector<unsigned char> &buf) {
+              ttg::SplitMetadataDescriptor<T> descr;
+              auto metadata = descr.get_metadata(obj);
+              std::memcpy(buf.data(), &metadata, sizeof(metadata));
+              std::size_t pos = sizeof(metadata);
+              for (auto &&iov : descr.get_data(const_cast<T &>(obj))) {
+                std::memcpy(buf.data() + pos, iov.data, iov.num_bytes);
+                pos += iov.num_bytes;
+              }
+            },
+            [](T &obj, const std::vector<unsigned char> &buf) {
+              ttg::SplitMetadataDescriptor<T> descr;
+              decltype(descr.get_metadata(obj)) metadata;
+              std::memcpy(static_cast<void *>(&metadata), buf.data(), sizeof(metadata));
+              obj = descr.create_from_metadata(metadata);
+              std::size_t pos = sizeof(metadata);
+              for (auto &&iov : descr.get_data(obj)) {
+                std::memcpy(iov.data, buf.data() + pos, iov.num_bytes);
+                pos += iov.num_bytes;
+              }
+            });
+      }
+
+#ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
+      if constexpr (ttg::detail::is_madness_buffer_serializable_v<T>) {
+        madness::archive::BufferOutputArchive ca;
+        ca &object;
+        measure(
+            payload, "madness", object, ca.size(),
+            [](const T &obj, std::vector<unsigned char> &buf) {
+              madness::archive::BufferOutputArchive oa(buf.data(), buf.size());
+              oa &obj;
+            },
+            [](T &obj, const std::vector<unsigned char> &buf) {
+              madness::archive::BufferInputArchive ia(buf.data(), buf.size());
+              ia &obj;
+            });
+      }
+#endif  // TTG_SERIALIZATION_SUPPORTS_MADNESS
+
+#ifdef TTG_SERIALIZATION_SUPPORTS_BOOST
+      if constexpr (ttg::detail::is_boost_buffer_serializable_v<T>) {
+        ttg::detail::boost_counting_oarchive ca;
+        ca << object;
+        measure(
+            payload, "boost", object, ca.streambuf().size(),
+            [](const T &obj, std::vector<unsigned char> &buf) {
+              auto oa = ttg::detail::make_boost_buffer_oarchive(buf.data(), buf.size());
+              oa << obj;
+            },
+            [](T &obj, const std::vector<unsigned char> &buf) {
+              auto ia = ttg::detail::make_boost_buffer_iarchive(buf.data(), buf.size());
+              ia >> obj;
+            });
+      }
+#endif  // TTG_SERIALIZATION_SUPPORTS_BOOST
+
+#ifdef TTG_SERIALIZATION_SUPPORTS_CEREAL
+      if constexpr (ttg::detail::is_cereal_buffer_serializable_v<T>) {
+        ttg::detail::cereal_buffer_oarchive ca;
+        ca << object;
+        measure(
+            payload, "cereal", object, ca.pos(),
+            [](const T &obj, std::vector<unsigned char> &buf) {
+              ttg::detail::cereal_buffer_oarchive oa(buf.data(), buf.size());
+              oa << obj;
+            },
+            [](T &obj, const std::vector<unsigned char> &buf) {
+              ttg::detail::cereal_buffer_iarchive ia(buf.data(), buf.size());
+              ia >> obj;
+            });
+      }
+#endif  // TTG_SERIALIZATION_SUPPORTS_CEREAL
+
+      if constexpr (ttg::detail::is_ttg_buffer_serializable_v<T>) {
+        // operator& rather than operator<< and operator>>: the latter lose to the stream-generic operator<< of the mra
+        // nodes
+        ttg::detail::buffer_counting_oarchive ca;
+        ca &object;
+        measure(
+            payload, "ttg", object, ca.size(),
+            [](const T &obj, std::vector<unsigned char> &buf) {
+              ttg::detail::buffer_oarchive oa(buf.data(), buf.size());
+              oa &obj;
+            },
+            [](T &obj, const std::vector<unsigned char> &buf) {
+              ttg::detail::buffer_iarchive ia(buf.data(), buf.size());
+              ia &obj;
+            });
+      }
+    }
+
+    /// writes the results as a JSON object
+    void report(std::ostream &os) const {
+      os << "{\n  \"benchmark\": \"serialization\",\n  \"backends\": [";
+      const char *separator = "";
+      for (const char *backend : {
+#ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
+               "madness",
+#endif
+#ifdef TTG_SERIALIZATION_SUPPORTS_BOOST
+               "boost",
+#endif
+#ifdef TTG_SERIALIZATION_SUPPORTS_CEREAL
+               "cereal",
+#endif
+               "ttg"}) {
+        os << separator << "\"" << backend << "\"";
+        separator = ", ";
+      }
+      os << "],\n  \"results\": [";
+      separator = "\n";
+      for (const auto &r : results_) {
+        os << separator << "    {\"payload\": \"" << r.payload << "\", \"method\": \"" << r.method
+           << "\", \"bytes\": " << r.bytes << ", \"pack_latency_us\": " << r.pack_seconds * 1e6
+           << ", \"unpack_latency_us\": " << r.unpack_seconds * 1e6
+           << ", \"pack_MBps\": " << r.bytes / (r.pack_seconds * 1e6)
+           << ", \"unpack_MBps\": " << r.bytes / (r.unpack_seconds * 1e6) << ", \"verified\": "
+           << (r.verified ? "true" : "false") << "}";
+        separator = ",\n";
+      }
+      os << "\n  ]\n}" << std::endl;
+    }
+
+   private:
+    struct Result {
+      std::string payload;
+      std::string method;
+      std::size_t bytes;
+      double pack_seconds;    // per operation
+      double unpack_seconds;  // per operation
+      bool verified;
+    };
+
+    /// @return the average duration of @p op , in seconds
+    template <typename Op>
+    double time(Op &&op) const {
+      op();  // warm up
+      std::size_t nrepeats = 1;
+      while (true) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t r = 0; r != nrepeats; ++r) op();
+        auto stop = std::chrono::high_resolution_clock::now();
+        const auto seconds = std::chrono::duration<double>(stop - start).count();
+        if (seconds >= min_seconds_) return seconds / nrepeats;
+        nrepeats *= 2;
+      }
+    }
+
+    /// measures the two-pass serialization by @p Descriptor : payload_size, then pack_payload
+    template <typename Descriptor, typename T>
+    void measure_descriptor(const std::string &payload, const std::string &method, const T &object) {
+      measure(
+          payload, method, object, Descriptor::payload_size(&object),
+          [](const T &obj, std::vector<unsigned char> &buf) {
+            Descriptor::pack_payload(&obj, Descriptor::payload_size(&obj), 0, buf.data());
+          },
+          [](T &obj, const std::vector<unsigned char> &buf) {
+            Descriptor::unpack_payload(&obj, buf.size(), 0, buf.data());
+          });
+    }
+
+    /// measures @p object packed into a message as by TT::pack of the PaRSEC backend: in a single pass, with the
+    /// descriptor selected for @p T , after its size unless that is constant
+    template <typename T>
+    void measure_message(const std::string &payload, const T &object) {
+      const ttg_data_descriptor *d = ttg::get_data_descriptor<T>();
+      const std::size_t header = ttg::detail::payload_size_is_const_v<T> ? 0 : sizeof(std::uint64_t);
+      measure(
+          payload, "message", object, header + d->payload_size(&object),
+          [d, header](const T &obj, std::vector<unsigned char> &buf) {
+            const std::uint64_t size = d->pack_payload_once(&obj, buf.size() - header, header, buf.data()) - header;
+            std::memcpy(buf.data(), &size, header);
+          },
+          [d, header](T &obj, const std::vector<unsigned char> &buf) {
+            std::uint64_t size = buf.size() - header;
+            std::memcpy(&size, buf.data(), header);
+            d->unpack_payload(&obj, size, header, buf.data());
+          });
+    }
+
+    template <typename T, typename Pack, typename Unpack>
+    void measure(const std::string &payload, const std::string &method, const T &object, std::size_t size,
+                 Pack &&pack, Unpack &&unpack) {
+      std::vector<unsigned char> buf(size);
+      T copy{};
+      const auto pack_seconds = time([&]() { pack(object, buf); });
+      const auto unpack_seconds = time([&]() {
+        T obj{};
+        unpack(obj, buf);
+        copy = std::move(obj);
+      });
+      results_.push_back(Result{payload, method, size, pack_seconds, unpack_seconds, equal(object, copy)});
+    }
+
+    double min_seconds_;
+    std::vector<Result> results_;
+  };
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const double min_seconds = argc > 1 ? std::atof(argv[1]) : 0.2;
+  if (min_seconds <= 0) {
+    std::cerr << "usage: " << argv[0] << " [minimum seconds per measurement=0.2]" << std::endl;
+    return 1;
+  }
+
+  Benchmark benchmark(min_seconds);
+
+  POD pod{17, {1., 2., 3., 4., 5., 6., 7.}};
+  benchmark.run("pod", pod);
+  benchmark.run("multiindex<3>", ttg::MultiIndex<3>(1, 2, 3));
+
+  for (std::size_t n : {16, 1024, 65536, 1048576}) {
+    benchmark.run("vector<double>[" + std::to_string(n) + "]", std::vector<double>(n, 1.));
+  }
+  benchmark.run("vector<vector<double>>[1024][128]",
+                std::vector<std::vector<double>>(1024, std::vector<double>(128, 1.)));
+
+  MatrixTile<double> tile(128, 128, 128);
+  tile.fill(1.);
+  benchmark.run("MatrixTile<double>[128x128]", tile);
+
+#if defined(TTG_SERIALIZATION_SUPPORTS_MADNESS) || defined(TTG_SERIALIZATION_SUPPORTS_BOOST)
+  BlockMatrix<double> block(128, 128);
+  block.fill();
+  benchmark.run("BlockMatrix<double>[128x128]", block);
+#endif
+
+#ifdef TTG_HAS_BTAS
+  tensor_t tensor(128, 128);
+  tensor.fill(1.);
+  benchmark.run("btas::Tensor<double>[128x128]", tensor);
+
+  // spmm fills each block of A and B with a single (random, or hard-coded) value, hence the blocks of C are constant
+  // too; the random problem uses 32 to 256 rows/columns per block, the hard-coded one the sizes below
+  benchmark.run("spmm:A[256x256]", tensor_t(btas::Range(256, 256), 0.37));
+  benchmark.run("spmm:A[128x256]", tensor_t(btas::Range(128, 256), 12.3));
+  benchmark.run("spmm:C[128x196]", tensor_t(btas::Range(128, 196), 12.3 * 12.3 * 256));
+#endif
+
+#ifdef TTG_HAS_MRA
+  // nodes of the function projected and compressed by mrattg, near the center of the Gaussian
+  mra::GLinitialize();
+  mra::FunctionData<double, mra_k, 3>::initialize();
+  mra::Domain<3>::set_cube(-6.0, 6.0);
+  benchmark.run("mrattg:FunctionReconstructedNode<double,10,3>", project(mra::Key<3>(4, {8, 8, 8})));
+  benchmark.run("mrattg:FunctionCompressedNode<double,10,3>", compress(mra::Key<3>(3, {4, 4, 4})));
+#endif
+
+  benchmark.report(std::cout);
+
+  return 0;
+}
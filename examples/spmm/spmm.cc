@@ -223,7 +223,8 @@ class SpMM {
        const std::vector<std::vector<long>> &a_colidx_to_rowidx,
        const std::vector<std::vector<long>> &b_rowidx_to_colidx,
        const std::vector<std::vector<long>> &b_colidx_to_rowidx, const std::vector<int> &mTiles,
-       const std::vector<int> &nTiles, const std::vector<int> &kTiles, const Keymap &keymap)
+       const std::vector<int> &nTiles, const std::vector<int> &kTiles, const Keymap &keymap,
+       bool tile_affinity = false, bool relocatable = false)
       : a_ijk_()
       , local_a_ijk_()
       , b_ijk_()
@@ -238,7 +239,7 @@ class SpMM {
     bcast_b_ = std::make_unique<BcastB>(b, local_b_ijk_, a_colidx_to_rowidx_, keymap);
     local_bcast_b_ = std::make_unique<LocalBcastB>(local_b_ijk_, b_ijk_, a_colidx_to_rowidx_, keymap);
     multiplyadd_ = std::make_unique<MultiplyAdd>(a_ijk_, b_ijk_, c_ijk_, c, a_rowidx_to_colidx_, b_colidx_to_rowidx_,
-                                                 mTiles, nTiles, keymap);
+                                                 mTiles, nTiles, keymap, tile_affinity, relocatable);
     TTGUNUSED(bcast_a_);
     TTGUNUSED(bcast_b_);
     TTGUNUSED(multiplyadd_);
@@ -396,7 +397,7 @@ class SpMM {
     MultiplyAdd(Edge<Key<3>, Blk> &a_ijk, Edge<Key<3>, Blk> &b_ijk, Edge<Key<3>, Blk> &c_ijk, Edge<Key<2>, Blk> &c,
                 const std::vector<std::vector<long>> &a_rowidx_to_colidx,
                 const std::vector<std::vector<long>> &b_colidx_to_rowidx, const std::vector<int> &mTiles,
-                const std::vector<int> &nTiles, Keymap keymap)
+                const std::vector<int> &nTiles, Keymap keymap, bool tile_affinity, bool relocatable)
         : baseT(edges(a_ijk, b_ijk, c_ijk), edges(c, c_ijk), "SpMM::MultiplyAdd", {"a_ijk", "b_ijk", "c_ijk"},
                 {"c_ij", "c_ijk"},
                 [keymap](const Key<3> &ijk) {
@@ -406,6 +407,11 @@ class SpMM {
         , a_rowidx_to_colidx_(a_rowidx_to_colidx)
         , b_colidx_to_rowidx_(b_colidx_to_rowidx) {
       this->set_priomap([=](const Key<3> &ijk) { return this->prio(ijk); });
+      // run the k-chain of updates of C[i][j] on the same thread to keep C[i][j] in its cache
+      if (tile_affinity)
+        this->set_affinitymap([](const Key<3> &ijk) { return static_cast<int>(Key<2>({ijk[0], ijk[1]}).hash()); });
+      // the inputs of the updates are self-contained, so overloaded ranks can delegate them to idle ranks
+      this->set_relocatable(relocatable);
 
       // for each i and j that belongs to this node
       // determine first k that contributes, initialize input {i,j,first_k} flow to 0
@@ -1114,7 +1120,8 @@ static void timed_measurement(SpMatrix<> &A, SpMatrix<> &B, const std::function<
                               const std::vector<std::vector<long>> &a_colidx_to_rowidx,
                               const std::vector<std::vector<long>> &b_rowidx_to_colidx,
                               const std::vector<std::vector<long>> &b_colidx_to_rowidx, std::vector<int> &mTiles,
-                              std::vector<int> &nTiles, std::vector<int> &kTiles, int M, int N, int K, int P, int Q) {
+                              std::vector<int> &nTiles, std::vector<int> &kTiles, int M, int N, int K, int P, int Q,
+                              bool tile_affinity, bool relocatable) {
   int MT = (int)A.rows();
   int NT = (int)B.cols();
   int KT = (int)A.cols();
@@ -1135,7 +1142,7 @@ static void timed_measurement(SpMatrix<> &A, SpMatrix<> &B, const std::function<
   assert(!has_value(c_status));
   //  SpMM a_times_b(world, eA, eB, eC, A, B);
   SpMM<> a_times_b(eA, eB, eC, A, B, a_rowidx_to_colidx, a_colidx_to_rowidx, b_rowidx_to_colidx, b_colidx_to_rowidx,
-                   mTiles, nTiles, kTiles, keymap);
+                   mTiles, nTiles, kTiles, keymap, tile_affinity, relocatable);
   TTGUNUSED(a);
   TTGUNUSED(b);
   TTGUNUSED(a_times_b);
@@ -1384,13 +1391,18 @@ int main(int argc, char **argv) {
     std::string nbrunStr(getCmdOption(argv, argv + argc, "-n"));
     int nb_runs = parseOption(nbrunStr, 1);
 
+    // -A: run the updates of each tile of C on the same thread (see TT::set_affinitymap)
+    const bool tile_affinity = cmdOptionExists(argv, argv + argc, "-A");
+    // -R: let overloaded ranks delegate ready updates to underloaded ranks (see TT::set_relocatable)
+    const bool relocatable = cmdOptionExists(argv, argv + argc, "-R");
+
     if (timing) {
       // Start up engine
       execute();
       for (int nrun = 0; nrun < nb_runs; nrun++) {
         timed_measurement(A, B, keymap, tiling_type, gflops, avg_nb, Adensity, Bdensity, a_rowidx_to_colidx,
                           a_colidx_to_rowidx, b_rowidx_to_colidx, b_colidx_to_rowidx, mTiles, nTiles, kTiles, M, N, K,
-                          P, Q);
+                          P, Q, tile_affinity, relocatable);
       }
     } else {
       // flow graph needs to exist on every node
@@ -1405,7 +1417,7 @@ int main(int argc, char **argv) {
       assert(!has_value(c_status));
       //  SpMM a_times_b(world, eA, eB, eC, A, B);
       SpMM<> a_times_b(eA, eB, eC, A, B, a_rowidx_to_colidx, a_colidx_to_rowidx, b_rowidx_to_colidx, b_colidx_to_rowidx,
-                       mTiles, nTiles, kTiles, keymap);
+                       mTiles, nTiles, kTiles, keymap, tile_affinity, relocatable);
       TTGUNUSED(a_times_b);
       // calling the Dot constructor with 'true' argument disables the type
       if (default_execution_context().rank() == 0) std::cout << Dot{/*disable_type=*/true}(&control) << std::endl;
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "ttg.h"
+#include "ttg/util/multiindex.h"
+
+#include <set>
+#include <vector>
+
+namespace {
+  // a minimal 2^NDIM-tree key, modeled after Key<NDIM> of the MRA examples
+  template <std::size_t NDIM>
+  struct TreeKey {
+    int n = 0;
+    std::array<std::uint64_t, NDIM> l{};
+
+    int level() const { return n; }
+    const auto &translation() const { return l; }
+    TreeKey parent() const {
+      TreeKey p{n - 1, l};
+      for (auto &x : p.l) x >>= 1;
+      return p;
+    }
+    std::size_t hash() const {
+      std::size_t h = n;
+      for (auto x : l) h = ttg::detail::hash_combine_impl::fn(h, x);
+      return h;
+    }
+  };
+}  // namespace
+
+TEST_CASE("Keymaps", "[keymaps]") {
+  SECTION("block-cyclic") {
+    ttg::block_cyclic_keymap_2d map2(2, 3);
+    CHECK(map2(ttg::MultiIndex<2>(0, 0)) == 0);
+    CHECK(map2(ttg::MultiIndex<2>(1, 2)) == 5);
+    CHECK(map2(ttg::MultiIndex<2>(2, 3)) == 0);
+    CHECK(map2(ttg::MultiIndex<2>(3, 4)) == 4);
+
+    ttg::block_cyclic_keymap_2d square(12);
+    CHECK(square.P() == 3);
+    CHECK(square.Q() == 4);
+
+    ttg::block_cyclic_keymap_3d map3(8, 2);
+    CHECK(map3.P() * map3.Q() == 4);
+    std::set<int> owners;
+    for (int k = 0; k != 2; ++k)
+      for (int i = 0; i != 2; ++i)
+        for (int j = 0; j != 2; ++j) owners.insert(map3(ttg::MultiIndex<3>(i, j, k)));
+    CHECK(owners.size() == 8);
+    CHECK_THROWS(ttg::block_cyclic_keymap_3d(8, 3));
+  }
+
+  SECTION("space-filling curves") {
+    // consecutive points along the Hilbert curve are neighbors
+    const int bits = 3;
+    std::vector<std::array<std::uint64_t, 2>> points(1 << (2 * bits));
+    for (std::uint64_t i = 0; i != (1 << bits); ++i)
+      for (std::uint64_t j = 0; j != (1 << bits); ++j) {
+        std::array<std::uint64_t, 2> x{i, j};
+        points[ttg::detail::hilbert_index(x, bits)] = x;
+      }
+    for (std::size_t p = 1; p != points.size(); ++p) {
+      auto dist = 0;
+      for (int d = 0; d != 2; ++d)
+        dist += std::abs(static_cast<long>(points[p][d]) - static_cast<long>(points[p - 1][d]));
+      CHECK(dist == 1);
+    }
+
+    // chunks are balanced for any extents
+    for (auto curve : {ttg::space_filling_curve::morton, ttg::space_filling_curve::hilbert}) {
+      const int nproc = 7;
+      ttg::sfc_keymap<2> map(nproc, {10, 13}, curve);
+      std::vector<int> count(nproc, 0);
+      for (int i = 0; i != 10; ++i)
+        for (int j = 0; j != 13; ++j) {
+          auto owner = map(ttg::MultiIndex<2>(i, j));
+          REQUIRE(owner >= 0);
+          REQUIRE(owner < nproc);
+          ++count[owner];
+        }
+      for (auto c : count) CHECK((c == 130 / nproc || c == 130 / nproc + 1));
+    }
+  }
+
+  SECTION("trees") {
+    const int nproc = 5;
+    ttg::tree_sfc_keymap<3> sfc(nproc);
+    ttg::level_keymap level(nproc);
+    TreeKey<3> root;
+    CHECK(sfc(root) == 0);
+    CHECK(level(root) == 0);
+    // the owners are nondecreasing along the curve
+    const int n = 4;
+    std::vector<int> owners(1 << (3 * n));
+    for (std::uint64_t x = 0; x != (1 << n); ++x)
+      for (std::uint64_t y = 0; y != (1 << n); ++y)
+        for (std::uint64_t z = 0; z != (1 << n); ++z) {
+          TreeKey<3> key{n, {x, y, z}};
+          owners[ttg::detail::hilbert_index(key.l, n)] = sfc(key);
+          // children at even levels past min_level are owned by their parent
+          CHECK(level(key) == level(key.parent()));
+        }
+    CHECK(std::is_sorted(owners.begin(), owners.end()));
+    CHECK(owners.front() == 0);
+    CHECK(owners.back() == nproc - 1);
+  }
+}
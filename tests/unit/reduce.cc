@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+
+#include "ttg.h"
+
+#include "ttg/serialization/std/vector.h"
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("SpanningTree", "[tree][core]") {
+  for (auto shape : {ttg::TreeShape::binary, ttg::TreeShape::kary, ttg::TreeShape::binomial}) {
+    for (int arity : {1, 3}) {
+      for (int size = 1; size != 20; ++size) {
+        for (int root = 0; root != size; ++root) {
+          ttg::SpanningTree tree(size, root, shape, arity);
+          int nchildren = 0;
+          for (int key = 0; key != size; ++key) {
+            const auto children = tree.child_keys(key);
+            CHECK(int(children.size()) == tree.num_children(key));
+            for (auto child : children) CHECK(tree.parent_key(child) == key);
+            CHECK((tree.parent_key(key) == -1) == (key == root));
+            nchildren += children.size();
+          }
+          CHECK(nchildren == size - 1);
+
+          if (shape == ttg::TreeShape::binary) {
+            ttg::BinarySpanningTree binary_tree(size, root);
+            for (int key = 0; key != size; ++key) {
+              CHECK(tree.parent_key(key) == binary_tree.parent_key(key));
+              const auto [left, right] = binary_tree.child_keys(key);
+              std::vector<int> children;
+              if (left != -1) children.push_back(left);
+              if (right != -1) children.push_back(right);
+              CHECK(tree.child_keys(key) == children);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("TreeReduce", "[reduce][core]") {
+  auto world = ttg::default_execution_context();
+  const int nranks = world.size();
+  const int root = nranks - 1;
+
+  const auto shapes = {ttg::TreeShape::binary, ttg::TreeShape::kary, ttg::TreeShape::binomial};
+
+  SECTION("whole values") {
+    for (auto shape : shapes) {
+      ttg::Edge<int, int> G2R, R2C;
+      auto generator = ttg::make_tt<int>(
+          [](const int &key, std::tuple<ttg::Out<int, int>> &out) { ttg::send<0>(key, key + 1, out); }, ttg::edges(),
+          ttg::edges(G2R), "generator");
+      ttg::TreeReduce<int, std::plus<int>, int> reduction(G2R, R2C, shape, 3, root);
+      long result = 0;
+      auto consumer = ttg::make_tt([&result](const int &key, const int &value, std::tuple<> &out) { result = value; },
+                                   ttg::edges(R2C), ttg::edges(), "consumer");
+      generator->make_executable();
+      reduction.make_executable();
+      consumer->make_executable();
+      ttg::ttg_fence(world);
+      generator->invoke(world.rank());
+      ttg::ttg_fence(world);
+      world.allreduce(result, std::plus<>{});
+      CHECK(result == nranks * (nranks + 1) / 2);
+    }
+  }
+
+  SECTION("segmented values") {
+    for (auto shape : shapes) {
+      using Value = std::vector<int>;
+      const int nsegments = 3;
+      const std::size_t size = 10;
+      ttg::Edge<int, Value> G2R, R2C;
+      auto generator = ttg::make_tt<int>(
+          [size](const int &key, std::tuple<ttg::Out<int, Value>> &out) {
+            ttg::send<0>(key, Value(size, key + 1), out);
+          },
+          ttg::edges(), ttg::edges(G2R), "generator");
+      auto op = [](const Value &a, const Value &b) {
+        Value c(a);
+        for (std::size_t i = 0; i != c.size(); ++i) c[i] += b[i];
+        return c;
+      };
+      auto reduction = ttg::make_segmented_tree_reduce(G2R, R2C, nsegments, shape, 3, root, 0, op);
+      std::vector<long> result(size, 0);
+      auto consumer = ttg::make_tt(
+          [&result](const int &key, const Value &value, std::tuple<> &out) {
+            result.assign(value.begin(), value.end());
+          },
+          ttg::edges(R2C), ttg::edges(), "consumer");
+      generator->make_executable();
+      reduction->make_executable();
+      consumer->make_executable();
+      ttg::ttg_fence(world);
+      generator->invoke(world.rank());
+      ttg::ttg_fence(world);
+      world.allreduce(result.data(), result.size(), std::plus<>{});
+      CHECK(result == std::vector<long>(size, nranks * (nranks + 1) / 2));
+    }
+  }
+}
+
+TEST_CASE("Reduce", "[reduce][core]") {
+  auto world = ttg::default_execution_context();
+  const int nranks = world.size();
+  const int root = nranks - 1;
+  const int nitems = 10;  // per process
+
+  // each process sends values 1..nitems keyed by rank*nitems+i to the local instance of reduction
+  auto make_generator = [nitems](ttg::Edge<int, int> &G2R) {
+    return ttg::make_tt<int>(
+        [nitems](const int &rank, std::tuple<ttg::Out<int, int>> &out) {
+          for (int i = 0; i != nitems; ++i) ttg::send<0>(rank * nitems + i, i + 1, out);
+        },
+        ttg::edges(), ttg::edges(G2R), "generator");
+  };
+
+  SECTION("expected number of values") {
+    ttg::Edge<int, int> G2R, R2C;
+    auto generator = make_generator(G2R);
+    ttg::Reduce<int, int, std::plus<int>, int> reduction(G2R, R2C, nitems, 0, {}, 0, ttg::TreeShape::binomial, 2,
+                                                         root);
+    reduction.set_keymap([nitems](const int &key) { return key / nitems; });
+    long result = 0;
+    auto consumer = ttg::make_tt([&result](const int &key, const int &value, std::tuple<> &out) { result = value; },
+                                 ttg::edges(R2C), ttg::edges(), "consumer");
+    // the reduction is connected to the generator and to the consumer by edges, hence traversed with them
+    ttg::make_graph_executable(generator.get());
+    ttg::ttg_fence(world);
+    generator->invoke(world.rank());
+    ttg::ttg_fence(world);
+    world.allreduce(result, std::plus<>{});
+    CHECK(result == nranks * nitems * (nitems + 1) / 2);
+  }
+
+  SECTION("explicit finalize") {
+    ttg::Edge<int, int> G2R, R2C;
+    auto generator = make_generator(G2R);
+    ttg::Reduce<int, int, std::plus<int>, int> reduction(G2R, R2C, 0, 0, {}, 0, ttg::TreeShape::kary, 3, root);
+    long result = 0;
+    auto consumer = ttg::make_tt([&result](const int &key, const int &value, std::tuple<> &out) { result = value; },
+                                 ttg::edges(R2C), ttg::edges(), "consumer");
+    // the reduction is connected to the generator and to the consumer by edges, hence traversed with them
+    ttg::make_graph_executable(generator.get());
+    ttg::ttg_fence(world);
+    // values may be reduced by any process
+    if (world.rank() == 0)
+      for (int rank = 0; rank != nranks; ++rank) generator->invoke(rank);
+    ttg::ttg_fence(world);
+    reduction.finalize();
+    ttg::ttg_fence(world);
+    CHECK_THROWS_AS(reduction.finalize(), std::logic_error);
+    world.allreduce(result, std::plus<>{});
+    CHECK(result == nranks * nitems * (nitems + 1) / 2);
+  }
+
+  SECTION("values on some processes") {
+    // process 0 processes all values, the others process none and contribute when they call finalize()
+    ttg::Edge<int, int> G2R, R2C;
+    auto generator = make_generator(G2R);
+    ttg::Reduce<int, int, std::plus<int>, int> reduction(G2R, R2C, world.rank() == 0 ? nranks * nitems : 0, 0, {}, 0,
+                                                         ttg::TreeShape::binomial, 2, root);
+    reduction.set_keymap([](const int &key) { return 0; });
+    long result = 0;
+    auto consumer = ttg::make_tt([&result](const int &key, const int &value, std::tuple<> &out) { result = value; },
+                                 ttg::edges(R2C), ttg::edges(), "consumer");
+    // the reduction is connected to the generator and to the consumer by edges, hence traversed with them
+    ttg::make_graph_executable(generator.get());
+    ttg::ttg_fence(world);
+    generator->invoke(world.rank());
+    ttg::ttg_fence(world);
+    if (world.rank() == 0)
+      CHECK_THROWS_AS(reduction.finalize(), std::logic_error);
+    else
+      reduction.finalize();
+    ttg::ttg_fence(world);
+    world.allreduce(result, std::plus<>{});
+    CHECK(result == nranks * nitems * (nitems + 1) / 2);
+  }
+}
@@ -448,6 +448,16 @@ namespace freestanding::symmetric::bc_v {
 
 }  // namespace freestanding::symmetric::bc_v
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <string>
 #include <vector>
 
 #include "ttg/serialization/data_descriptor.h"
@@ -814,6 +824,41 @@ TEST_CASE("Cereal Serialization", "[serialization]") {
 
   test(intrusive::symmetric::bc_v::NonPOD{17});
   test(freestanding::symmetric::bc_v::NonPOD{18});
+
+  SECTION("buffer archives") {
+    const std::vector<double> v{1., 2., 3., 4., 5.};
+    ttg::detail::cereal_buffer_oarchive ca;
+    ca << v;
+    CHECK(ca.pos() == sizeof(std::uint64_t) + v.size() * sizeof(double));
+    std::vector<unsigned char> buf(ca.pos() + 1);
+    ttg::detail::cereal_buffer_oarchive oa(buf.data(), buf.size(), 1);
+    oa << v;
+    CHECK(oa.pos() == buf.size());
+    std::vector<double> v_copy;
+    ttg::detail::cereal_buffer_iarchive ia(buf.data(), buf.size(), 1);
+    ia >> v_copy;
+    CHECK(v_copy == v);
+    CHECK(ia.pos() == buf.size());
+    ttg::detail::cereal_buffer_oarchive small(buf.data(), buf.size() - 1, 1);
+    CHECK_THROWS_AS(small << v, cereal::Exception);
+  }
+
+  SECTION("data descriptor") {
+    auto test = [](const auto& t) {
+      using T = std::remove_const_t<std::remove_reference_t<decltype(t)>>;
+      const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+      const auto size = d->payload_size(&t);
+      std::vector<unsigned char> buf(size);
+      CHECK(d->pack_payload(&t, size, 0, buf.data()) == size);
+      T t_copy;
+      d->unpack_payload(&t_copy, size, 0, buf.data());
+      CHECK(t_copy.get() == t.get());
+      CHECK(d->pack_payload_once(&t, size, 0, buf.data()) == size);
+      CHECK(d->pack_payload_once(&t, size - 1, 0, buf.data()) == ttg::detail::pack_payload_overflow);
+    };
+    test(intrusive::symmetric::c::NonPOD{22});
+    test(intrusive::symmetric::c_v::NonPOD{23});
+  }
 }
 #endif  // TTG_SERIALIZATION_SUPPORTS_CEREAL
 
@@ -919,3 +964,510 @@ TEST_CASE("TTG Serialization", "[serialization]") {
 }
 
 #endif
+
+// serializable by the TTG buffer archives only
+namespace intrusive::symmetric::t {
+
+  class NonPOD {
+    int value;
+    std::vector<double> values;
+
+   public:
+    NonPOD() = default;
+    NonPOD(int value) : value(value), values(value, value) {}
+    NonPOD(const NonPOD& other) = default;
+
+    int get() const { return value; }
+
+    template <typename Archive>
+    std::enable_if_t<ttg::detail::is_ttg_buffer_archive_v<Archive>> serialize(Archive& ar) {
+      ar& value& values;
+    }
+
+    bool operator==(const NonPOD& other) const { return value == other.value && values == other.values; }
+  };
+  static_assert(!std::is_trivially_copyable_v<NonPOD>);
+
+  static_assert(ttg::detail::is_ttg_user_buffer_serializable_v<NonPOD>);
+  static_assert(ttg::detail::is_ttg_buffer_serializable_v<std::vector<NonPOD>>);
+  static_assert(ttg::detail::is_user_buffer_serializable_v<NonPOD>);
+  static_assert(!ttg::detail::is_madness_user_buffer_serializable_v<NonPOD>);
+  static_assert(!ttg::detail::is_boost_user_buffer_serializable_v<NonPOD>);
+  static_assert(!ttg::detail::is_cereal_user_buffer_serializable_v<NonPOD>);
+  static_assert(ttg::detail::use_ttg_buffer_archive_v<NonPOD>);
+
+  // serialized size is the same for all objects
+  class Fixed {
+    std::array<int, 3> values;
+
+   public:
+    static inline int nserialize = 0;
+
+    Fixed() = default;
+    Fixed(int value) : values{value, value, value} {}
+
+    template <typename Archive>
+    std::enable_if_t<ttg::detail::is_ttg_buffer_archive_v<Archive>> serialize(Archive& ar) {
+      ++nserialize;
+      ar& values;
+    }
+
+    bool operator==(const Fixed& other) const { return values == other.values; }
+  };
+
+}  // namespace intrusive::symmetric::t
+
+template <>
+struct ttg::has_fixed_serialized_size<intrusive::symmetric::t::Fixed> : std::true_type {};
+static_assert(ttg::default_data_descriptor<intrusive::symmetric::t::Fixed>::serialize_size_is_const);
+static_assert(!ttg::default_data_descriptor<intrusive::symmetric::t::NonPOD>::serialize_size_is_const);
+
+static_assert(ttg::detail::is_output_archive_v<ttg::detail::buffer_oarchive>);
+static_assert(ttg::detail::is_output_archive_v<ttg::detail::buffer_counting_oarchive>);
+static_assert(ttg::detail::is_input_archive_v<ttg::detail::buffer_iarchive>);
+static_assert(ttg::detail::is_ttg_buffer_serializable_v<std::tuple<int, std::string, std::array<POD, 3>>>);
+static_assert(!ttg::detail::is_ttg_buffer_serializable_v<NonPOD>);
+static_assert(!ttg::detail::use_ttg_buffer_archive_v<int>);
+static_assert(!ttg::detail::use_ttg_buffer_archive_v<POD>);
+#if defined(TTG_SERIALIZATION_SUPPORTS_MADNESS) && !defined(TTG_SERIALIZATION_PREFER_TTG_ARCHIVE)
+static_assert(!ttg::detail::use_ttg_buffer_archive_v<std::vector<int>>);
+static_assert(!ttg::detail::use_ttg_buffer_archive_v<intrusive::symmetric::mc::POD>);
+#endif
+
+TEST_CASE("TTG Buffer Archive", "[serialization]") {
+  auto test = [](const auto& t) {
+    using T = ttg::meta::remove_cvr_t<decltype(t)>;
+    CHECK(ttg::detail::is_ttg_buffer_serializable_v<T>);
+
+    ttg::detail::buffer_counting_oarchive ca;
+    ca << t;
+    const auto size = ca.size();
+    std::vector<char> buf(size + 1);
+    ttg::detail::buffer_oarchive oa(buf.data(), buf.size(), 1);
+    oa << t;
+    CHECK(oa.position() == size + 1);
+
+    T t_copy;
+    ttg::detail::buffer_iarchive ia(buf.data(), buf.size(), 1);
+    ia >> t_copy;
+    CHECK(ia.position() == size + 1);
+    if constexpr (!std::is_array_v<T>) {
+      CHECK(t == t_copy);
+    } else {
+      for (std::size_t i = 0; i != std::extent_v<T>; ++i) CHECK(t[i] == t_copy[i]);
+    }
+    return size;
+  };
+
+  CHECK(test(99) == sizeof(int));
+  CHECK(test(POD(33)) == sizeof(POD));
+  test(std::array<POD, 3>{{POD(55), POD(66), POD(77)}});
+  int a[4] = {1, 2, 3, 4};
+  CHECK(test(a) == sizeof(a));
+  // sizes are varints
+  CHECK(test(std::vector<int>{1, 2, 3}) == 1 + 3 * sizeof(int));
+  CHECK(test(std::string(200, 'x')) == 2 + 200);
+  test(std::vector<std::vector<int>>{{1, 2, 3}, {4, 5}, {6, 7, 8, 9}});
+  test(std::vector<bool>{true, false, true});
+  test(std::list<std::string>{"a", "bc"});
+  test(std::make_pair(1, std::string("one")));
+  test(std::make_tuple(1, std::vector<double>{2., 3.}, std::array<POD, 2>{{POD(4), POD(5)}}));
+  test(intrusive::symmetric::t::NonPOD{17});
+  test(std::vector<intrusive::symmetric::t::NonPOD>{1, 2, 3});
+
+  // user-provided serialization takes precedence over bitcopy
+  {
+    intrusive::symmetric::mc::POD pod(17);
+    ttg::detail::buffer_counting_oarchive ca;
+    ca << pod;
+    CHECK(ca.size() == sizeof(int) + sizeof(std::int64_t));
+  }
+
+  // overflow and truncated input are detected
+  {
+    std::vector<int> v(10, 1);
+    char buf[16];
+    ttg::detail::buffer_oarchive oa(buf, sizeof(buf));
+    CHECK_THROWS_AS(oa << v, std::out_of_range);
+    ttg::detail::buffer_iarchive ia(buf, 4);
+    CHECK_THROWS_AS(ia >> v, std::out_of_range);
+  }
+
+  // via data descriptor
+  {
+    using T = intrusive::symmetric::t::NonPOD;
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+    T t(5);
+    const auto size = d->payload_size(&t);
+    auto buf = std::make_unique<char[]>(size);
+    CHECK(d->pack_payload(&t, size, 0, buf.get()) == size);
+    T t_copy;
+    d->unpack_payload(&t_copy, size, 0, buf.get());
+    CHECK(t == t_copy);
+  }
+
+  // compare the throughput of the TTG, MADNESS, and Boost buffer archives for a non-bit-copyable object
+  SECTION("throughput") {
+    const std::vector<std::vector<double>> obj(1024, std::vector<double>(128, 1.));
+    const int nrepeats = 16;
+    // N.B. the throughput is reported for the payload size of the TTG archive
+    std::size_t size;
+    {
+      ttg::detail::buffer_counting_oarchive ca;
+      ca << obj;
+      size = ca.size();
+    }
+    // leave room for the metadata of the other archives
+    std::vector<char> buf(2 * size);
+    std::vector<std::vector<double>> obj_copy;
+    auto timeit = [&](const char* archive, auto&& fn) {
+      fn();  // warm up
+      obj_copy.clear();
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int r = 0; r != nrepeats; ++r) fn();
+      auto stop = std::chrono::high_resolution_clock::now();
+      const auto seconds = std::chrono::duration<double>(stop - start).count();
+      std::cout << archive << " archive: " << nrepeats * size / (seconds * 1e6) << " MB/s" << std::endl;
+      CHECK(obj_copy == obj);
+    };
+
+    timeit("TTG", [&]() {
+      ttg::detail::buffer_oarchive oa(buf.data(), buf.size());
+      oa << obj;
+      std::vector<std::vector<double>> copy;
+      ttg::detail::buffer_iarchive ia(buf.data(), buf.size());
+      ia >> copy;
+      obj_copy = std::move(copy);
+    });
+#ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
+    timeit("MADNESS", [&]() {
+      madness::archive::BufferOutputArchive oa(buf.data(), buf.size());
+      oa& obj;
+      std::vector<std::vector<double>> copy;
+      madness::archive::BufferInputArchive ia(buf.data(), buf.size());
+      ia& copy;
+      obj_copy = std::move(copy);
+    });
+#endif  // TTG_SERIALIZATION_SUPPORTS_MADNESS
+#ifdef TTG_SERIALIZATION_SUPPORTS_BOOST
+    timeit("Boost", [&]() {
+      auto oa = ttg::detail::make_boost_buffer_oarchive(buf.data(), buf.size());
+      oa << obj;
+      std::vector<std::vector<double>> copy;
+      auto ia = ttg::detail::make_boost_buffer_iarchive(buf.data(), buf.size());
+      ia >> copy;
+      obj_copy = std::move(copy);
+    });
+#endif  // TTG_SERIALIZATION_SUPPORTS_BOOST
+  }
+}
+
+TEST_CASE("Single-pass Serialization", "[serialization]") {
+  auto test = [](const auto& t) {
+    using T = ttg::meta::remove_cvr_t<decltype(t)>;
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+    const auto size = d->payload_size(&t);
+    std::vector<unsigned char> buf(size + 1);
+
+    // too small buffers are detected
+    CHECK(d->pack_payload_once(&t, size - 1, 1, buf.data()) == ttg::detail::pack_payload_overflow);
+    CHECK(d->pack_payload_once(&t, size, 1, buf.data()) == size + 1);
+    T t_copy;
+    d->unpack_payload(&t_copy, size, 1, buf.data());
+    CHECK(t == t_copy);
+
+    // growable buffers are serialized into once
+    std::vector<unsigned char> growable(3);
+    CHECK(ttg::detail::pack_payload_growable(t, growable) == size);
+    CHECK(growable.size() == size + 3);
+    CHECK(std::equal(buf.begin() + 1, buf.end(), growable.begin() + 3));
+  };
+
+  test(99);
+  test(std::vector<std::vector<long>>{{1, 2, 3}, {4, 5}, std::vector<long>(100, 6)});
+  test(intrusive::symmetric::t::NonPOD{17});
+  test(intrusive::symmetric::t::NonPOD{100});
+#ifdef TTG_SERIALIZATION_SUPPORTS_BOOST
+  test(intrusive::symmetric::bc_v::NonPOD{18});
+#endif
+
+  // the size of objects with fixed serialized size is computed once
+  {
+    using T = intrusive::symmetric::t::Fixed;
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+    T a(1), b(2);
+    const auto size = d->payload_size(&a);
+    const auto nserialize = T::nserialize;
+    CHECK(d->payload_size(&b) == size);
+    CHECK(T::nserialize == nserialize);
+    test(b);
+  }
+}
+
+TEST_CASE("Batched Serialization", "[serialization]") {
+  // packs the objects of contiguous container @p objects that are @p stride bytes apart, and unpacks them into a copy
+  auto test = [](const auto& objects, std::size_t stride = 0) {
+    using T = ttg::meta::remove_cvr_t<decltype(objects[0])>;
+    if (stride == 0) stride = sizeof(T);
+    const std::size_t n = std::size(objects) * sizeof(objects[0]) / stride;
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+    CHECK(d->payload_size_is_const == ttg::detail::payload_size_is_const_v<T>);
+
+    // same representation as packing the objects one by one, preceded by their sizes unless these are constant
+    std::vector<unsigned char> expected(1);
+    for (std::size_t k = 0; k != n; ++k) {
+      const T& object = *reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(&objects[0]) + k * stride);
+      const uint64_t size = d->payload_size(&object);
+      if (!d->payload_size_is_const)
+        expected.insert(expected.end(), reinterpret_cast<const unsigned char*>(&size),
+                        reinterpret_cast<const unsigned char*>(&size) + sizeof(size));
+      expected.resize(expected.size() + size);
+      d->pack_payload(&object, size, expected.size() - size, expected.data());
+    }
+    const uint64_t size = expected.size() - 1;
+
+    std::vector<unsigned char> buf(size + 1);
+    CHECK(d->pack_n(&objects[0], n, stride, size - 1, 1, buf.data()) == ttg::detail::pack_payload_overflow);
+    CHECK(d->pack_n(&objects[0], n, stride, size, 1, buf.data()) == size + 1);
+    CHECK(std::equal(buf.begin() + 1, buf.end(), expected.begin() + 1));
+
+    auto copy = objects;
+    std::fill(std::begin(copy), std::end(copy), std::decay_t<decltype(copy[0])>{});
+    CHECK_THROWS_AS(d->unpack_n(&copy[0], n, stride, size - 1, 1, buf.data()), std::out_of_range);
+    CHECK(d->unpack_n(&copy[0], n, stride, size, 1, buf.data()) == size + 1);
+    CHECK(std::equal(std::begin(copy), std::end(copy), std::begin(objects)));
+  };
+
+  static_assert(ttg::detail::is_bitcopy_serialized_v<int>);
+  test(std::array<int, 5>{1, 2, 3, 4, 5});
+  // every other int
+  test(std::array<int, 6>{1, 0, 3, 0, 5, 0}, 2 * sizeof(int));
+  static_assert(!ttg::detail::is_bitcopy_serialized_v<std::vector<long>>);
+  test(std::vector<std::vector<long>>{{1, 2, 3}, {}, std::vector<long>(100, 6)});
+  test(std::vector<intrusive::symmetric::t::NonPOD>{1, 2, 3});
+  static_assert(ttg::detail::payload_size_is_const_v<intrusive::symmetric::t::Fixed>);
+  test(std::vector<intrusive::symmetric::t::Fixed>{1, 2, 3});
+}
+
+static_assert(ttg::has_split_metadata<std::vector<double>>::value);
+static_assert(ttg::has_split_metadata<std::vector<std::array<int, 3>>>::value);
+static_assert(ttg::has_split_metadata<std::array<double, 100>>::value);
+static_assert(!ttg::has_split_metadata<std::array<double, 3>>::value);  // small arrays are copied into the message
+static_assert(!ttg::has_split_metadata<std::vector<bool>>::value);
+static_assert(!ttg::has_split_metadata<std::vector<std::vector<double>>>::value);
+static_assert(!ttg::has_split_metadata<std::vector<intrusive::symmetric::t::NonPOD>>::value);
+static_assert(!ttg::has_split_metadata<std::vector<intrusive::symmetric::mc::POD>>::value);
+
+TEST_CASE("Split Metadata of Standard Containers", "[serialization]") {
+  // transfers the object like the PaRSEC backend: metadata first, then the payload of each iovec
+  auto test = [](const auto& t) {
+    using T = ttg::meta::remove_cvr_t<decltype(t)>;
+    ttg::SplitMetadataDescriptor<T> descr;
+    T t_source = t;
+    const auto metadata = descr.get_metadata(t_source);
+    T t_copy = descr.create_from_metadata(metadata);
+    auto src_iovecs = descr.get_data(t_source);
+    auto dst_iovecs = descr.get_data(t_copy);
+    const auto num_iovecs = std::distance(std::begin(src_iovecs), std::end(src_iovecs));
+    CHECK(num_iovecs == std::distance(std::begin(dst_iovecs), std::end(dst_iovecs)));
+    auto dst = std::begin(dst_iovecs);
+    for (auto&& src : src_iovecs) {
+      REQUIRE(src.num_bytes == dst->num_bytes);
+      std::memcpy(dst->data, src.data, src.num_bytes);
+      ++dst;
+    }
+    CHECK(t == t_copy);
+
+    // via data descriptor
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<T>();
+    const auto size = d->payload_size(&t);
+    CHECK(size == sizeof(metadata) + (num_iovecs == 0 ? 0 : t.size() * sizeof(typename T::value_type)));
+    std::vector<unsigned char> buf(size + 1);
+    CHECK(d->pack_payload(&t, size, 1, buf.data()) == size + 1);
+    T t_unpacked;
+    d->unpack_payload(&t_unpacked, size, 1, buf.data());
+    CHECK(t == t_unpacked);
+    return num_iovecs;
+  };
+
+  // small vectors are carried by the metadata
+  CHECK(test(std::vector<double>{}) == 0);
+  CHECK(test(std::vector<double>{1., 2., 3.}) == 0);
+  CHECK(test(std::vector<std::array<int, 3>>{{1, 2, 3}, {4, 5, 6}}) == 0);
+  // large ones by a single iovec
+  CHECK(test(std::vector<double>(1000, 2.)) == 1);
+  std::array<long, 100> a;
+  std::iota(a.begin(), a.end(), 0);
+  CHECK(test(a) == 1);
+}
+
+#ifdef TTG_SERIALIZATION_SUPPORTS_BOOST
+namespace intrusive::symmetric::bc_v {
+
+  // the large arrays are transferred separately in gather mode
+  struct Gatherable {
+    int id = 0;
+    std::vector<double> small;
+    std::vector<double> large;
+    std::vector<double> larger;
+
+    template <typename Archive>
+    void serialize(Archive& ar, const unsigned int version) {
+      ar& id& small& large& larger;
+    }
+
+    bool operator==(const Gatherable& other) const {
+      return id == other.id && small == other.small && large == other.large && larger == other.larger;
+    }
+  };
+
+}  // namespace intrusive::symmetric::bc_v
+
+template <>
+struct ttg::use_gather_serialization<intrusive::symmetric::bc_v::Gatherable> : std::true_type {};
+static_assert(ttg::detail::use_gather_serialization_v<intrusive::symmetric::bc_v::Gatherable>);
+static_assert(!ttg::detail::use_gather_serialization_v<intrusive::symmetric::bc_v::NonPOD>);
+
+TEST_CASE("Gather Serialization", "[serialization]") {
+  using T = intrusive::symmetric::bc_v::Gatherable;
+  const T obj{7, {1., 2., 3.}, std::vector<double>(1000, 2.), std::vector<double>(2000, 3.)};
+
+  std::vector<unsigned char> header(1024);
+  std::vector<ttg::iovec> iovecs;
+  const auto header_size = ttg::detail::gather_payload(obj, header.size(), header.data(), iovecs);
+  REQUIRE(header_size != ttg::detail::pack_payload_overflow);
+  CHECK(header_size < ttg::detail::gather_min_iovec_size);
+  // only the large arrays are transferred separately, directly from the object
+  REQUIRE(iovecs.size() == 2);
+  CHECK(iovecs[0].data == obj.large.data());
+  CHECK(iovecs[0].num_bytes == obj.large.size() * sizeof(double));
+  CHECK(iovecs[1].data == obj.larger.data());
+
+  T copy;
+  const auto dst_iovecs = ttg::detail::scatter_payload(copy, header_size, header.data());
+  CHECK(copy.id == obj.id);
+  CHECK(copy.small == obj.small);
+  REQUIRE(dst_iovecs.size() == 2);
+  CHECK(dst_iovecs[0].data == copy.large.data());
+  CHECK(dst_iovecs[1].data == copy.larger.data());
+  // transfer the payload like the PaRSEC backend
+  for (std::size_t i = 0; i != iovecs.size(); ++i) {
+    REQUIRE(dst_iovecs[i].num_bytes == iovecs[i].num_bytes);
+    std::memcpy(dst_iovecs[i].data, iovecs[i].data, iovecs[i].num_bytes);
+  }
+  CHECK(copy == obj);
+
+  // the header must fit into the buffer
+  CHECK(ttg::detail::gather_payload(obj, 16, header.data(), iovecs) == ttg::detail::pack_payload_overflow);
+}
+#endif  // TTG_SERIALIZATION_SUPPORTS_BOOST
+
+namespace intrusive::symmetric::t {
+
+  // a dense matrix block, serialized with its shape
+  struct Tile {
+    int rows = 0;
+    int cols = 0;
+    std::vector<double> data;
+
+    Tile() = default;
+    Tile(int rows, int cols) : rows(rows), cols(cols), data(rows * cols, 0.) {}
+
+    template <typename Archive>
+    std::enable_if_t<ttg::detail::is_ttg_buffer_archive_v<Archive>> serialize(Archive& ar) {
+      ar& rows& cols& data;
+    }
+
+    bool operator==(const Tile& other) const {
+      return rows == other.rows && cols == other.cols && data == other.data;
+    }
+  };
+
+}  // namespace intrusive::symmetric::t
+
+template <>
+struct ttg::payload_compression<intrusive::symmetric::t::Tile> : ttg::enable_payload_compression<sizeof(double)> {};
+static_assert(std::is_same_v<ttg::detail::data_descriptor_t<intrusive::symmetric::t::Tile>,
+                             ttg::detail::compressed_data_descriptor<intrusive::symmetric::t::Tile>>);
+static_assert(std::is_same_v<ttg::detail::data_descriptor_t<intrusive::symmetric::t::NonPOD>,
+                             ttg::default_data_descriptor<intrusive::symmetric::t::NonPOD>>);
+
+TEST_CASE("Payload Compression", "[serialization]") {
+  using Tile = intrusive::symmetric::t::Tile;
+
+  // block of block-sparse spmm: 100x100 nonzeros padded to 128x128
+  auto make_padded_block = []() {
+    Tile tile(128, 128);
+    for (int i = 0; i != 100; ++i)
+      for (int j = 0; j != 100; ++j) tile.data[i * 128 + j] = 1. / (1 + i + j);
+    return tile;
+  };
+  // MRA coefficients (k = 10) after truncation: the high-order coefficients are dropped
+  auto make_truncated_coeffs = []() {
+    const int k = 10;
+    Tile tile(k * k, k);
+    for (int i = 0; i != k; ++i)
+      for (int j = 0; j != k; ++j)
+        for (int l = 0; l != k; ++l) {
+          const double c = std::exp(-2. * (i + j + l)) * (1 + 0.1 * l);
+          tile.data[(i * k + j) * k + l] = c < 1e-8 ? 0. : c;
+        }
+    return tile;
+  };
+
+  SECTION("codec") {
+    auto roundtrip = [](const std::vector<unsigned char>& src, std::size_t element_size) {
+      std::vector<unsigned char> compressed(ttg::detail::shuffle_rle::compress_bound(src.size()));
+      const auto size = ttg::detail::shuffle_rle::compress(src.data(), src.size(), element_size, compressed.data(),
+                                                           compressed.size());
+      REQUIRE(size <= compressed.size());
+      std::vector<unsigned char> decompressed(src.size());
+      ttg::detail::shuffle_rle::decompress(compressed.data(), size, element_size, decompressed.data(),
+                                           decompressed.size());
+      CHECK(decompressed == src);
+      return size;
+    };
+    CHECK(roundtrip({}, 8) == 0);
+    CHECK(roundtrip(std::vector<unsigned char>(1000, 0), 8) < 20);
+    std::vector<unsigned char> noise(1001);
+    for (std::size_t i = 0; i != noise.size(); ++i) noise[i] = static_cast<unsigned char>((i * 7919) % 251);
+    // incompressible data grows by at most one byte per 128
+    CHECK(roundtrip(noise, 8) <= ttg::detail::shuffle_rle::compress_bound(noise.size()));
+    CHECK(roundtrip(noise, 3) <= ttg::detail::shuffle_rle::compress_bound(noise.size()));
+
+    std::vector<unsigned char> too_small(4);
+    CHECK(ttg::detail::shuffle_rle::compress(noise.data(), noise.size(), 8, too_small.data(), too_small.size()) ==
+          std::numeric_limits<std::size_t>::max());
+    CHECK_THROWS_AS(ttg::detail::shuffle_rle::decompress(noise.data(), 10, 8, too_small.data(), too_small.size()),
+                    std::out_of_range);
+  }
+
+  SECTION("data descriptor") {
+    const ttg_data_descriptor* d = ttg::get_data_descriptor<Tile>();
+    auto& stats = ttg::detail::payload_compression_statistics();
+    for (const auto& tile : {make_padded_block(), make_truncated_coeffs(), Tile(2, 2)}) {
+      const auto npayloads = stats.npayloads.load();
+      const auto size = d->payload_size(&tile);
+      std::vector<unsigned char> buf(size + 1);
+      CHECK(d->pack_payload_once(&tile, size - 1, 1, buf.data()) == ttg::detail::pack_payload_overflow);
+      CHECK(d->pack_payload_once(&tile, size, 1, buf.data()) == size + 1);
+      Tile copy;
+      d->unpack_payload(&copy, size, 1, buf.data());
+      CHECK(copy == tile);
+      // pack_payload copies the payload compressed by payload_size, or compresses again if that was not called
+      for (int pass = 0; pass != 2; ++pass) {
+        if (pass == 0) CHECK(d->payload_size(&tile) == size);
+        std::vector<unsigned char> packed(size + 1);
+        CHECK(d->pack_payload(&tile, size, 1, packed.data()) == size + 1);
+        CHECK(packed == buf);
+      }
+      // only payloads above the threshold are compressed, and recorded
+      const auto raw_size = ttg::default_data_descriptor<Tile>::payload_size(&tile);
+      if (raw_size >= ttg::payload_compression<Tile>::threshold) {
+        CHECK(size < raw_size);
+        CHECK(stats.npayloads.load() > npayloads);
+      } else
+        CHECK(size == raw_size + 1);
+    }
+  }
+}
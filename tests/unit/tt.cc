@@ -2,7 +2,17 @@
 
 #include "ttg.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include "ttg/util/meta/callable.h"
 
@@ -437,4 +447,744 @@ TEST_CASE("TemplateTask", "[core]") {
       static_assert(!ttg::meta::is_generic_callable_v<decltype(&args_pmf::X::g<int>)>);
     }
   }
+
+  SECTION("static_dispatch") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 100;
+      std::atomic<int> nread = 0, nconsumed = 0;
+      std::atomic<long> sum = 0;
+      ttg::Edge<int, int> P2C;
+      ttg::Edge<int, int> P2P;
+      auto producer = ttg::make_tt(
+          [](const int &key, int &&value, std::tuple<ttg::Out<int, int>, ttg::Out<int, int>> &outs) {
+            if (key < N) {
+              ttg::send<1>(key + 1, value + 1, outs);
+              // the consumer gets the moved value, the reader a copy
+              ttg::send<0>(key, std::move(value), outs);
+            }
+          },
+          ttg::edges(P2P), ttg::edges(P2C, P2P));
+      auto reader = ttg::make_tt(
+          [&](const int &key, const int &value, std::tuple<> &outs) {
+            CHECK(value == key);
+            ++nread;
+          },
+          ttg::edges(P2C), ttg::edges());
+      auto consumer = ttg::make_tt(
+          [&](const int &key, int &&value, std::tuple<> &outs) {
+            sum += value;
+            ++nconsumed;
+          },
+          ttg::edges(P2C), ttg::edges());
+      auto prev = ttg::TTBase::set_static_dispatch(true);
+      make_graph_executable(producer.get());
+      ttg::TTBase::set_static_dispatch(prev);
+      if (ttg::default_execution_context().rank() == 0) producer->invoke(0, 0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(nread == N);
+      CHECK(nconsumed == N);
+      CHECK(sum == N * (N - 1) / 2);
+    }
+  }
+
+  SECTION("streams") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 1000;  // number of producer tasks
+      constexpr int M = 10;    // number of consumer tasks
+      std::atomic<int> nsent = 0, ntasks = 0;
+      std::atomic<long> sum = 0;
+      ttg::Edge<int, int> P2C_sized, P2C_finalized;
+      // the producer tasks run concurrently, each sends one value to both streams of consumer task key%M
+      auto producer = ttg::make_tt<int>(
+          [&](const int &key, std::tuple<ttg::Out<int, int>, ttg::Out<int, int>> &outs) {
+            ttg::send<0>(key % M, 1, outs);
+            ttg::send<1>(key % M, key, outs);
+            // the last producer finalizes the unsized streams
+            if (++nsent == N)
+              for (int m = 0; m != M; ++m) ttg::finalize<1>(m, outs);
+          },
+          ttg::edges(), ttg::edges(P2C_sized, P2C_finalized));
+      auto consumer = ttg::make_tt(
+          [&](const int &key, const int &count, const int &value, std::tuple<> &outs) {
+            CHECK(count == N / M);
+            sum += value;
+            ++ntasks;
+          },
+          ttg::edges(P2C_sized, P2C_finalized), ttg::edges());
+      consumer->set_input_reducer<0>([](int &a, const int &b) { a += b; });
+      consumer->set_input_reducer<1>([](int &a, const int &b) { a += b; });
+      make_graph_executable(producer.get());
+      if (ttg::default_execution_context().rank() == 0) {
+        for (int m = 0; m != M; ++m) consumer->set_argstream_size<0>(m, N / M);
+        for (int k = 0; k != N; ++k) producer->invoke(k);
+      }
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(ntasks == M);
+      CHECK(sum == N * (N - 1) / 2);
+    }
+  }
+
+  SECTION("concurrent_set_arg") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 1000;
+      std::atomic<int> ntasks = 0;
+      ttg::Edge<int, int> A2C, B2C, C2C;
+      // the arguments of each consumer task are set concurrently by tasks of three producers
+      auto make_producer = [](ttg::Edge<int, int> &out) {
+        return ttg::make_tt<int>(
+            [](const int &key, std::tuple<ttg::Out<int, int>> &outs) { ttg::send<0>(key, key, outs); }, ttg::edges(),
+            ttg::edges(out));
+      };
+      auto a = make_producer(A2C);
+      auto b = make_producer(B2C);
+      auto c = make_producer(C2C);
+      auto consumer = ttg::make_tt(
+          [&](const int &key, const int &va, const int &vb, const int &vc, std::tuple<> &outs) {
+            CHECK(va == key);
+            CHECK(vb == key);
+            CHECK(vc == key);
+            ++ntasks;
+          },
+          ttg::edges(A2C, B2C, C2C), ttg::edges());
+      make_graph_executable(a.get(), b.get(), c.get());
+      if (ttg::default_execution_context().rank() == 0) {
+        for (int k = 0; k != N; ++k) {
+          a->invoke(k);
+          b->invoke(k);
+          c->invoke(k);
+        }
+      }
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(ntasks == N);
+    }
+  }
+
+  SECTION("pull_coalescing") {
+    constexpr int NE = 20;  // number of container elements
+    constexpr int K = 4;    // number of consumer tasks per element
+    const int P = ttg::default_execution_context().size();
+    const int rank = ttg::default_execution_context().rank();
+    // the container counts its accesses; all ranks hold a copy, but only the owner of an element reads it
+    struct counting_container {
+      std::vector<int> data = std::vector<int>(NE);
+      std::atomic<int> nget = 0;
+      int at(int e) {
+        ++nget;
+        return data.at(e);
+      }
+    } container;
+    auto element_owner = [P](int e) { return e % P; };
+    auto task_owner = [P](int key) { return (key / K + 1) % P; };  // never the owner of the element if P > 1
+    std::atomic<int> ntasks = 0, nwrong = 0;
+    ttg::Edge<int, int> P2C;
+    ttg::Edge<int, int> pull("pull", true, {container, [](int key) { return key / K; }, element_owner});
+    auto producer = ttg::make_tt<int>(
+        [](const int &key, std::tuple<ttg::Out<int, int>> &outs) { ttg::send<0>(key, key, outs); }, ttg::edges(),
+        ttg::edges(P2C));
+    auto consumer = ttg::make_tt(
+        [&](const int &key, const int &value, const int &element, std::tuple<> &outs) {
+          if (value != key || element != container.data[key / K]) ++nwrong;
+          ++ntasks;
+        },
+        ttg::edges(P2C, pull), ttg::edges());
+    producer->set_keymap(task_owner);
+    consumer->set_keymap(task_owner);
+    make_graph_executable(producer.get());
+    // the second round checks that the elements pulled in the first round are not reused after the fence
+    for (int round = 0; round != 2; ++round) {
+      for (int e = 0; e != NE; ++e) container.data[e] = 100 * round + e;
+      container.nget = 0;
+      ttg::ttg_fence(ttg::default_execution_context());
+      for (int key = 0; key != NE * K; ++key)
+        if (task_owner(key) == rank) producer->invoke(key);
+      ttg::ttg_fence(ttg::default_execution_context());
+      int nget = container.nget;
+      ttg::default_execution_context().allreduce(nget, std::plus<>{});
+#if defined(TTG_USE_MADNESS)
+      // remote elements are pulled once for all tasks that map to them
+      CHECK(nget == (P > 1 ? NE : NE * K));
+#else
+      CHECK(nget >= NE);
+#endif
+    }
+    int ntotal = ntasks;
+    ttg::default_execution_context().allreduce(ntotal, std::plus<>{});
+    CHECK(ntotal == 2 * NE * K);
+    CHECK(nwrong == 0);
+  }
+
+  SECTION("broadcast_move") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 10;
+      // the broadcast value is recognized by its capacity, copies will have capacity == size
+      constexpr std::size_t capacity = 100;
+      std::atomic<int> nread = 0, nconsumed = 0, nmoved = 0;
+      ttg::Edge<int, std::vector<int>> B2C;
+      ttg::Edge<int, void> start;
+      auto producer = ttg::make_tt(
+          [](const int &key, std::tuple<ttg::Out<int, std::vector<int>>> &outs) {
+            std::vector<int> keys(N);
+            std::iota(keys.begin(), keys.end(), 0);
+            std::vector<int> value;
+            value.reserve(capacity);
+            value.resize(N, 1);
+            ttg::broadcast<0>(keys, std::move(value), outs);
+          },
+          ttg::edges(start), ttg::edges(B2C));
+      auto reader = ttg::make_tt([&](const int &key, const std::vector<int> &value, std::tuple<> &outs) { ++nread; },
+                                 ttg::edges(B2C), ttg::edges());
+      auto consumer = ttg::make_tt(
+          [&](const int &key, std::vector<int> &&value, std::tuple<> &outs) {
+            CHECK(value.size() == N);
+            if (value.capacity() == capacity) ++nmoved;
+            ++nconsumed;
+          },
+          ttg::edges(B2C), ttg::edges());
+      make_graph_executable(producer.get());
+      if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(nread == N);
+      CHECK(nconsumed == N);
+      // exactly one consumer took over the broadcast value
+      CHECK(nmoved == 1);
+    }
+  }
+
+  SECTION("broadcast_lazy_range") {
+    constexpr int N = 10;
+    std::atomic<int> nstrided = 0, ngenerated = 0, nextreme = 0;
+    std::atomic<long> keysum = 0;
+    ttg::Edge<int, int> B2S;
+    ttg::Edge<int, int> B2G;
+    ttg::Edge<int, int> B2E;
+    ttg::Edge<int, void> start;
+    // INT_MIN, -1, INT_MAX - 1: the keys are representable but 2*stride is not
+    constexpr int extreme_start = std::numeric_limits<int>::min();
+    constexpr int extreme_stride = std::numeric_limits<int>::max();
+    {
+      auto extreme = ttg::make_strided_range(extreme_start, extreme_stride, 3);
+      CHECK(extreme[1] == -1);
+      CHECK(extreme[2] == std::numeric_limits<int>::max() - 1);
+      CHECK(ttg::detail::key_difference(extreme[2], extreme[0]) == 2);
+    }
+    auto producer = ttg::make_tt(
+        [](const int &key, std::tuple<ttg::Out<int, int>, ttg::Out<int, int>, ttg::Out<int, int>> &outs) {
+          // keys 1, 4, 7, ...
+          ttg::broadcast<0>(ttg::make_strided_range(1, 3, N), 42, outs);
+          // keys 0, 1, 4, 9, ...
+          ttg::broadcast<1>(ttg::make_generated_range(N, [](std::size_t k) { return int(k * k); }), 42, outs);
+          ttg::broadcast<2>(ttg::make_strided_range(extreme_start, extreme_stride, 3), 42, outs);
+        },
+        ttg::edges(start), ttg::edges(B2S, B2G, B2E));
+    auto strided = ttg::make_tt(
+        [&](const int &key, const int &value, std::tuple<> &outs) {
+          CHECK(value == 42);
+          CHECK(key % 3 == 1);
+          keysum += key;
+          ++nstrided;
+        },
+        ttg::edges(B2S), ttg::edges());
+    auto generated = ttg::make_tt(
+        [&](const int &key, const int &value, std::tuple<> &outs) {
+          CHECK(value == 42);
+          ++ngenerated;
+        },
+        ttg::edges(B2G), ttg::edges());
+    auto extreme = ttg::make_tt(
+        [&](const int &key, const int &value, std::tuple<> &outs) {
+          CHECK((key == extreme_start || key == -1 || key == std::numeric_limits<int>::max() - 1));
+          ++nextreme;
+        },
+        ttg::edges(B2E), ttg::edges());
+    // a cyclic keymap makes the keys of each rank a strided subrange, which are sent as such by PaRSEC
+    const int P = ttg::default_execution_context().size();
+    auto cyclic = [P](const int &key) { return static_cast<int>(static_cast<unsigned>(key) % P); };
+    strided->set_keymap(cyclic);
+    extreme->set_keymap(cyclic);
+    make_graph_executable(producer.get());
+    if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+    ttg::ttg_fence(ttg::default_execution_context());
+    long counts[4] = {nstrided, ngenerated, nextreme, keysum};
+    ttg::default_execution_context().allreduce(counts, 4, std::plus<>{});
+    CHECK(counts[0] == N);
+    CHECK(counts[1] == N);
+    CHECK(counts[2] == 3);
+    CHECK(counts[3] == N + 3 * N * (N - 1) / 2);
+  }
+
+  SECTION("broadcast_multi") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 10;
+      constexpr std::size_t capacity = 100;
+      std::atomic<int> nread = 0, nconsumed = 0, nmoved = 0;
+      ttg::Edge<int, std::vector<int>> B2R;
+      ttg::Edge<long, std::vector<int>> B2C;
+      ttg::Edge<int, void> start;
+      auto producer = ttg::make_tt(
+          [](const int &key, std::tuple<ttg::Out<int, std::vector<int>>, ttg::Out<long, std::vector<int>>> &outs) {
+            std::vector<int> rkeys(N);
+            std::iota(rkeys.begin(), rkeys.end(), 0);
+            std::vector<int> value;
+            value.reserve(capacity);
+            value.resize(N, 1);
+            ttg::broadcast<0, 1>(std::make_tuple(rkeys, ttg::make_strided_range(0L, 2L, N)), std::move(value), outs);
+          },
+          ttg::edges(start), ttg::edges(B2R, B2C));
+      auto reader = ttg::make_tt(
+          [&](const int &key, const std::vector<int> &value, std::tuple<> &outs) {
+            CHECK(value.size() == N);
+            ++nread;
+          },
+          ttg::edges(B2R), ttg::edges());
+      auto consumer = ttg::make_tt(
+          [&](const long &key, std::vector<int> &&value, std::tuple<> &outs) {
+            CHECK(value.size() == N);
+            CHECK(key % 2 == 0);
+            if (value.capacity() == capacity) ++nmoved;
+            ++nconsumed;
+          },
+          ttg::edges(B2C), ttg::edges());
+      make_graph_executable(producer.get());
+      if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(nread == N);
+      CHECK(nconsumed == N);
+      // the readers are served before the consumers take over the value
+      CHECK(nmoved == 1);
+    }
+  }
+
+  SECTION("broadcast_multi_connection_order") {
+    constexpr int N = 10;
+    const int P = ttg::default_execution_context().size();
+    const int rank = ttg::default_execution_context().rank();
+    std::atomic<int> nread = 0, nconsumed = 0, nother = 0;
+    ttg::Edge<int, std::vector<int>> B2X, B2Y, X2R, X2C;
+    ttg::Edge<int, void> start;
+    auto producer = ttg::make_tt(
+        [](const int &key, std::tuple<ttg::Out<int, std::vector<int>>, ttg::Out<int, std::vector<int>>> &outs) {
+          std::vector<int> keys(N);
+          std::iota(keys.begin(), keys.end(), 0);
+          ttg::broadcast<0, 1>(std::make_tuple(keys, keys), std::vector<int>(N, 1), outs);
+        },
+        ttg::edges(start), ttg::edges(B2X, B2Y));
+    auto reader = ttg::make_tt(
+        [&](const int &key, const std::vector<int> &value, std::tuple<> &outs) {
+          CHECK(value.size() == N);
+          ++nread;
+        },
+        ttg::edges(X2R), ttg::edges());
+    auto consumer = ttg::make_tt(
+        [&](const int &key, std::vector<int> &&value, std::tuple<> &outs) {
+          CHECK(value.size() == N);
+          ++nconsumed;
+        },
+        ttg::edges(X2C), ttg::edges());
+    auto other = ttg::make_tt(
+        [&](const int &key, const std::vector<int> &value, std::tuple<> &outs) {
+          CHECK(value.size() == N);
+          ++nother;
+        },
+        ttg::edges(B2Y), ttg::edges());
+    reader->set_keymap([P](const int &key) { return key % P; });
+    consumer->set_keymap([P](const int &key) { return (key + 1) % P; });
+    // the successors of the first output terminal are connected in a different order on every other rank
+    if (rank % 2 == 0) {
+      ttg::connect<0, 0>(producer, reader);
+      ttg::connect<0, 0>(producer, consumer);
+    } else {
+      ttg::connect<0, 0>(producer, consumer);
+      ttg::connect<0, 0>(producer, reader);
+    }
+    make_graph_executable(producer.get());
+    if (rank == 0) producer->invoke(0);
+    ttg::ttg_fence(ttg::default_execution_context());
+    int counts[3] = {nread, nconsumed, nother};
+    ttg::default_execution_context().allreduce(counts, 3, std::plus<>{});
+    CHECK(counts[0] == N);
+    CHECK(counts[1] == N);
+    CHECK(counts[2] == N);
+  }
+
+  SECTION("void_key_split_metadata") {
+    // a vector too large to travel with its metadata (see ttg/serialization/std/vector.h), hence transferred by RMA
+    // with PaRSEC, sent from the last process to a void-key task on process 0
+    constexpr int N = 1000;
+    auto world = ttg::default_execution_context();
+    std::atomic<int> nreceived = 0;
+    ttg::Edge<void, std::vector<double>> P2C;
+    auto producer = ttg::make_tt<int>(
+        [](const int &key, std::tuple<ttg::Out<void, std::vector<double>>> &outs) {
+          std::vector<double> value(N);
+          std::iota(value.begin(), value.end(), 0.);
+          ttg::sendv<0>(std::move(value), outs);
+        },
+        ttg::edges(), ttg::edges(P2C));
+    auto consumer = ttg::make_tt(
+        [&](const std::vector<double> &value, std::tuple<> &outs) {
+          CHECK(value.size() == N);
+          CHECK(value.back() == N - 1);
+          ++nreceived;
+        },
+        ttg::edges(P2C), ttg::edges());
+    producer->set_keymap([world](const int &key) { return world.size() - 1; });
+    consumer->set_keymap([]() { return 0; });
+    make_graph_executable(producer.get());
+    if (world.rank() == 0) producer->invoke(0);
+    ttg::ttg_fence(world);
+    if (world.rank() == 0) CHECK(nreceived == 1);
+  }
+
+  SECTION("fusion") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 10;
+      std::atomic<int> nb = 0, nc = 0, nb_inline = 0, nc_inline = 0;
+      std::atomic<long> sum = 0;
+      // the task of A that the calling thread is executing, the task of B that it has just executed
+      static thread_local int a_key = -1, b_key = -1;
+      ttg::Edge<int, void> start;
+      ttg::Edge<int, int> A2B, B2C;
+      auto a = ttg::make_tt(
+          [&](const int &key, std::tuple<ttg::Out<int, int>> &outs) {
+            a_key = key;
+            for (int k = 0; k != N; ++k) ttg::send<0>(k, k, outs);
+            a_key = -1;
+          },
+          ttg::edges(start), ttg::edges(A2B), "A");
+      auto b = ttg::make_tt(
+          [&](const int &key, int &&value, std::tuple<ttg::Out<int, int>> &outs) {
+            // (a task with the same key as the calling task may be invoked directly, regardless of fusion)
+            if (a_key == 0 && key != 0) ++nb_inline;
+            ++nb;
+            ttg::send<0>(key, value + 1, outs);
+            b_key = key;
+          },
+          ttg::edges(A2B), ttg::edges(B2C), "B");
+      auto c = ttg::make_tt(
+          [&](const int &key, const int &value, std::tuple<> &outs) {
+            CHECK(value == key + 1);
+            if (b_key == key) ++nc_inline;
+            sum += value;
+            ++nc;
+          },
+          ttg::edges(B2C), ttg::edges(), "C");
+      // fusion is opt-in
+      CHECK(!ttg::TTBase::is_fusion());
+      auto prev = ttg::TTBase::set_fusion(true);
+      make_graph_executable(a.get());
+      ttg::TTBase::set_fusion(prev);
+      CHECK(a->get_fused_producer() == nullptr);
+      const bool fused = b->is_fusable() && c->is_fusable();
+      if (fused) {
+        CHECK(b->get_fused_producer() == a.get());
+        CHECK(c->get_fused_producer() == b.get());
+        // the chain is drawn as a single node
+        auto dot = ttg::Dot()(a.get());
+        CHECK(dot.find("A + B + C") != std::string::npos);
+        CHECK(dot.find("->") == std::string::npos);
+      }
+      if (ttg::default_execution_context().rank() == 0) a->invoke(0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(nb == N);
+      CHECK(nc == N);
+      CHECK(sum == N * (N + 1) / 2);
+      // each task of A sends N tasks to B, they run as regular tasks; each task of B sends one task to C, it runs
+      // inline right after the task of B
+      CHECK(nb_inline == 0);
+      if (fused) CHECK(nc_inline == N);
+    }
+  }
+
+  SECTION("batch") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 100;
+      constexpr std::size_t batch_size = 8;
+      std::atomic<int> ntasks = 0, nbatches = 0;
+      std::atomic<long> sum = 0;
+      std::atomic<std::size_t> max_batch = 0;
+      // batches execute concurrently if there are multiple threads
+#if defined(TTG_USE_MADNESS)
+      const bool concurrent = madness::ThreadPool::size() > 1;
+#else
+      const bool concurrent = false;
+#endif
+      std::atomic<int> active = 0, max_active = 0;
+      ttg::Edge<int, void> start;
+      ttg::Edge<int, int> P2B;
+      auto producer = ttg::make_tt(
+          [](const int &key, std::tuple<ttg::Out<int, int>> &outs) {
+            for (int k = 0; k != N; ++k) ttg::send<0>(k, k, outs);
+          },
+          ttg::edges(start), ttg::edges(P2B));
+      auto batched = ttg::make_tt(
+          [&](ttg::span<const int> keys, ttg::span<std::tuple<int>> args, std::tuple<> &outs) {
+            CHECK(keys.size() == args.size());
+            for (std::size_t t = 0; t != keys.size(); ++t) {
+              CHECK(std::get<0>(args[t]) == keys[t]);
+              sum += std::get<0>(args[t]);
+            }
+            ntasks += keys.size();
+            ++nbatches;
+            if (keys.size() > max_batch) max_batch = keys.size();
+            // the first batch waits (for a bounded time) for another one to start
+            const int nactive = ++active;
+            if (nactive > max_active) max_active = nactive;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (concurrent && max_active < 2 && std::chrono::steady_clock::now() < deadline)
+              std::this_thread::yield();
+            --active;
+          },
+          ttg::edges(P2B), ttg::edges());
+      batched->set_batch_size(batch_size);
+#if defined(TTG_USE_PARSEC)
+      // batching is MADNESS-only
+      CHECK_THROWS(make_graph_executable(producer.get()));
+#else
+      make_graph_executable(producer.get());
+      if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(ntasks == N);
+      CHECK(sum == N * (N - 1) / 2);
+      CHECK(max_batch <= batch_size);
+      CHECK(nbatches >= (N + batch_size - 1) / batch_size);
+      if (concurrent) CHECK(max_active > 1);
+#endif
+    }
+  }
+
+  SECTION("affinity") {
+    // keys start at 1: key 0 could be invoked directly in the producer task, since its hash matches the idle state
+    constexpr int N = 100;
+    constexpr int NH = 10;  // the tasks with keys up to NH have high priority
+    std::atomic<int> ntasks = 0;
+    std::atomic<long> sum = 0;
+    std::atomic<int> active = 0, max_active = 0;
+    auto enter = [&]() {
+      const int nactive = ++active;
+      if (nactive > max_active) max_active = nactive;
+    };
+    std::mutex mtx;
+    std::vector<int> order;            // keys in the order of execution
+    std::vector<bool> preferred;       // true if the task was executed by the thread it prefers
+    std::set<std::thread::id> threads;  // threads that executed the consumer tasks
+    ttg::Edge<int, void> start;
+    ttg::Edge<int, int> P2C_a, P2C_b;
+    auto producer = ttg::make_tt(
+        [&](const int &key, std::tuple<ttg::Out<int, int>, ttg::Out<int, int>> &outs) {
+          enter();
+          for (int k = 1; k <= N; ++k) ttg::send<0>(k, k, outs);
+          // the high-priority tasks become ready last
+          for (int k = N; k >= 1; --k) ttg::send<1>(k, 1, outs);
+          --active;
+        },
+        ttg::edges(start), ttg::edges(P2C_a, P2C_b));
+    auto consumer = ttg::make_tt(
+        [&](const int &key, const int &a, const int &b, std::tuple<> &outs) {
+          enter();
+          ++ntasks;
+          sum += a + b;
+          {
+            std::lock_guard<std::mutex> lock(mtx);
+            order.push_back(key);
+            threads.insert(std::this_thread::get_id());
+#if defined(TTG_USE_MADNESS)
+            auto &queues = ttg_madness::detail::affinity_queues::instance();
+            preferred.push_back(queues.queue_index(key % 3) == queues.thread_index());
+#endif
+          }
+          --active;
+        },
+        ttg::edges(P2C_a, P2C_b), ttg::edges());
+    consumer->set_affinitymap([](const int &key) { return key % 3; });
+    consumer->set_priomap([](const int &key) { return key <= NH ? 1 : 0; });
+    CHECK(consumer->get_affinitymap()(4) == 1);
+    make_graph_executable(producer.get());
+    if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+    ttg::ttg_fence(ttg::default_execution_context());
+    if (ttg::default_execution_context().size() == 1) {
+      CHECK(ntasks == N);
+      CHECK(sum == N * (N + 1) / 2 + N);
+#if defined(TTG_USE_MADNESS)
+      // if a single thread executed the tasks one at a time, the producer queued all of them before the first one
+      // ran, hence the order is determined by the priorities and the preferred threads
+      if (max_active == 1 && threads.size() == 1) {
+        // the high-priority tasks were executed first
+        for (int t = 0; t != NH; ++t) CHECK(order[t] <= NH);
+        // then the tasks that prefer the executing thread, then the tasks stolen from the other threads
+        const auto first_stolen = std::find(preferred.begin() + NH, preferred.end(), false);
+        CHECK(std::find(first_stolen, preferred.end(), true) == preferred.end());
+      }
+#endif
+    }
+  }
+
+  SECTION("relocatable") {
+    // all tasks are mapped to rank 0, the other ranks may execute some of them
+    constexpr int N = 200;
+    const int rank = ttg::default_execution_context().rank();
+    std::atomic<int> ntasks = 0;
+    ttg::Edge<int, void> start;
+    ttg::Edge<int, int> P2C_a, P2C_b;
+    auto producer = ttg::make_tt(
+        [](const int &key, std::tuple<ttg::Out<int, int>, ttg::Out<int, int>> &outs) {
+          for (int k = 0; k != N; ++k) {
+            ttg::send<0>(k, k, outs);
+            ttg::send<1>(k, 1, outs);
+          }
+        },
+        ttg::edges(start), ttg::edges(P2C_a, P2C_b));
+    // the tasks are slow enough for the ready tasks to pile up on rank 0
+    auto consumer = ttg::make_tt(
+        [&](const int &key, const int &a, const int &b, std::tuple<> &outs) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          ++ntasks;
+        },
+        ttg::edges(P2C_a, P2C_b), ttg::edges());
+    consumer->set_keymap([](const int &key) { return 0; });
+    CHECK(!consumer->is_relocatable());
+    consumer->set_relocatable(true);
+    CHECK(consumer->is_relocatable());
+    make_graph_executable(producer.get());
+    // the loads reported by the ranks when the TT was made executable have arrived after the fence
+    ttg::ttg_fence(ttg::default_execution_context());
+    if (rank == 0) producer->invoke(0);
+    ttg::ttg_fence(ttg::default_execution_context());
+    int ntotal = ntasks, ndelegated = rank == 0 ? 0 : int(ntasks);
+    ttg::default_execution_context().allreduce(ntotal, std::plus<>{});
+    ttg::default_execution_context().allreduce(ndelegated, std::plus<>{});
+    CHECK(ntotal == N);
+#if defined(TTG_USE_MADNESS)
+    if (ttg::default_execution_context().size() > 1) CHECK(ndelegated > 0);
+#endif
+  }
+
+  SECTION("fences") {
+    // every epoch sends its index around a ring of all processes, reusing the keys of the previous epochs
+    constexpr int NEPOCHS = 10;
+    auto world = ttg::default_execution_context();
+    const int nhops = 4 * world.size();
+    std::atomic<int> nhopped = 0;
+    std::atomic<int> last_epoch = -1;
+    ttg::Edge<int, int> ring;
+    auto hop = ttg::make_tt(
+        [&](const int &h, const int &epoch, std::tuple<ttg::Out<int, int>> &out) {
+          ++nhopped;
+          if (h + 1 < nhops)
+            ttg::send<0>(h + 1, epoch, out);
+          else
+            last_epoch = epoch;
+        },
+        ttg::edges(ring), ttg::edges(ring));
+    hop->set_keymap([world](const int &h) { return h % world.size(); });
+    make_graph_executable(hop.get());
+    for (int epoch = 0; epoch != NEPOCHS; ++epoch) {
+      if (world.rank() == 0) hop->invoke(0, epoch);
+      ttg::ttg_fence(world);
+      // the ring of this epoch, and only it, completed before the fence returned
+      int ntotal = nhopped;
+      world.allreduce(ntotal, std::plus<>{});
+      CHECK(ntotal == (epoch + 1) * nhops);
+      if (world.rank() == (nhops - 1) % world.size()) CHECK(last_epoch == epoch);
+    }
+  }
+
+#if defined(TTG_HAVE_COROUTINE) && defined(TTG_USE_MADNESS)
+  SECTION("coroutine") {
+    if (ttg::default_execution_context().size() == 1) {
+      constexpr int N = 10;
+      std::vector<ttg::async_value<int>> fetched(N);
+      std::atomic<int> nsuspended = 0, nresumed = 0;
+      std::atomic<long> sum = 0;
+      ttg::Edge<int, void> start;
+      ttg::Edge<int, int> P2W;
+      ttg::Edge<int, void> P2F;
+      ttg::Edge<int, int> W2S;
+      auto producer = ttg::make_tt(
+          [](const int &key, std::tuple<ttg::Out<int, int>, ttg::Out<int, void>> &outs) {
+            for (int k = 0; k != N; ++k) ttg::send<0>(k, k, outs);
+            for (int k = 0; k != N; ++k) ttg::sendk<1>(k, outs);
+          },
+          ttg::edges(start), ttg::edges(P2W, P2F));
+      // awaits a value that is provided by a task that runs later
+      auto waiter = ttg::make_tt(
+          [&](const int &key, int &&value, std::tuple<ttg::Out<int, int>> &outs) -> ttg::task<> {
+            if (!fetched[key].ready()) ++nsuspended;
+            const auto other = co_await fetched[key];
+            ++nresumed;
+            ttg::send<0>(key, value + other, outs);
+          },
+          ttg::edges(P2W), ttg::edges(W2S));
+      auto fetcher = ttg::make_tt([&](const int &key, std::tuple<> &outs) { fetched[key].set_value(key); },
+                                  ttg::edges(P2F), ttg::edges());
+      auto summer = ttg::make_tt([&](const int &key, const int &value, std::tuple<> &outs) { sum += value; },
+                                 ttg::edges(W2S), ttg::edges());
+      make_graph_executable(producer.get());
+      if (ttg::default_execution_context().rank() == 0) producer->invoke(0);
+      ttg::ttg_fence(ttg::default_execution_context());
+      CHECK(nresumed == N);
+      CHECK(nsuspended > 0);
+      CHECK(sum == N * (N - 1));
+    }
+  }
+
+  SECTION("coroutine_exception") {
+    // a scheduler that resumes the body inline stands in for the backend
+    struct inline_scheduler : ttg::detail::coroutine_scheduler {
+      void *suspend() override { return nullptr; }
+      void resume(void *token, std::function<void()> resume_fn) override { resume_fn(); }
+    } scheduler;
+    // the frame holds a copy of token, hence token is no longer shared once the frame is destroyed
+    auto token = std::make_shared<int>(0);
+    ttg::async_value<int> value;
+    auto body = [](std::shared_ptr<int> token, ttg::async_value<int> value, bool await) -> ttg::task<> {
+      if (await) co_await value;
+      throw std::runtime_error("body failed");
+    };
+    auto *caller_scheduler = std::exchange(ttg::detail::coroutine_scheduler_accessor(), &scheduler);
+    // the exception of a body that fails before suspending is rethrown to the TT that started it
+    CHECK_THROWS_AS(body(token, value, false).keep_alive(nullptr), std::runtime_error);
+    CHECK(token.use_count() == 1);
+    // the exception of a body that fails after resuming is rethrown to the task that resumed it
+    body(token, value, true).keep_alive(nullptr);
+    CHECK(token.use_count() == 2);
+    CHECK_THROWS_AS(value.set_value(1), std::runtime_error);
+    CHECK(token.use_count() == 1);
+    ttg::detail::coroutine_scheduler_accessor() = caller_scheduler;
+  }
+
+  SECTION("coroutine_pull") {
+    constexpr int NE = 20;
+    const int P = ttg::default_execution_context().size();
+    const int rank = ttg::default_execution_context().rank();
+    std::vector<int> data(NE);
+    for (int e = 0; e != NE; ++e) data[e] = e * e;
+    auto owner = [P](int e) { return e % P; };
+    std::atomic<int> ntasks = 0, nwrong = 0;
+    ttg::Edge<int, int> P2C;
+    ttg::Edge<int, int> pull("pull", true, {data, [](int key) { return key; }, owner});
+    // the body awaits the element of the next key besides its own, which is remote if P > 1
+    std::function<ttg::async_value<int>(int)> pull_next;
+    auto producer = ttg::make_tt<int>(
+        [](const int &key, std::tuple<ttg::Out<int, int>> &outs) { ttg::send<0>(key, key, outs); }, ttg::edges(),
+        ttg::edges(P2C));
+    auto consumer = ttg::make_tt(
+        [&](const int &key, const int &value, const int &element, std::tuple<> &outs) -> ttg::task<> {
+          const int next = co_await pull_next((key + 1) % NE);
+          if (value != key || element != data[key] || next != data[(key + 1) % NE]) ++nwrong;
+          ++ntasks;
+        },
+        ttg::edges(P2C, pull), ttg::edges());
+    producer->set_keymap(owner);
+    consumer->set_keymap(owner);
+    pull_next = [tt = consumer.get()](int key) { return tt->pull<1>(key); };
+    make_graph_executable(producer.get());
+    for (int key = 0; key != NE; ++key)
+      if (owner(key) == rank) producer->invoke(key);
+    ttg::ttg_fence(ttg::default_execution_context());
+    int ntotal = ntasks;
+    ttg::default_execution_context().allreduce(ntotal, std::plus<>{});
+    CHECK(ntotal == NE);
+    CHECK(nwrong == 0);
+  }
+#endif  // TTG_HAVE_COROUTINE && TTG_USE_MADNESS
 }
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "ttg.h"
+
+#include "ttg/serialization/std/vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+  /// serialized with the TTG archives, fails to serialize if asked to
+  struct fragile {
+    bool fail = false;
+
+    template <typename Archive>
+    void serialize(Archive &ar) {
+      if (fail) throw std::runtime_error("fragile::serialize");
+      ar &fail;
+    }
+  };
+}  // namespace
+
+TEST_CASE("World collectives", "[world][core]") {
+  auto world = ttg::default_execution_context();
+  const int rank = world.rank();
+  const int size = world.size();
+
+  SECTION("allreduce") {
+    // predefined MPI operation
+    double d = rank + 1;
+    world.allreduce(d, std::plus<>{});
+    CHECK(d == size * (size + 1) / 2);
+
+    // user operation on a bitcopyable type, called in the order of the ranks
+    struct first_last {
+      int first, last;
+    } fl{rank, rank};
+    world.allreduce(fl, [](const first_last &a, const first_last &b) { return first_last{a.first, b.last}; });
+    CHECK(fl.first == 0);
+    CHECK(fl.last == size - 1);
+
+    // serialized type, non-commutative operation
+    std::string s = std::to_string(rank) + ",";
+    world.allreduce(s, [](const std::string &a, const std::string &b) { return a + b; });
+    std::string s_ref;
+    for (int r = 0; r != size; ++r) s_ref += std::to_string(r) + ",";
+    CHECK(s == s_ref);
+
+    // array, long enough to be reduced in segments
+    std::vector<long> v(ttg::detail::mpi::segment_size / sizeof(long) + 3, rank);
+    world.allreduce(v.data(), v.size(), [](long a, long b) { return a + b; });
+    CHECK(std::all_of(v.begin(), v.end(), [&](long x) { return x == size * (size - 1) / 2; }));
+  }
+
+  SECTION("reduce") {
+    const int root = size - 1;
+    int i = rank;
+    world.reduce(i, [](int a, int b) { return std::max(a, b); }, root);
+    if (rank == root) CHECK(i == size - 1);
+
+    std::vector<int> v(rank + 1, rank);
+    world.reduce(
+        v,
+        [](const std::vector<int> &a, const std::vector<int> &b) {
+          auto result = a;
+          result.insert(result.end(), b.begin(), b.end());
+          return result;
+        },
+        root);
+    if (rank == root) CHECK(v.size() == std::size_t(size * (size + 1) / 2));
+
+    // serialized type, non-commutative operation, reduced along a tree rooted elsewhere
+    std::string s = std::to_string(rank) + ",";
+    world.reduce(s, [](const std::string &a, const std::string &b) { return a + b; }, size / 2);
+    std::string s_ref;
+    for (int r = 0; r != size; ++r) s_ref += std::to_string(r) + ",";
+    if (rank == size / 2) CHECK(s == s_ref);
+  }
+
+  SECTION("broadcast") {
+    std::vector<int> v;
+    if (rank == 0) v.assign(10000, 42);
+    world.broadcast(v);
+    CHECK(v.size() == 10000);
+    CHECK(v.back() == 42);
+  }
+
+  SECTION("gather") {
+    const auto strings = world.gather(std::string(rank + 1, 'a'));
+    if (rank == 0) {
+      REQUIRE(strings.size() == std::size_t(size));
+      for (int r = 0; r != size; ++r) CHECK(strings[r] == std::string(r + 1, 'a'));
+    } else
+      CHECK(strings.empty());
+
+    // the serialization fails on one process only, all throw rather than block
+    CHECK_THROWS_AS(world.gather(fragile{rank == size - 1}), std::runtime_error);
+  }
+}
@@ -6,6 +6,7 @@
 #include "ttg/runtimes.h"
 #include "ttg/util/demangle.h"
 #include "ttg/util/hash.h"
+#include "ttg/util/key_range.h"
 #include "ttg/util/meta.h"
 #include "ttg/util/print.h"
 #include "ttg/util/trace.h"
@@ -13,9 +14,11 @@
 #include "ttg/util/typelist.h"
 
 #include "ttg/base/keymap.h"
+#include "ttg/base/keymaps.h"
 #include "ttg/base/terminal.h"
 #include "ttg/base/world.h"
 #include "ttg/broadcast.h"
+#include "ttg/coroutine.h"
 #include "ttg/func.h"
 #include "ttg/reduce.h"
 #include "ttg/traverse.h"
@@ -0,0 +1,330 @@
+#ifndef TTG_BASE_KEYMAPS_H
+#define TTG_BASE_KEYMAPS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ttg/util/hash.h"
+#include "ttg/util/print.h"
+
+/// @file keymaps.h
+/// A library of keymaps for the index spaces commonly used by TTG programs. Unlike the default keymap
+/// (see detail::default_keymap_impl), which scatters keys by their hash, these maps preserve the locality of the
+/// index space and thereby reduce the volume of data communicated between tasks. Any of them can be passed to
+/// TT::set_keymap() or to make_tt() in place of the default keymap.
+
+namespace ttg {
+
+  namespace detail {
+
+    /// @return the process grid {P,Q}, P <= Q, P*Q == \p nproc , that is as square as possible
+    inline std::pair<int, int> near_square_grid(int nproc) {
+      if (nproc < 1) {
+        ttg::print_error("ttg::near_square_grid: the number of processes must be positive");
+        throw std::invalid_argument("ttg::near_square_grid: nproc < 1");
+      }
+      int P = static_cast<int>(std::sqrt(static_cast<double>(nproc)));
+      while (nproc % P != 0) --P;
+      return {P, nproc / P};
+    }
+
+    /// @return the index of \p x along the Z-order (Morton) curve in a grid of 2^bits points per dimension
+    template <std::size_t NDIM>
+    std::uint64_t morton_index(const std::array<std::uint64_t, NDIM> &x, int bits) {
+      std::uint64_t result = 0;
+      for (int b = bits - 1; b >= 0; --b)
+        for (std::size_t d = 0; d != NDIM; ++d) result = (result << 1) | ((x[d] >> b) & 1);
+      return result;
+    }
+
+    /// @return the index of \p x along the Hilbert curve in a grid of 2^bits points per dimension
+    /// @note uses the transpose algorithm of J. Skilling, AIP Conf. Proc. 707, 381 (2004)
+    template <std::size_t NDIM>
+    std::uint64_t hilbert_index(std::array<std::uint64_t, NDIM> x, int bits) {
+      if (bits == 0) return 0;
+      const std::uint64_t M = std::uint64_t(1) << (bits - 1);
+      // inverse undo
+      for (std::uint64_t Q = M; Q > 1; Q >>= 1) {
+        const std::uint64_t P = Q - 1;
+        for (std::size_t i = 0; i != NDIM; ++i) {
+          if (x[i] & Q)
+            x[0] ^= P;
+          else {
+            const std::uint64_t t = (x[0] ^ x[i]) & P;
+            x[0] ^= t;
+            x[i] ^= t;
+          }
+        }
+      }
+      // Gray encode
+      for (std::size_t i = 1; i != NDIM; ++i) x[i] ^= x[i - 1];
+      std::uint64_t t = 0;
+      for (std::uint64_t Q = M; Q > 1; Q >>= 1)
+        if (x[NDIM - 1] & Q) t ^= Q - 1;
+      for (std::size_t i = 0; i != NDIM; ++i) x[i] ^= t;
+      // the transposed index interleaves to the Hilbert index
+      return morton_index(x, bits);
+    }
+
+  }  // namespace detail
+
+  /// the space-filling curves supported by sfc_keymap and tree_sfc_keymap
+  enum class space_filling_curve {
+    morton,  //!< Z-order curve; cheap, but consecutive chunks may be disconnected
+    hilbert  //!< Hilbert curve; consecutive chunks are connected, hence fewer remote neighbors
+  };
+
+  /// Maps keys with 2 indices (e.g. the tile indices {i,j} of ttg::MultiIndex<2>) to the processes of a P×Q grid
+  /// in block-cyclic fashion, like ScaLAPACK: key {i,j} is owned by process `((i/mb) % P) * Q + (j/nb) % Q`.
+  /// Keys are accessed as `key[0]` and `key[1]`.
+  class block_cyclic_keymap_2d {
+   public:
+    /// @param P the number of process rows
+    /// @param Q the number of process columns
+    /// @param mb the number of consecutive row indices mapped to the same process row
+    /// @param nb the number of consecutive column indices mapped to the same process column
+    block_cyclic_keymap_2d(int P, int Q, int mb = 1, int nb = 1) : P_(P), Q_(Q), mb_(mb), nb_(nb) {
+      if (P < 1 || Q < 1 || mb < 1 || nb < 1) {
+        ttg::print_error("ttg::block_cyclic_keymap_2d: grid and block dimensions must be positive");
+        throw std::invalid_argument("ttg::block_cyclic_keymap_2d: invalid grid or block dimensions");
+      }
+    }
+
+    /// uses the process grid for \p nproc processes that is as square as possible
+    explicit block_cyclic_keymap_2d(int nproc)
+        : block_cyclic_keymap_2d(detail::near_square_grid(nproc).first, detail::near_square_grid(nproc).second) {}
+
+    template <typename Key>
+    int operator()(const Key &key) const {
+      return owner(key[0], key[1]);
+    }
+
+    /// @return the process owning indices {i,j}
+    int owner(long i, long j) const {
+      return static_cast<int>(((i / mb_) % P_) * Q_ + (j / nb_) % Q_);
+    }
+
+    int P() const { return P_; }
+    int Q() const { return Q_; }
+
+   private:
+    int P_, Q_, mb_, nb_;
+  };
+
+  /// Maps keys with 3 indices {i,j,k} (e.g. the tasks of a 2.5D/3D SUMMA-like matrix multiplication) to the
+  /// processes of a P×Q×c grid: \p c layers, each a block-cyclic P×Q grid (see block_cyclic_keymap_2d), with
+  /// the k index distributed cyclically over the layers. Key {i,j,k} is owned by process
+  /// `(k % c) * P * Q + ((i/mb) % P) * Q + (j/nb) % Q`, hence each {i,j} is replicated on at most c layers.
+  class block_cyclic_keymap_3d {
+   public:
+    /// @param P the number of process rows of each layer
+    /// @param Q the number of process columns of each layer
+    /// @param c the number of layers, i.e. the replication factor
+    block_cyclic_keymap_3d(int P, int Q, int c, int mb = 1, int nb = 1) : layer_(P, Q, mb, nb), c_(c) {
+      if (c < 1) {
+        ttg::print_error("ttg::block_cyclic_keymap_3d: the replication factor must be positive");
+        throw std::invalid_argument("ttg::block_cyclic_keymap_3d: c < 1");
+      }
+    }
+
+    /// uses \p c layers of the process grid for \p nproc / \p c processes that is as square as possible
+    block_cyclic_keymap_3d(int nproc, int c) : block_cyclic_keymap_3d(layer_grid(nproc, c), c) {}
+
+    template <typename Key>
+    int operator()(const Key &key) const {
+      return owner(key[0], key[1], key[2]);
+    }
+
+    /// @return the process owning indices {i,j,k}
+    int owner(long i, long j, long k) const {
+      return static_cast<int>((k % c_) * layer_.P() * layer_.Q()) + layer_.owner(i, j);
+    }
+
+    int P() const { return layer_.P(); }
+    int Q() const { return layer_.Q(); }
+    int c() const { return c_; }
+
+   private:
+    block_cyclic_keymap_2d layer_;
+    int c_;
+
+    block_cyclic_keymap_3d(std::pair<int, int> PQ, int c) : block_cyclic_keymap_3d(PQ.first, PQ.second, c) {}
+
+    static std::pair<int, int> layer_grid(int nproc, int c) {
+      if (c < 1 || nproc % c != 0) {
+        ttg::print_error("ttg::block_cyclic_keymap_3d: the replication factor must divide the number of processes");
+        throw std::invalid_argument("ttg::block_cyclic_keymap_3d: nproc % c != 0");
+      }
+      return detail::near_square_grid(nproc / c);
+    }
+  };
+
+  /// Maps keys with \p NDIM indices in a box of given extents (e.g. ttg::MultiIndex<NDIM>) to processes by cutting a
+  /// space-filling curve through the box into \c nproc chunks with equal numbers of keys. Neighboring keys are
+  /// mostly owned by the same process, hence stencil-like dependencies are mostly local.
+  /// Keys are accessed as `key[d]`, d = 0 .. NDIM-1.
+  /// @note the chunk boundaries are computed on construction by enumerating the box if it has up to 2^24 keys
+  ///       (O(N log N) work, O(nproc) storage); larger boxes are cut into chunks of equal length along the curve,
+  ///       which balances exactly only if all extents are equal powers of 2
+  template <std::size_t NDIM>
+  class sfc_keymap {
+    static_assert(NDIM > 0, "ttg::sfc_keymap: NDIM must be positive");
+
+   public:
+    sfc_keymap(int nproc, const std::array<std::size_t, NDIM> &extents,
+               space_filling_curve curve = space_filling_curve::hilbert)
+        : nproc_(nproc), curve_(curve) {
+      if (nproc < 1) {
+        ttg::print_error("ttg::sfc_keymap: the number of processes must be positive");
+        throw std::invalid_argument("ttg::sfc_keymap: nproc < 1");
+      }
+      std::size_t nkeys = 1;
+      std::size_t max_extent = 1;
+      for (auto e : extents) {
+        if (e == 0) {
+          ttg::print_error("ttg::sfc_keymap: extents must be positive");
+          throw std::invalid_argument("ttg::sfc_keymap: zero extent");
+        }
+        nkeys *= e;
+        max_extent = std::max(max_extent, e);
+      }
+      while ((std::size_t(1) << bits_) < max_extent) ++bits_;
+      if (bits_ * NDIM > 63) {
+        ttg::print_error("ttg::sfc_keymap: extents are too large to index the curve with 64 bits");
+        throw std::invalid_argument("ttg::sfc_keymap: extents too large");
+      }
+      if (nproc_ > 1 && nkeys <= (std::size_t(1) << 24)) {
+        std::vector<std::uint64_t> indices;
+        indices.reserve(nkeys);
+        std::array<std::uint64_t, NDIM> x{};
+        for (std::size_t n = 0; n != nkeys; ++n) {
+          indices.push_back(index(x));
+          for (std::size_t d = 0; d != NDIM && ++x[d] == extents[d]; ++d) x[d] = 0;
+        }
+        std::sort(indices.begin(), indices.end());
+        // bounds_[p] is the first curve index owned by process p+1
+        bounds_.reserve(nproc_ - 1);
+        for (int p = 1; p < nproc_; ++p) bounds_.push_back(indices[(nkeys * p) / nproc_]);
+      }
+    }
+
+    template <typename Key>
+    int operator()(const Key &key) const {
+      std::array<std::uint64_t, NDIM> x;
+      for (std::size_t d = 0; d != NDIM; ++d) x[d] = static_cast<std::uint64_t>(key[d]);
+      return owner(x);
+    }
+
+    /// @return the process owning the key with indices \p x
+    int owner(const std::array<std::uint64_t, NDIM> &x) const {
+      if (nproc_ == 1) return 0;
+      const auto idx = index(x);
+      if (!bounds_.empty())
+        return static_cast<int>(std::upper_bound(bounds_.begin(), bounds_.end(), idx) - bounds_.begin());
+      return static_cast<int>(static_cast<long double>(idx) * nproc_ / std::ldexp(1.0L, bits_ * NDIM));
+    }
+
+   private:
+    int nproc_;
+    space_filling_curve curve_;
+    int bits_ = 0;
+    std::vector<std::uint64_t> bounds_;
+
+    std::uint64_t index(const std::array<std::uint64_t, NDIM> &x) const {
+      return curve_ == space_filling_curve::hilbert ? detail::hilbert_index(x, bits_)
+                                                    : detail::morton_index(x, bits_);
+    }
+  };
+
+  /// Maps the keys of a 2^NDIM-tree (e.g. the `Key<NDIM>` of multiresolution analysis, with `level()` \c n and
+  /// `translation()` \c l, 0 <= l[d] < 2^n) to processes by cutting a space-filling curve through the unit cube into
+  /// \c nproc chunks of equal volume. The children of a box occupy a contiguous segment of their parent's segment of
+  /// the curve, hence parents and children are owned by the same process except along the chunk boundaries.
+  /// @note a box is owned by the owner of its first descendant along the curve, hence the boxes of the coarsest
+  ///       levels are owned by the first processes
+  template <std::size_t NDIM>
+  class tree_sfc_keymap {
+    static_assert(NDIM > 0, "ttg::tree_sfc_keymap: NDIM must be positive");
+
+   public:
+    /// @param nproc the number of processes
+    /// @param curve the space-filling curve
+    /// @param max_level the finest level of keys to be mapped, at most 63/NDIM
+    explicit tree_sfc_keymap(int nproc, space_filling_curve curve = space_filling_curve::hilbert,
+                             int max_level = 63 / NDIM)
+        : nproc_(nproc), curve_(curve), max_level_(max_level) {
+      if (nproc < 1 || max_level < 0 || max_level * NDIM > 63) {
+        ttg::print_error("ttg::tree_sfc_keymap: invalid number of processes or maximum level");
+        throw std::invalid_argument("ttg::tree_sfc_keymap: invalid arguments");
+      }
+    }
+
+    template <typename Key>
+    int operator()(const Key &key) const {
+      std::array<std::uint64_t, NDIM> x;
+      const auto &l = key.translation();
+      for (std::size_t d = 0; d != NDIM; ++d) x[d] = static_cast<std::uint64_t>(l[d]);
+      return owner(static_cast<int>(key.level()), x);
+    }
+
+    /// @return the process owning the box with level \p n and translation \p l
+    int owner(int n, const std::array<std::uint64_t, NDIM> &l) const {
+      if (nproc_ == 1) return 0;
+      if (n > max_level_) {
+        ttg::print_error("ttg::tree_sfc_keymap: key level ", n, " exceeds the maximum level ", max_level_);
+        throw std::out_of_range("ttg::tree_sfc_keymap: level too large");
+      }
+      const auto idx = curve_ == space_filling_curve::hilbert ? detail::hilbert_index(l, n)
+                                                              : detail::morton_index(l, n);
+      // position of the first descendant of the box along the curve, as a fraction of the curve's length
+      const auto pos = static_cast<long double>(idx) / std::ldexp(1.0L, n * NDIM);
+      return std::min(static_cast<int>(pos * nproc_), nproc_ - 1);
+    }
+
+   private:
+    int nproc_;
+    space_filling_curve curve_;
+    int max_level_;
+  };
+
+  /// Maps the keys of a tree (with `level()`, `parent()`, and ttg::hash) to processes by hashing, but keeps the
+  /// children at even levels greater than \c min_level (i.e. finer than it) with their parents: the parent and the
+  /// children of a box are then owned by the same process every other level, which halves the number of remote
+  /// parent-child dependencies, while preserving the load balance of hashing. Level 0 is owned by process 0.
+  class level_keymap {
+   public:
+    /// @param nproc the number of processes
+    /// @param min_level keys at levels up to \p min_level are always mapped by their own hash
+    explicit level_keymap(int nproc, int min_level = 3) : nproc_(nproc), min_level_(min_level) {
+      if (nproc < 1) {
+        ttg::print_error("ttg::level_keymap: the number of processes must be positive");
+        throw std::invalid_argument("ttg::level_keymap: nproc < 1");
+      }
+    }
+
+    template <typename Key>
+    int operator()(const Key &key) const {
+      const auto n = key.level();
+      if (n == 0 || nproc_ == 1) return 0;
+      std::size_t hash;
+      if (n <= min_level_ || (n & 0x1))
+        hash = ttg::hash<Key>{}(key);
+      else
+        hash = ttg::hash<Key>{}(key.parent());
+      return static_cast<int>(hash % nproc_);
+    }
+
+   private:
+    int nproc_;
+    int min_level_;
+  };
+
+}  // namespace ttg
+
+#endif  // TTG_BASE_KEYMAPS_H
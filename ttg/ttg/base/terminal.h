@@ -32,6 +32,7 @@ namespace ttg {
 
     std::vector<TerminalBase *> successors_;
     std::vector<TerminalBase *> predecessors_; //This is required for pull terminals.
+    size_t npush_predecessors = 0;  //< Number of output terminals connected to this terminal
 
     TerminalBase(const TerminalBase &) = delete;
     TerminalBase(TerminalBase &&) = delete;
@@ -61,6 +62,7 @@ namespace ttg {
       successors_.push_back(successor);
       connected = true;
       successor->connected = true;
+      successor->npush_predecessors++;
     }
 
     void connect_pull(TerminalBase *predecessor) {
@@ -69,6 +71,10 @@ namespace ttg {
       connected = true;
     }
 
+    /// Called by the containing TT when it is made executable, i.e. when the connections of this terminal are final.
+    /// Output terminals use this to precompute their dispatch to the successors.
+    virtual void make_executable() {}
+
   public:
     /// Return ptr to containing tt
     TTBase *get_tt() const {
@@ -107,6 +113,8 @@ namespace ttg {
     const std::vector<TerminalBase *> &get_connections() const { return successors_; }
     // Get connections to predecessors
     const std::vector<TerminalBase *> &get_predecessors() const {return predecessors_; }
+    /// Returns the number of output terminals connected to this (input) terminal
+    size_t get_num_push_predecessors() const { return npush_predecessors; }
 
     //Connect Container pull terminals without incoming terminals
     //This is a hack, is there a better way?
@@ -24,6 +24,16 @@ namespace ttg {
       static bool lazy_pull = false;
       return lazy_pull;
     }
+
+    inline bool &tt_base_static_dispatch_accessor(void) {
+      static bool static_dispatch = false;
+      return static_dispatch;
+    }
+
+    inline bool &tt_base_fusion_accessor(void) {
+      static bool fusion = false;
+      return fusion;
+    }
   }  // namespace detail
 
   /// A base class for all template tasks
@@ -42,6 +52,9 @@ namespace ttg {
     bool executable = false;  //!< ready to execute?
     bool is_ttg_ = false;
     bool lazy_pull_instance = false;
+    const TTBase *fused_producer = nullptr;  //!< the TT whose tasks run the tasks of this TT inline, if any
+    std::size_t batch_size = 1;              //!< max number of tasks executed by one invocation of op_batch
+    bool relocatable = false;                //!< ready tasks may be delegated to other ranks with their inputs
 
     // Default copy/move/assign all OK
     static uint64_t next_instance_id() {
@@ -166,6 +179,66 @@ namespace ttg {
       return value;
     }
 
+    /// Sets static dispatch of sends on for all TTs made executable afterwards and returns previous setting.
+    /// With static dispatch each output terminal binds the raw set_arg entry points of its successors when its TT is
+    /// made executable, so that sends bypass the runtime terminal type switch and the \c std::function callbacks.
+    /// Default is false.
+    static bool set_static_dispatch(bool value) {
+      std::swap(ttg::detail::tt_base_static_dispatch_accessor(), value);
+      return value;
+    }
+
+    /// @return true if static dispatch of sends is on
+    static bool is_static_dispatch() { return ttg::detail::tt_base_static_dispatch_accessor(); }
+
+    /// Sets fusion of linear chains on for all graphs made executable afterwards by ttg::make_graph_executable and
+    /// returns previous setting. With fusion a TT whose only input is fed by an output terminal that has no other
+    /// successors runs its tasks inline in the tasks of the producer, if the backend supports it (see is_fusable()).
+    /// A task runs inline only if it is the only task of that TT sent by the producer task, so that fan-outs keep
+    /// running concurrently. Default is false.
+    static bool set_fusion(bool value) {
+      std::swap(ttg::detail::tt_base_fusion_accessor(), value);
+      return value;
+    }
+
+    /// @return true if fusion of linear chains is on
+    static bool is_fusion() { return ttg::detail::tt_base_fusion_accessor(); }
+
+    /// @return true if the backend can run the tasks of this TT inline in the tasks of its producer
+    virtual bool is_fusable() const { return false; }
+
+    /// Makes the tasks of this TT run inline in the tasks of \p producer (or in separate tasks if \p producer is null).
+    /// This is used by ttg::make_graph_executable.
+    void set_fused_producer(const TTBase *producer) { fused_producer = producer; }
+
+    /// @return the TT whose tasks run the tasks of this TT inline, or nullptr if this TT is not fused
+    const TTBase *get_fused_producer() const { return fused_producer; }
+
+    /// Sets the maximum number of ready tasks of this TT that the backend collects into a batch executed by a single
+    /// invocation of `op_batch(keys, args, outs)`. Has no effect unless the TT implements `op_batch`
+    /// (e.g., it was made by ttg::make_tt from a callable taking spans of keys and input tuples); otherwise each
+    /// task is executed separately. Several batches of the same TT may execute concurrently.
+    /// @note only the MADNESS backend supports batching, the PaRSEC backend rejects batch sizes greater than 1
+    ///       when the TT is made executable
+    /// @param[in] n the maximum batch size, must be positive; the default (1) disables batching
+    void set_batch_size(std::size_t n) {
+      if (n == 0) throw(name + ":TTBase: batch size must be positive");
+      batch_size = n;
+    }
+
+    /// @return the maximum number of tasks executed by one invocation of `op_batch`
+    std::size_t get_batch_size() const { return batch_size; }
+
+    /// Declares the inputs of the tasks of this TT relocatable, opting the TT into dynamic load balancing if the
+    /// backend supports it (only MADNESS does): a rank that holds many more ready tasks than other ranks may then
+    /// delegate ready tasks of this TT, together with their inputs, to an underloaded rank. The outputs of a delegated
+    /// task are sent to the successors according to their keymaps, as usual, hence the task must not depend on state
+    /// local to the rank given by the keymap. The input values must be serializable. Default is false.
+    void set_relocatable(bool value) { relocatable = value; }
+
+    /// @return true if the ready tasks of this TT may be executed by ranks other than the one given by the keymap
+    bool is_relocatable() const { return relocatable; }
+
     /// Sets trace for just this instance to value and returns previous setting
     /// This has no effect unless `trace_enabled()==true`
     bool set_trace_instance(bool value) {
@@ -281,7 +354,11 @@ namespace ttg {
   } while (0);
   };
 
-  inline void TTBase::make_executable() { executable = true; }
+  inline void TTBase::make_executable() {
+    for (auto &&out : outputs)
+      if (out) out->make_executable();
+    executable = true;
+  }
 
 }  // namespace ttg
 
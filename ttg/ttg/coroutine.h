@@ -0,0 +1,236 @@
+#ifndef TTG_COROUTINE_H
+#define TTG_COROUTINE_H
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "ttg/util/print.h"
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define TTG_HAVE_COROUTINE 1
+#endif
+
+namespace ttg {
+
+  namespace detail {
+
+    /// Interface through which the suspended coroutine bodies of TTs (see ttg::task) are resumed by the backend.
+    /// The backend installs the scheduler of a TT (see coroutine_scheduler_accessor()) while it executes the TT's body.
+    class coroutine_scheduler {
+     public:
+      virtual ~coroutine_scheduler() = default;
+
+      /// Called by a body about to suspend to await a value; the backend must consider the body's task as not
+      /// complete (e.g. fences must not complete) until it has been resumed.
+      /// @return a token to be passed to resume()
+      virtual void *suspend() = 0;
+
+      /// Submits a task that will call \p resume_fn to resume the body suspended by the call to suspend() that
+      /// returned \p token ; may be called by any thread.
+      virtual void resume(void *token, std::function<void()> resume_fn) = 0;
+    };
+
+    /// @return reference to the scheduler of the TT whose body is executed by this thread, if any
+    inline coroutine_scheduler *&coroutine_scheduler_accessor() {
+      static thread_local coroutine_scheduler *scheduler = nullptr;
+      return scheduler;
+    }
+
+    /// @return reference to the exception that ended the coroutine body last completed by this thread, if any; set by
+    /// the body (see ttg::task), and rethrown by the caller that started or resumed it (see
+    /// rethrow_coroutine_exception())
+    inline std::exception_ptr &coroutine_exception_accessor() {
+      static thread_local std::exception_ptr exception = nullptr;
+      return exception;
+    }
+
+    /// rethrows the exception that ended the coroutine body just started or resumed by this thread, if any
+    inline void rethrow_coroutine_exception() {
+      if (auto exception = std::exchange(coroutine_exception_accessor(), nullptr)) std::rethrow_exception(exception);
+    }
+
+    /// true if \c T is ttg::task, i.e. the return type of coroutine bodies
+    template <typename T>
+    inline constexpr bool is_task_v = false;
+
+  }  // namespace detail
+
+#ifdef TTG_HAVE_COROUTINE
+
+  /// The return type of TT bodies implemented as C++20 coroutines.
+
+  /// A body returning `ttg::task<>` can `co_await` values that are not yet available (see ttg::async_value) without
+  /// blocking the worker thread: the body is suspended, and once the value is available it is resumed by a task
+  /// submitted by the backend. The body's frame is destroyed when the body completes, the task object itself is
+  /// only a handle that is discarded by the TT. Since the body refers to its arguments after it resumes, the TT
+  /// keeps them alive until the body completes (see keep_alive()).
+  /// @code
+  ///   auto tt = ttg::make_tt([&](const int& key, int&& value, std::tuple<ttg::Out<int, int>>& outs) -> ttg::task<> {
+  ///       auto other = co_await fetch(key);  // fetch returns a ttg::async_value<int>
+  ///       ttg::send<0>(key, value + other, outs);
+  ///     }, ttg::edges(in), ttg::edges(out));
+  /// @endcode
+  /// Only the MADNESS backend supports coroutine bodies; there, the elements of pull terminals can be awaited via
+  /// `TT::pull<i>(key)`.
+  /// @tparam ResultT must be void; TT bodies do not return values
+  template <typename ResultT = void>
+  class task {
+    static_assert(std::is_void_v<ResultT>, "ttg::task<ResultT>: TT bodies cannot return values");
+
+    // owned by the frame and the task object, holds the objects kept alive for the frame
+    using keep_alive_slot = std::shared_ptr<std::shared_ptr<void>>;
+    keep_alive_slot slot_;
+
+    explicit task(keep_alive_slot slot) : slot_(std::move(slot)) {}
+
+   public:
+    class promise_type {
+     public:
+      promise_type() : scheduler_(detail::coroutine_scheduler_accessor()) {
+        if (!scheduler_) {
+          ttg::print_error("ttg::task: coroutine bodies can only be executed by a TT whose backend supports them");
+          throw std::logic_error("ttg::task created outside of a TT body");
+        }
+      }
+
+      task get_return_object() { return task{slot_}; }
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      // the frame is destroyed as soon as the body completes
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      // propagate to the task that started or resumed the body, like the exceptions thrown by an ordinary body;
+      // rethrowing here would leave the frame suspended at its final suspend point, and leak it, hence the exception
+      // is rethrown by the caller once the frame is destroyed (see detail::rethrow_coroutine_exception())
+      void unhandled_exception() noexcept { detail::coroutine_exception_accessor() = std::current_exception(); }
+
+      detail::coroutine_scheduler *scheduler() const { return scheduler_; }
+
+     private:
+      detail::coroutine_scheduler *scheduler_;
+      keep_alive_slot slot_ = std::make_shared<std::shared_ptr<void>>();
+    };
+
+    /// keeps \p obj alive until the body completes (or releases it immediately if the body has completed already);
+    /// called by the TT as soon as the body returns, hence rethrows the exception that ended the body, if any
+    void keep_alive(std::shared_ptr<void> obj) && {
+      *slot_ = std::move(obj);
+      detail::rethrow_coroutine_exception();
+    }
+  };
+
+  namespace detail {
+    template <typename ResultT>
+    inline constexpr bool is_task_v<task<ResultT>> = true;
+  }  // namespace detail
+
+  /// A value that will become available later, e.g. data fetched from a remote rank or the result of a reduction
+  /// computed by other tasks. Copies refer to the same value, which is set once by set_value() and can be awaited
+  /// (`co_await`) once by a TT body returning ttg::task.
+  template <typename T>
+  class async_value {
+    struct state {
+      std::mutex mtx;
+      std::optional<T> value;
+      void *token = nullptr;  // token of the suspended awaiting body, if any
+      std::coroutine_handle<> waiter;
+      detail::coroutine_scheduler *scheduler = nullptr;
+    };
+    std::shared_ptr<state> state_ = std::make_shared<state>();
+
+   public:
+    async_value() = default;
+
+    /// @return true if the value has been set
+    bool ready() const {
+      std::lock_guard<std::mutex> lock(state_->mtx);
+      return state_->value.has_value();
+    }
+
+    /// sets the value and resumes the body awaiting it, if any
+    template <typename Value>
+    void set_value(Value &&value) {
+      std::coroutine_handle<> waiter;
+      void *token;
+      detail::coroutine_scheduler *scheduler;
+      {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        if (state_->value) {
+          ttg::print_error("ttg::async_value::set_value: value has already been set");
+          throw std::logic_error("ttg::async_value::set_value called twice");
+        }
+        state_->value.emplace(std::forward<Value>(value));
+        waiter = std::exchange(state_->waiter, nullptr);
+        token = state_->token;
+        scheduler = state_->scheduler;
+      }
+      if (waiter) scheduler->resume(token, [waiter]() { resume(waiter); });
+    }
+
+    class awaiter {
+      std::shared_ptr<state> state_;
+
+     public:
+      explicit awaiter(std::shared_ptr<state> s) : state_(std::move(s)) {}
+
+      bool await_ready() const {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        return state_->value.has_value();
+      }
+
+      template <typename Promise>
+      bool await_suspend(std::coroutine_handle<Promise> h) {
+        static_assert(std::is_same_v<Promise, typename task<>::promise_type>,
+                      "ttg::async_value can only be awaited by TT bodies returning ttg::task<>");
+        // N.B. once the body has been resumed this awaiter may be gone, hence only use locals past that point
+        auto s = state_;
+        {
+          std::lock_guard<std::mutex> lock(s->mtx);
+          if (s->waiter) {
+            ttg::print_error("ttg::async_value: value is already awaited by another body");
+            throw std::logic_error("ttg::async_value awaited twice");
+          }
+        }
+        auto *scheduler = h.promise().scheduler();
+        void *token = scheduler->suspend();
+        {
+          std::lock_guard<std::mutex> lock(s->mtx);
+          if (!s->value) {
+            s->token = token;
+            s->waiter = h;
+            s->scheduler = scheduler;
+            return true;
+          }
+        }
+        // the value arrived after await_ready, resume in a new task anyway since the suspension was accounted for
+        scheduler->resume(token, [h]() { resume(h); });
+        return true;
+      }
+
+      T await_resume() {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        return std::move(*state_->value);
+      }
+    };
+
+    awaiter operator co_await() const { return awaiter{state_}; }
+
+   private:
+    /// resumes the body suspended at @p h , rethrows the exception that ended it, if any
+    static void resume(std::coroutine_handle<> h) {
+      h.resume();
+      detail::rethrow_coroutine_exception();
+    }
+  };
+
+#endif  // TTG_HAVE_COROUTINE
+
+}  // namespace ttg
+
+#endif  // TTG_COROUTINE_H
@@ -3,6 +3,9 @@
 
 #include "ttg/fwd.h"
 
+#include <map>
+#include <vector>
+
 #include "ttg/edge.h"
 #include "ttg/impl_selector.h"
 #include "ttg/terminal.h"
@@ -25,6 +28,45 @@ namespace ttg {
       }
     };
 
+    /// broadcasts \p value to the output terminals \p terminals , the \c j -th terminal receives the keys in the
+    /// \c j -th element of \p keylists ; only the last terminal may take ownership of the value
+    template <std::size_t KeyId = 0, typename... RangesT, typename Value, typename... OutsT>
+    inline void broadcast_each(const std::tuple<RangesT...> &keylists, Value &&value,
+                               const std::tuple<OutsT *...> &terminals) {
+      auto *terminal_ptr = std::get<KeyId>(terminals);
+      const auto &keylist = std::get<KeyId>(keylists);
+      constexpr bool is_last = (KeyId + 1 == sizeof...(OutsT));
+      bool nonempty = true;
+      if constexpr (ttg::meta::is_iterable_v<std::tuple_element_t<KeyId, std::tuple<RangesT...>>>) {
+        nonempty = std::begin(keylist) != std::end(keylist);
+      }
+      if (nonempty) {
+        if constexpr (is_last)
+          terminal_ptr->broadcast(keylist, std::forward<Value>(value));
+        else
+          terminal_ptr->broadcast(keylist, static_cast<const std::remove_reference_t<Value> &>(value));
+      }
+      if constexpr (!is_last) {
+        broadcast_each<KeyId + 1>(keylists, std::forward<Value>(value), terminals);
+      }
+    }
+
+    /** Hook allowing implementations to fuse the broadcast of one value to several output terminals, e.g. to
+     * serialize the value once per destination rank rather than once per terminal. operator() receives the tuple of
+     * key lists, the value, and the tuple of pointers to the corresponding output terminals. By default, the value is
+     * broadcast to each terminal in turn (see broadcast_each).
+     * Implementations may provide specializations using the ttg::Runtime tag. Only the MADNESS backend does so;
+     * the PaRSEC backend uses the default, i.e. each remote rank receives one copy of the value per terminal.
+     */
+    template <ttg::Runtime Runtime>
+    struct multi_broadcast_handler {
+      template <typename... RangesT, typename Value, typename... OutsT>
+      void operator()(const std::tuple<RangesT...> &keylists, Value &&value,
+                      const std::tuple<OutsT *...> &terminals) const {
+        broadcast_each(keylists, std::forward<Value>(value), terminals);
+      }
+    };
+
     template <typename keyT, typename valueT>
     inline auto get_out_terminal(size_t i, const char *func) {
 #ifndef NDEBUG
@@ -69,17 +111,55 @@ namespace ttg {
       return terminal_ptr;
     }
 
+    /// Fuses the linear chains of \p tts : a fusable TT (see TTBase::is_fusable) whose only input is fed by a single
+    /// output terminal of another TT, which in turn has no other successors, runs its tasks inline in the tasks of
+    /// that TT that send it a single task (see TTBase::set_fused_producer). Has no effect on the other TTs.
+    inline void fuse_linear_chains(const std::vector<TTBase *> &tts) {
+      for (auto *tt : tts) tt->set_fused_producer(nullptr);
+      if (!TTBase::is_fusion()) return;
+      // input terminals fed by an output terminal that has no other successors
+      std::map<const TerminalBase *, const TerminalBase *> sole_producer;
+      for (auto *tt : tts) {
+        for (auto *out : tt->get_outputs()) {
+          if (out && !out->is_pull_terminal && out->get_connections().size() == 1)
+            sole_producer[out->get_connections()[0]] = out;
+        }
+      }
+      for (auto *tt : tts) {
+        if (tt->is_ttg() || !tt->is_fusable() || tt->get_inputs().size() != 1) continue;
+        const auto *in = tt->get_inputs()[0];
+        if (!in || in->is_pull_terminal || in->get_num_push_predecessors() != 1) continue;
+        auto it = sole_producer.find(in);
+        if (it == sole_producer.end()) continue;
+        const auto *producer = it->second->get_tt();
+        if (producer != tt) tt->set_fused_producer(producer);
+      }
+      // a cycle of fused TTs has no task to run it, so unfuse one TT in each cycle
+      for (auto *tt : tts) {
+        const TTBase *producer = tt->get_fused_producer();
+        for (std::size_t n = 0; producer != nullptr && producer != tt && n != tts.size(); ++n)
+          producer = producer->get_fused_producer();
+        if (producer == tt) tt->set_fused_producer(nullptr);
+      }
+    }
+
   }  // namespace detail
 
   /// \brief Make the TTG \c tts executable.
-  /// Applies \sa make_executable method to every op in the graph
+  /// Applies \sa make_executable method to every op in the graph, then fuses its linear chains of TTs if fusion was
+  /// turned on (see TTBase::set_fusion)
   /// \param tts The task graph to make executable.
   /// \return true if there are no dangling out terminals
   template <typename... TTBasePtrs>
   inline std::enable_if_t<(std::is_convertible_v<decltype(*(std::declval<TTBasePtrs>())), TTBase &> && ...), bool>
   make_graph_executable(TTBasePtrs &&...tts) {
-    return ttg::make_traverse([](auto &&x) { std::forward<decltype(x)>(x)->make_executable(); })(
-        std::forward<TTBasePtrs>(tts)...);
+    std::vector<TTBase *> graph;
+    bool status = ttg::make_traverse([&graph](auto &&x) {
+      std::forward<decltype(x)>(x)->make_executable();
+      graph.push_back(x);
+    })(std::forward<TTBasePtrs>(tts)...);
+    detail::fuse_linear_chains(graph);
+    return status;
   }
 
   /// \brief Connect output terminal to successor input terminal
@@ -323,38 +403,23 @@ namespace ttg {
   }
 
   namespace detail {
-    template <size_t KeyId, size_t i, size_t... I, typename... RangesT, typename valueT, typename... out_keysT,
-              typename... out_valuesT>
-    inline void broadcast(const std::tuple<RangesT...> &keylists, valueT &&value,
-                          std::tuple<ttg::Out<out_keysT, out_valuesT>...> &t) {
-      if constexpr (ttg::meta::is_iterable_v<std::tuple_element_t<KeyId, std::tuple<RangesT...>>>) {
-        if (std::distance(std::begin(std::get<KeyId>(keylists)), std::end(std::get<KeyId>(keylists))) > 0) {
-          std::get<i>(t).broadcast(std::get<KeyId>(keylists), value);
-        }
+    /// @return the pointer to the \c i -th output terminal of this task, typed for broadcasting to the keys in
+    ///         \c rangeT
+    template <size_t i, typename rangeT, typename valueT>
+    inline auto get_out_terminal_for(const char *func) {
+      if constexpr (ttg::meta::is_iterable_v<rangeT>) {
+        using key_t = decltype(*std::begin(std::declval<const rangeT &>()));
+        return detail::get_out_terminal<key_t, valueT>(i, func);
       } else {
-        std::get<i>(t).broadcast(std::get<KeyId>(keylists), value);
-      }
-      if constexpr (sizeof...(I) > 0) {
-        detail::broadcast<KeyId + 1, I...>(keylists, value, t);
+        return detail::get_out_terminal<rangeT, valueT>(i, func);
       }
     }
 
-    template <size_t KeyId, size_t i, size_t... I, typename... RangesT, typename valueT>
-    inline void broadcast(const std::tuple<RangesT...> &keylists, valueT &&value) {
-      if constexpr (ttg::meta::is_iterable_v<std::tuple_element_t<KeyId, std::tuple<RangesT...>>>) {
-        if (std::distance(std::begin(std::get<KeyId>(keylists)), std::end(std::get<KeyId>(keylists))) > 0) {
-          using key_t = decltype(*std::begin(std::get<KeyId>(keylists)));
-          auto *terminal_ptr = detail::get_out_terminal<key_t, valueT>(i, "ttg::broadcast(keylists, value)");
-          terminal_ptr->broadcast(std::get<KeyId>(keylists), value);
-        }
-      } else {
-        using key_t = decltype(std::get<KeyId>(keylists));
-        auto *terminal_ptr = detail::get_out_terminal<key_t, valueT>(i, "ttg::broadcast(keylists, value)");
-        terminal_ptr->broadcast(std::get<KeyId>(keylists), value);
-      }
-      if constexpr (sizeof...(I) > 0) {
-        detail::broadcast<KeyId + 1, I...>(keylists, value);
-      }
+    /// @return the tuple of pointers to the output terminals \c I... of this task, typed for broadcasting to the
+    ///         corresponding key lists
+    template <typename valueT, size_t... I, typename... RangesT>
+    inline auto get_out_terminals_for(const std::tuple<RangesT...> &keylists, const char *func) {
+      return std::make_tuple(detail::get_out_terminal_for<I, RangesT, valueT>(func)...);
     }
 
     template <size_t KeyId, size_t i, size_t... I, typename... RangesT, typename... out_keysT, typename... out_valuesT>
@@ -419,7 +484,9 @@ namespace ttg {
     static_assert(sizeof...(I) + 1 == sizeof...(RangesT),
                   "Number of selected output terminals must match the number of keylists!");
     detail::value_copy_handler<Runtime> copy_handler;
-    detail::broadcast<0, i, I...>(keylists, copy_handler(std::forward<valueT>(value)), t);
+    detail::multi_broadcast_handler<Runtime> broadcast_handler;
+    broadcast_handler(keylists, copy_handler(std::forward<valueT>(value)),
+                      std::make_tuple(&std::get<i>(t), &std::get<I>(t)...));
   }
 
   template <size_t i, size_t... I, typename... RangesT, typename valueT, ttg::Runtime Runtime = ttg::ttg_runtime>
@@ -427,7 +494,9 @@ namespace ttg {
     static_assert(sizeof...(I) + 1 == sizeof...(RangesT),
                   "Number of selected output terminals must match the number of keylists!");
     detail::value_copy_handler<Runtime> copy_handler;
-    detail::broadcast<0, i, I...>(keylists, copy_handler(std::forward<valueT>(value)));
+    detail::multi_broadcast_handler<Runtime> broadcast_handler;
+    broadcast_handler(keylists, copy_handler(std::forward<valueT>(value)),
+                      detail::get_out_terminals_for<valueT, i, I...>(keylists, "ttg::broadcast(keylists, value)"));
   }
 
   template <size_t i, typename rangeT, typename... out_keysT, typename... out_valuesT,
@@ -12,6 +12,7 @@
 #include "../../ttg.h"
 #include "ttg/base/keymap.h"
 #include "ttg/base/tt.h"
+#include "ttg/coroutine.h"
 #include "ttg/func.h"
 #include "ttg/runtimes.h"
 #include "ttg/tt.h"
@@ -21,18 +22,30 @@
 #include "ttg/util/macro.h"
 #include "ttg/util/meta.h"
 #include "ttg/util/meta/callable.h"
+#include "ttg/util/mpi_collectives.h"
 #include "ttg/util/void.h"
 #include "ttg/world.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <madness/world/MADworld.h>
@@ -61,6 +74,263 @@ namespace ttg_madness {
   };
 #endif
 
+  namespace detail {
+
+    /// Receives the values that ttg::broadcast sends to several output terminals of a TT at once (see
+    /// ttg::detail::multi_broadcast_handler) and delivers them to the successors on this rank.
+    /// The relay is constructed collectively with the world, hence it can receive messages before the source TT
+    /// exists on this rank; such messages are held until the TT is made executable.
+    /// Successors are identified by the instance id of their TT and the index of their input terminal, hence the
+    /// successors of an output terminal may be connected in a different order on each rank.
+    class broadcast_relay : public ::madness::WorldObject<broadcast_relay> {
+      using worldobjT = ::madness::WorldObject<broadcast_relay>;
+
+     public:
+      /// identifies an input terminal on every rank: {instance id of its TT, index of the terminal}
+      using successor_id_t = std::pair<std::int64_t, std::size_t>;
+      /// the keys of one successor of an output terminal: {successor, keys}
+      template <typename Key>
+      using successor_keys_t = std::pair<successor_id_t, std::vector<Key>>;
+      /// the keys of the successors of one output terminal: {output terminal index, keys of each successor}
+      template <typename Key>
+      using terminal_keys_t = std::pair<std::size_t, std::vector<successor_keys_t<Key>>>;
+
+      broadcast_relay(::madness::World &world) : worldobjT(world) { this->process_pending(); }
+
+      /// makes \p tt the target of broadcasts addressed to its instance id, and runs the deliveries held for it
+      void register_tt(ttg::TTBase *tt) {
+        std::vector<std::function<void(ttg::TTBase *)>> deliveries;
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          tts[tt->get_instance_id()] = tt;
+          auto range = pending.equal_range(tt->get_instance_id());
+          for (auto it = range.first; it != range.second; ++it) deliveries.push_back(std::move(it->second));
+          pending.erase(range.first, range.second);
+        }
+        for (auto &&delivery : deliveries) delivery(tt);
+      }
+
+      void deregister_tt(ttg::TTBase *tt) {
+        std::lock_guard<std::mutex> lock(mtx);
+        tts.erase(tt->get_instance_id());
+      }
+
+      /// @return the id of input terminal \p in
+      static successor_id_t successor_id(const ttg::TerminalBase *in) {
+        return {in->get_tt()->get_instance_id(), in->get_index()};
+      }
+
+      /// delivers \p value to the keys in \p table of the output terminals of the TT with instance id \p tt_id ;
+      /// the value received with the message is moved into the last consuming successor
+      template <typename Value, typename... Keys>
+      void deliver(std::int64_t tt_id, const std::tuple<terminal_keys_t<Keys>...> &table, Value value) {
+        ttg::TTBase *tt = nullptr;
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          auto it = tts.find(tt_id);
+          if (it != tts.end()) {
+            tt = it->second;
+          } else {
+            pending.emplace(tt_id, [table, value = std::move(value)](ttg::TTBase *tt) mutable {
+              deliver_table(tt, table, std::move(value));
+            });
+          }
+        }
+        if (tt != nullptr) deliver_table(tt, table, std::move(value));
+      }
+
+      /// delivers \p value to the keys in \p table of the output terminals of \p tt ; if \p value is a nonconst
+      /// rvalue it is moved into the last consuming successor
+      template <typename Value, typename... Keys>
+      static void deliver_table(ttg::TTBase *tt, const std::tuple<terminal_keys_t<Keys>...> &table, Value &&value) {
+        using value_t = std::decay_t<Value>;
+        constexpr bool movable = !std::is_reference_v<Value> && !std::is_const_v<Value>;
+        std::size_t nconsumers = 0;
+        if constexpr (movable) {
+          for_each_successor(tt, table, [&](ttg::TerminalBase *successor, const auto &keys) {
+            if (successor->get_type() == ttg::TerminalBase::Type::Consume) ++nconsumers;
+          });
+        }
+        // copies first, then move into the last consumer
+        std::size_t consumer = 0;
+        for_each_successor(tt, table, [&](ttg::TerminalBase *successor, const auto &keys) {
+          using key_t = typename std::decay_t<decltype(keys)>::value_type;
+          if (successor->get_type() == ttg::TerminalBase::Type::Read) {
+            static_cast<ttg::In<key_t, const value_t> *>(successor)->broadcast(keys, std::as_const(value));
+          } else if (++consumer != nconsumers) {
+            static_cast<ttg::In<key_t, value_t> *>(successor)->broadcast(keys, std::as_const(value));
+          }
+        });
+        if constexpr (movable) {
+          consumer = 0;
+          for_each_successor(tt, table, [&](ttg::TerminalBase *successor, const auto &keys) {
+            using key_t = typename std::decay_t<decltype(keys)>::value_type;
+            if (successor->get_type() == ttg::TerminalBase::Type::Consume && ++consumer == nconsumers) {
+              static_cast<ttg::In<key_t, value_t> *>(successor)->broadcast(keys, std::move(value));
+            }
+          });
+        }
+      }
+
+     private:
+      std::mutex mtx;
+      std::unordered_map<std::int64_t, ttg::TTBase *> tts;
+      std::unordered_multimap<std::int64_t, std::function<void(ttg::TTBase *)>> pending;
+
+      template <typename F, typename... Keys>
+      static void for_each_successor(ttg::TTBase *tt, const std::tuple<terminal_keys_t<Keys>...> &table, F &&f) {
+        auto visit = [&](const auto &terminal) {
+          const auto &successors = tt->out(terminal.first)->get_connections();
+          for (auto &&successor_keys : terminal.second) {
+            auto it = std::find_if(successors.begin(), successors.end(), [&](const ttg::TerminalBase *successor) {
+              return successor_id(successor) == successor_keys.first;
+            });
+            if (it == successors.end()) {
+              ttg::print_error(ttg::default_execution_context().rank(), ":", tt->get_name(), " : output terminal ",
+                               terminal.first, " is not connected to input terminal ", successor_keys.first.second,
+                               " of the TT with instance id ", successor_keys.first.first);
+              throw std::runtime_error("ttg::broadcast: successor not found");
+            }
+            f(*it, successor_keys.second);
+          }
+        };
+        std::apply([&](const auto &...terminal) { (visit(terminal), ...); }, table);
+      }
+    };
+
+    /// Dynamic load balancing of the tasks of relocatable TTs (see ttg::TTBase::set_relocatable()).
+    /// Each rank counts its ready tasks of relocatable TTs waiting to be executed, i.e. its load (the tasks of other
+    /// TTs are not accounted for, so that they do not pay for it). The load is piggybacked on the messages that
+    /// delegate tasks, and reported to the O(log P) peers at distance 1, 2, 4, ... from this rank (see peers()) when a
+    /// relocatable TT is made executable, then whenever it dropped to zero or changed by more than half the threshold
+    /// (or by more than a quarter) since the last report, at most once per `TTG_MIGRATION_REPORT_INTERVAL`
+    /// microseconds (default 1000). A rank whose load exceeds the load of the least loaded rank it knows of by more
+    /// than the threshold delegates its ready tasks of relocatable TTs to that rank; ranks that have not reported
+    /// their load yet are not delegated to. The threshold is given by the environment variable
+    /// `TTG_MIGRATION_THRESHOLD` (default 16).
+    class load_balancer : public ::madness::WorldObject<load_balancer> {
+      using worldobjT = ::madness::WorldObject<load_balancer>;
+
+      /// the load of the ranks that have not reported it yet
+      static constexpr long unknown_load = std::numeric_limits<long>::max();
+
+     public:
+      load_balancer(::madness::World &world) : worldobjT(world), loads(world.size(), unknown_load) {
+        if (const char *threshold_cstr = std::getenv("TTG_MIGRATION_THRESHOLD")) {
+          threshold = std::atol(threshold_cstr);
+          if (threshold < 1) {
+            ttg::print_error("ttg: invalid value of environment variable TTG_MIGRATION_THRESHOLD: ", threshold_cstr);
+            throw std::runtime_error("ttg: invalid value of environment variable TTG_MIGRATION_THRESHOLD");
+          }
+        }
+        if (const char *interval_cstr = std::getenv("TTG_MIGRATION_REPORT_INTERVAL")) {
+          const long interval = std::atol(interval_cstr);
+          if (interval < 0) {
+            ttg::print_error("ttg: invalid value of environment variable TTG_MIGRATION_REPORT_INTERVAL: ",
+                             interval_cstr);
+            throw std::runtime_error("ttg: invalid value of environment variable TTG_MIGRATION_REPORT_INTERVAL");
+          }
+          report_interval = std::chrono::microseconds(interval);
+        }
+        this->process_pending();
+      }
+
+      /// turns on load reporting and reports the current load; called when a relocatable TT is made executable
+      void enable() {
+        if (enabled.exchange(true, std::memory_order_relaxed)) return;
+        long my_load;
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          my_load = last_reported = get_load();
+          last_report_time = std::chrono::steady_clock::now();
+        }
+        report_peers(my_load);
+      }
+
+      /// accounts for a ready task queued on this rank, if load reporting is enabled
+      /// @return true if the task was accounted for, then task_started() must be called when it starts executing
+      bool task_queued() {
+        if (!enabled.load(std::memory_order_relaxed)) return false;
+        changed(load.fetch_add(1, std::memory_order_relaxed) + 1);
+        return true;
+      }
+
+      /// accounts for a queued task that started executing
+      void task_started() { changed(load.fetch_sub(1, std::memory_order_relaxed) - 1); }
+
+      /// @return the number of ready tasks waiting on this rank
+      long get_load() const { return load.load(std::memory_order_relaxed); }
+
+      /// @return the rank to delegate a ready task to, or -1 if it should be executed on this rank
+      int choose_target() {
+        const long my_load = get_load();
+        if (my_load <= threshold) return -1;
+        const int me = this->get_world().rank();
+        std::lock_guard<std::mutex> lock(mtx);
+        int target = -1;
+        for (int r = 0; r != static_cast<int>(loads.size()); ++r) {
+          if (r != me && (target < 0 || loads[r] < loads[target])) target = r;
+        }
+        if (target < 0 || loads[target] == unknown_load || my_load - loads[target] <= threshold) return -1;
+        // assume the target is busier until it reports, so that the tasks are spread over the underloaded ranks
+        ++loads[target];
+        return target;
+      }
+
+      /// records the load of \p rank piggybacked on a message from it
+      void update(int rank, long rank_load) {
+        std::lock_guard<std::mutex> lock(mtx);
+        loads[rank] = rank_load;
+      }
+
+     private:
+      std::atomic<long> load = 0;
+      std::atomic<bool> enabled = false;
+      long threshold = 16;
+      std::mutex mtx;
+      std::vector<long> loads;  // the last known loads of all ranks
+      long last_reported = 0;
+      std::chrono::steady_clock::time_point last_report_time;
+      std::chrono::microseconds report_interval{1000};
+
+      /// receives a load report
+      void report(int rank, long rank_load) { update(rank, rank_load); }
+
+      /// reports the new load \p my_load of this rank, if it changed significantly since the last report and the
+      /// last report is older than the report interval; becoming idle is reported regardless of the interval
+      void changed(long my_load) {
+        if (!enabled.load(std::memory_order_relaxed)) return;
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          const bool idle = my_load == 0 && last_reported != 0;
+          if (!idle && std::abs(my_load - last_reported) <= std::max(threshold / 2, last_reported / 4)) return;
+          const auto now = std::chrono::steady_clock::now();
+          if (!idle && now - last_report_time < report_interval) return;
+          last_reported = my_load;
+          last_report_time = now;
+        }
+        report_peers(my_load);
+      }
+
+      /// @return the ranks this rank reports its load to, at distance 1, 2, 4, ... (modulo the number of ranks);
+      ///         every rank thus hears from O(log P) ranks, of which it can pick the least loaded
+      std::vector<int> peers() const {
+        const auto &world = this->get_world();
+        const int me = world.rank(), nranks = world.size();
+        std::vector<int> result;
+        for (int distance = 1; distance < nranks; distance *= 2) result.push_back((me + distance) % nranks);
+        return result;
+      }
+
+      /// sends the load \p my_load of this rank to its peers
+      void report_peers(long my_load) {
+        const int me = this->get_world().rank();
+        for (const int r : peers()) worldobjT::send(r, &load_balancer::report, me, my_load);
+      }
+    };
+
+  }  // namespace detail
+
   class WorldImpl final : public ttg::base::WorldImplBase {
    private:
     ::madness::World &m_impl;
@@ -68,11 +338,33 @@ namespace ttg_madness {
 
     ttg::Edge<> m_ctl_edge;
 
+    std::unique_ptr<detail::broadcast_relay> m_broadcast_relay;
+    std::unique_ptr<detail::load_balancer> m_load_balancer;
+
+    MPI_Comm m_collectives_comm = MPI_COMM_NULL;  // duplicate of the communicator of m_impl, see collectives_comm()
+
+    std::mutex m_fence_hooks_mtx;
+    std::map<const void *, std::function<void()>> m_fence_hooks;
+
    public:
-    WorldImpl(::madness::World &world) : WorldImplBase(world.size(), world.rank()), m_impl(world) {}
+    WorldImpl(::madness::World &world)
+        : WorldImplBase(world.size(), world.rank())
+        , m_impl(world)
+        , m_broadcast_relay(std::make_unique<detail::broadcast_relay>(world))
+        , m_load_balancer(std::make_unique<detail::load_balancer>(world)) {
+      ttg::detail::register_world(*this);
+      dup_collectives_comm();
+    }
 
     WorldImpl(const SafeMPI::Intracomm &comm)
-        : WorldImplBase(comm.Get_size(), comm.Get_rank()), m_impl(*new ::madness::World(comm)), m_allocated(true) {}
+        : WorldImplBase(comm.Get_size(), comm.Get_rank())
+        , m_impl(*new ::madness::World(comm))
+        , m_allocated(true)
+        , m_broadcast_relay(std::make_unique<detail::broadcast_relay>(m_impl))
+        , m_load_balancer(std::make_unique<detail::load_balancer>(m_impl)) {
+      ttg::detail::register_world(*this);
+      dup_collectives_comm();
+    }
 
     /* Deleted copy ctor */
     WorldImpl(const WorldImpl &other) = delete;
@@ -88,16 +380,51 @@ namespace ttg_madness {
     /* Deleted move assignment */
     WorldImpl &operator=(WorldImpl &&other) = delete;
 
-    virtual void fence_impl(void) override { m_impl.gop.fence(); }
+    virtual void fence_impl(void) override {
+      m_impl.gop.fence();
+      std::vector<std::function<void()>> hooks;
+      {
+        std::lock_guard<std::mutex> lock(m_fence_hooks_mtx);
+        for (auto &&[owner, hook] : m_fence_hooks) hooks.push_back(hook);
+      }
+      for (auto &&hook : hooks) hook();
+    }
+
+    /// registers \p hook to be called after every fence of this world, when no tasks are in flight, until it is
+    /// removed by remove_fence_hook(owner); replaces the hook registered by \p owner , if any
+    void add_fence_hook(const void *owner, std::function<void()> hook) {
+      std::lock_guard<std::mutex> lock(m_fence_hooks_mtx);
+      m_fence_hooks[owner] = std::move(hook);
+    }
+
+    void remove_fence_hook(const void *owner) {
+      std::lock_guard<std::mutex> lock(m_fence_hooks_mtx);
+      m_fence_hooks.erase(owner);
+    }
 
     ttg::Edge<> &ctl_edge() { return m_ctl_edge; }
 
     const ttg::Edge<> &ctl_edge() const { return m_ctl_edge; }
 
+    /// @return the relay of multi-terminal broadcasts, or nullptr if this world was destroyed
+    detail::broadcast_relay *broadcast_relay() { return m_broadcast_relay.get(); }
+
+    /// @return the load balancer of relocatable TTs, or nullptr if this world was destroyed
+    detail::load_balancer *load_balancer() { return m_load_balancer.get(); }
+
+    /// @return the communicator of the collectives of ttg::World (see ttg::detail::mpi): a duplicate of the
+    ///         communicator of this world, so that their messages cannot match those of the MADNESS server thread;
+    ///         if MADNESS serializes its MPI calls (i.e. MPI only provides `MPI_THREAD_SERIALIZED`), the MPI calls of
+    ///         the collectives are serialized with them
+    ttg::detail::mpi::comm collectives_comm() const { return serialized(m_collectives_comm); }
+
     virtual void destroy(void) override {
       if (is_valid()) {
         release_ops();
         ttg::detail::deregister_world(*this);
+        m_broadcast_relay.reset();
+        m_load_balancer.reset();
+        serialized(m_collectives_comm).call([this] { return MPI_Comm_free(&m_collectives_comm); });
         if (m_allocated) {
           delete &m_impl;
           m_allocated = false;
@@ -114,6 +441,25 @@ namespace ttg_madness {
 #ifdef ENABLE_PARSEC
     parsec_context_t *context() { return ::madness::ThreadPool::instance()->parsec; }
 #endif
+
+   private:
+    /// @return \p comm , serialized with the MPI calls of MADNESS if it serializes them
+    static ttg::detail::mpi::comm serialized(MPI_Comm comm) {
+#ifdef MADNESS_SERIALIZES_MPI
+      return {comm, SafeMPI::charon};
+#else
+      return comm;
+#endif
+    }
+
+    /// duplicates the communicator of m_impl into m_collectives_comm; nonblocking, so that the MADNESS server thread
+    /// is not kept from serving the other processes until they all get here
+    void dup_collectives_comm() {
+      const auto comm = serialized(m_impl.mpi.Get_mpi_comm());
+      ttg::detail::mpi::blocking(comm, [&](MPI_Request *request) {
+        return MPI_Comm_idup(comm.get(), &m_collectives_comm, request);
+      });
+    }
   };
 
   inline void ttg_initialize(int argc, char **argv, int num_threads) {
@@ -168,6 +514,407 @@ namespace ttg_madness {
     world.impl().impl().gop.broadcast_serializable(data, source_rank);
   }
 
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T &value, Op &&op) {
+    ttg::detail::mpi::allreduce(value, op, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T *values, std::size_t n, Op &&op) {
+    ttg::detail::mpi::allreduce(values, n, op, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T &value, Op &&op, int root) {
+    ttg::detail::mpi::reduce(value, op, root, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T *values, std::size_t n, Op &&op, int root) {
+    ttg::detail::mpi::reduce(values, n, op, root, world.impl().collectives_comm());
+  }
+
+  template <typename T>
+  inline std::vector<T> ttg_gather(ttg::World world, const T &value, int root) {
+    return ttg::detail::mpi::gather(value, root, world.impl().collectives_comm());
+  }
+
+  namespace detail {
+
+    /// @return reference to the TT whose task is executed by this thread, if any
+    inline const ttg::TTBase *&current_tt_accessor() {
+      static thread_local const ttg::TTBase *tt = nullptr;
+      return tt;
+    }
+
+    /// @return reference to the number of fused tasks nested in the task executed by this thread
+    inline int &fused_call_depth_accessor() {
+      static thread_local int depth = 0;
+      return depth;
+    }
+
+    /// fused tasks are not nested deeper than this, to bound the stack usage of long (or cyclic) chains
+    inline constexpr int max_fused_call_depth = 6;
+
+    /// marks the calling thread as executing a task of \c tt , whose coroutine bodies are resumed by \c scheduler ,
+    /// for the lifetime of this object.
+    /// Also collects the tasks of fused TTs (see ttg::TTBase::get_fused_producer()) that the task sends: such a task
+    /// is deferred until the task completes and then runs inline, unless the task sends more than one task to the
+    /// same fused TT, in which case they all run as regular tasks so that they can execute concurrently.
+    class task_scope {
+      const ttg::TTBase *caller_tt;
+      ttg::detail::coroutine_scheduler *caller_scheduler;
+      task_scope *caller_scope;
+      /// the deferred tasks of fused TTs, called with true to run inline, with false to submit a regular task
+      std::vector<std::pair<const ttg::TTBase *, std::function<void(bool)>>> deferred;
+      std::vector<const ttg::TTBase *> fanout;  // the fused TTs that this task sent several tasks to
+
+      static task_scope *&current_accessor() {
+        static thread_local task_scope *scope = nullptr;
+        return scope;
+      }
+
+     public:
+      task_scope(const ttg::TTBase *tt, ttg::detail::coroutine_scheduler *scheduler)
+          : caller_tt(std::exchange(current_tt_accessor(), tt))
+          , caller_scheduler(std::exchange(ttg::detail::coroutine_scheduler_accessor(), scheduler))
+          , caller_scope(std::exchange(current_accessor(), this)) {}
+      ~task_scope() {
+        current_accessor() = caller_scope;
+        current_tt_accessor() = caller_tt;
+        ttg::detail::coroutine_scheduler_accessor() = caller_scheduler;
+        // not completed, e.g. the task threw: submit the deferred tasks as regular tasks
+        for (auto &&[tt, task] : deferred) task(false);
+      }
+      task_scope(const task_scope &) = delete;
+      task_scope &operator=(const task_scope &) = delete;
+
+      /// @return the scope of the task executed by the calling thread, or nullptr
+      static task_scope *current() { return current_accessor(); }
+
+      /// @return true if a task of the fused TT \p tt may be deferred by defer(), false if this task sends several
+      ///         tasks to \p tt ; in the latter case the task of \p tt deferred so far is submitted as a regular task
+      bool may_defer(const ttg::TTBase *tt) {
+        if (std::find(fanout.begin(), fanout.end(), tt) != fanout.end()) return false;
+        auto it = std::find_if(deferred.begin(), deferred.end(), [tt](const auto &task) { return task.first == tt; });
+        if (it == deferred.end()) return true;
+        fanout.push_back(tt);
+        auto task = std::move(it->second);
+        deferred.erase(it);
+        task(false);
+        return false;
+      }
+
+      /// defers \p task of the fused TT \p tt until complete()
+      /// \pre `may_defer(tt)==true`
+      void defer(const ttg::TTBase *tt, std::function<void(bool)> task) { deferred.emplace_back(tt, std::move(task)); }
+
+      /// runs the deferred tasks inline; called when the task has returned
+      void complete() {
+        auto tasks = std::move(deferred);
+        deferred.clear();
+        for (auto &&[tt, task] : tasks) task(true);
+      }
+    };
+
+    /// true if the TTs of this backend can have coroutine bodies (see ttg::task)
+    inline constexpr bool supports_coroutine_bodies = true;
+
+    /// A task resuming a coroutine body suspended to await a value (see ttg::task). It is submitted with an unsatisfied
+    /// dependency when the body suspends, so that fences do not complete while the body awaits, and becomes ready
+    /// to run once it is given the function resuming the body.
+    class resume_task : public ::madness::TaskInterface {
+      std::function<void()> resume_fn;
+
+     public:
+      resume_task() : ::madness::TaskInterface(1, ::madness::TaskAttributes()) {}
+
+      /// makes the task ready to call \p fn
+      void submit(std::function<void()> fn) {
+        resume_fn = std::move(fn);
+        this->dec();
+      }
+
+      void run(::madness::World &world) override { resume_fn(); }
+    };
+
+    /// Per-thread queues of the ready tasks that prefer to be executed by a given thread (see TT::set_affinitymap()).
+    /// MADNESS has a single task queue, hence each queued task is paired with a task in the MADNESS task queue, with
+    /// the same priority, that, when run by some thread, executes the oldest task queued for that thread or, if there
+    /// is none, steals the newest task queued for another thread. High-priority tasks (see TT::set_priomap()) are
+    /// executed first, by the thread they prefer if possible.
+    class affinity_queues {
+      struct queue {
+        std::mutex mtx;
+        std::deque<::madness::TaskInterface *> urgent;  // high-priority tasks
+        std::deque<::madness::TaskInterface *> tasks;
+        // the sizes of urgent and tasks, to skip the empty queues without locking them
+        std::atomic<int> nurgent = 0;
+        std::atomic<int> ntasks = 0;
+      };
+      std::vector<queue> queues;
+
+      /// @return the index of the calling thread in the MADNESS thread pool, or its size if it is not in the pool;
+      ///         looked up on first use by each thread
+      static int pool_thread_index() {
+        static thread_local int index = -1;
+        if (index < 0) {
+#ifndef HAVE_INTEL_TBB
+          const int nthreads = ::madness::ThreadPool::size();
+          const auto *threads = ::madness::ThreadPool::get_threads();
+          const pthread_t self = pthread_self();
+          index = 0;
+          while (index != nthreads && !pthread_equal(threads[index].get_id(), self)) ++index;
+#else
+          static std::atomic<int> next_thread = 0;
+          index = next_thread.fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+        return index;
+      }
+
+      /// the task paired with a queued task, see submit()
+      class pop_task : public ::madness::TaskInterface {
+        affinity_queues *queues;
+
+       public:
+        pop_task(affinity_queues *queues, const ::madness::TaskAttributes &attr)
+            : ::madness::TaskInterface(attr), queues(queues) {}
+
+        void run(::madness::World &world) override {
+          auto *task = queues->pop();
+          task->run(world);
+          delete task;
+        }
+      };
+
+      ::madness::TaskInterface *pop() {
+        const int nqueues = queues.size();
+        const int self = thread_index();
+        // there is at least one task queued for each pending pop(), but it may be in a queue already visited
+        while (true) {
+          for (auto urgent : {true, false}) {
+            for (int q = 0; q != nqueues; ++q) {
+              auto &queue = queues[(self + q) % nqueues];
+              auto &ntasks = urgent ? queue.nurgent : queue.ntasks;
+              if (ntasks.load(std::memory_order_acquire) == 0) continue;
+              std::lock_guard<std::mutex> lock(queue.mtx);
+              auto &tasks = urgent ? queue.urgent : queue.tasks;
+              if (tasks.empty()) continue;
+              ntasks.fetch_sub(1, std::memory_order_relaxed);
+              ::madness::TaskInterface *task;
+              if (q == 0 || urgent) {
+                task = tasks.front();
+                tasks.pop_front();
+              } else {
+                task = tasks.back();
+                tasks.pop_back();
+              }
+              return task;
+            }
+          }
+          // the task left for this pop() was queued in a queue after it was visited; back off before visiting again
+          std::this_thread::yield();
+        }
+      }
+
+     public:
+      explicit affinity_queues(int nthreads) : queues(nthreads) {}
+
+      /// @return the queues of this process, one per thread
+      static affinity_queues &instance() {
+        static affinity_queues queues(ttg::detail::num_threads());
+        return queues;
+      }
+
+      /// @return the number of queues
+      int size() const { return queues.size(); }
+
+      /// @return the index of the queue of the calling thread: the index of the thread in the MADNESS thread pool,
+      ///         modulo the number of queues. The threads outside the pool, i.e. the main thread, which executes tasks
+      ///         while it waits (e.g. in a fence), map to index `ThreadPool::size()`, i.e. to the last queue when the
+      ///         pool has `num_threads()-1` threads besides the main thread. The threads of the TBB-based thread pool
+      ///         are not exposed, hence are assigned indices round-robin instead.
+      int thread_index() { return queue_index(pool_thread_index()); }
+
+      /// @return the index of the queue of the tasks that prefer thread \p thread
+      int queue_index(int thread) const {
+        const int nqueues = queues.size();
+        thread %= nqueues;
+        return thread < 0 ? thread + nqueues : thread;
+      }
+
+      /// submits \p task to be executed preferably by thread \p thread (modulo the number of threads)
+      void submit(::madness::World &world, ::madness::TaskInterface *task, int thread) {
+        const ::madness::TaskAttributes attr = *task;
+        {
+          auto &queue = queues[queue_index(thread)];
+          std::lock_guard<std::mutex> lock(queue.mtx);
+          if (attr.is_high_priority()) {
+            queue.urgent.push_back(task);
+            queue.nurgent.fetch_add(1, std::memory_order_release);
+          } else {
+            queue.tasks.push_back(task);
+            queue.ntasks.fetch_add(1, std::memory_order_release);
+          }
+        }
+        world.taskq.add(new pop_task(this, attr));
+      }
+    };
+
+    /// Lock-free bookkeeping of one input argument of a task, packed into a single 64-bit word:
+    /// bits [32,64) hold the expected stream size (0 = unbounded or not yet known),
+    /// bit 31 is set once the argument is finalized, and bits [0,31) count the values received so far.
+    struct input_state {
+      using word_type = std::uint64_t;
+      static constexpr int size_shift = 32;
+      static constexpr word_type finalized_bit = word_type(1) << 31;
+      static constexpr word_type received_mask = finalized_bit - 1;
+
+      static constexpr word_type size(word_type s) { return s >> size_shift; }
+      static constexpr word_type received(word_type s) { return s & received_mask; }
+      static constexpr bool finalized(word_type s) { return (s & finalized_bit) != 0; }
+      static constexpr word_type make(word_type size, word_type received, bool finalized) {
+        return (size << size_shift) | (finalized ? finalized_bit : 0) | received;
+      }
+    };
+
+    /// Per-thread partial results of a streaming reduction.
+    /// Every thread contributing to a stream owns one node of a lock-free list and reduces into it without
+    /// synchronization; the thread that finalizes the stream combines the nodes.
+    template <typename T>
+    class stream_partials {
+      struct node {
+        std::thread::id owner;
+        T value;
+        node *next;
+      };
+      std::atomic<node *> head_ = nullptr;
+
+      static void release(node *n) {
+        while (n != nullptr) {
+          auto *next = n->next;
+          delete n;
+          n = next;
+        }
+      }
+
+     public:
+      stream_partials() = default;
+      stream_partials(const stream_partials &) = delete;
+      stream_partials &operator=(const stream_partials &) = delete;
+      ~stream_partials() { release(head_.load(std::memory_order_acquire)); }
+
+      /// reduces \p value into the partial result of the calling thread
+      template <typename Reducer, typename Value>
+      void reduce(const Reducer &reducer, Value &&value) {
+        const auto me = std::this_thread::get_id();
+        node *n = head_.load(std::memory_order_acquire);
+        for (; n != nullptr && n->owner != me; n = n->next)
+          ;
+        if (n != nullptr) {
+          reducer(n->value, value);
+        } else {  // first value seen by this thread initializes its partial result
+          n = new node{me, T(std::forward<Value>(value)), head_.load(std::memory_order_relaxed)};
+          while (!head_.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        }
+      }
+
+      /// combines the partial results of all threads into \p result , the first one is moved rather than reduced
+      /// \pre all contributions have been published, i.e. the stream is finalized
+      template <typename Reducer>
+      void combine(const Reducer &reducer, T &result) {
+        node *first = head_.exchange(nullptr, std::memory_order_acquire);
+        if (first == nullptr) return;
+        result = std::move(first->value);
+        for (node *n = first->next; n != nullptr; n = n->next) reducer(result, n->value);
+        release(first);
+      }
+    };
+
+    template <typename Tuple>
+    struct stream_partials_tuple;
+    template <typename... Ts>
+    struct stream_partials_tuple<std::tuple<Ts...>> {
+      using type = std::tuple<stream_partials<Ts>...>;
+    };
+    template <typename Tuple>
+    using stream_partials_tuple_t = typename stream_partials_tuple<Tuple>::type;
+
+    /// hashes the container element that a task key maps to, or the key itself if the container does not expose it
+    template <typename Key>
+    struct pull_element_hash {
+      std::function<std::size_t(const Key &)> element_hash;
+      std::size_t operator()(const Key &key) const { return element_hash ? element_hash(key) : ttg::hash<Key>{}(key); }
+    };
+
+    /// compares the container elements that task keys map to, or the keys themselves if the container does not
+    /// expose them
+    template <typename Key>
+    struct pull_element_equal {
+      std::function<bool(const Key &, const Key &)> same_element;
+      bool operator()(const Key &a, const Key &b) const { return same_element ? same_element(a, b) : a == b; }
+    };
+
+    /// Bookkeeping of the remote pulls issued through one pull terminal.
+    /// Requests are coalesced per container element, i.e. tasks whose keys map to the same element share one
+    /// request (see ttg::detail::ContainerWrapper::same_element), and new requests are batched per owner rank until
+    /// the pending batches are flushed by a task. Elements shared by several keys stay cached in \c prefetched
+    /// until the next fence, when no request can be in flight.
+    template <typename Key, typename Value>
+    struct pull_state {
+      using element_map_t = std::unordered_map<Key, std::vector<Key>, pull_element_hash<Key>, pull_element_equal<Key>>;
+      using value_map_t = std::unordered_map<Key, Value, pull_element_hash<Key>, pull_element_equal<Key>>;
+      using awaiter_map_t = std::unordered_map<Key, std::vector<std::function<void(const Value &)>>,
+                                               pull_element_hash<Key>, pull_element_equal<Key>>;
+
+      std::mutex mtx;
+      std::map<int, std::vector<Key>> outbox;  // requests not yet sent, grouped by the owner rank
+      element_map_t inflight;  // requested elements, mapped to the keys of the tasks waiting for them (none = prefetch)
+      awaiter_map_t awaiting;  // requested elements awaited by coroutine bodies, see TT::pull
+      value_map_t prefetched;  // elements that arrived before their tasks asked
+      bool retain = false;     // if true, elements are shared by keys and stay in prefetched until the fence
+      bool flush_scheduled = false;
+
+      /// makes requests coalesce per container element, using the element hash/comparison of the terminal's
+      /// container; must be called before the first request
+      void bind(std::function<std::size_t(const Key &)> element_hash,
+                std::function<bool(const Key &, const Key &)> same_element) {
+        assert(inflight.empty() && prefetched.empty());
+        retain = static_cast<bool>(same_element);
+        pull_element_hash<Key> hash{std::move(element_hash)};
+        pull_element_equal<Key> equal{std::move(same_element)};
+        inflight = element_map_t(0, hash, equal);
+        awaiting = awaiter_map_t(0, hash, equal);
+        prefetched = value_map_t(0, hash, equal);
+      }
+
+      /// drops the cached elements; called at fence
+      void clear() {
+        std::lock_guard<std::mutex> lock(mtx);
+        assert(inflight.empty() && awaiting.empty() && outbox.empty());
+        prefetched.clear();
+      }
+    };
+
+    template <typename Key, typename Tuple>
+    struct pull_states_tuple;
+    template <typename Key, typename... Ts>
+    struct pull_states_tuple<Key, std::tuple<Ts...>> {
+      using type = std::tuple<pull_state<Key, Ts>...>;
+    };
+    template <typename Key, typename Tuple>
+    using pull_states_tuple_t = typename pull_states_tuple<Key, Tuple>::type;
+
+    /// the type returned by `op_batch` of \c T, used to detect TTs that can execute batches of tasks
+    template <typename T, typename Key, typename ValuesTuple, typename OutputTerminals>
+    using op_batch_t = decltype(std::declval<T &>().op_batch(std::declval<ttg::span<const Key>>(),
+                                                             std::declval<ttg::span<ValuesTuple>>(),
+                                                             std::declval<OutputTerminals &>()));
+
+  }  // namespace detail
+
   /// CRTP base for MADNESS-based TT classes
   /// \tparam keyT a Key type
   /// \tparam output_terminalsT
@@ -194,6 +941,7 @@ namespace ttg_madness {
     ttg::World world;
     ttg::meta::detail::keymap_t<keyT> keymap;
     ttg::meta::detail::keymap_t<keyT> priomap;
+    ttg::meta::detail::keymap_t<keyT> affinitymap;  // empty = no preferred thread, see set_affinitymap()
     // For now use same type for unary/streaming input terminals, and stream reducers assigned at runtime
     ttg::meta::detail::input_reducers_t<actual_input_tuple_type>
         input_reducers;  //!< Reducers for the input terminals (empty = expect single value)
@@ -261,18 +1009,15 @@ namespace ttg_madness {
       using TaskInterface = ::madness::TaskInterface;
 
      public:
-      int counter;  // Tracks the number of arguments finalized
-      std::array<std::int64_t, numins>
-          nargs;  // Tracks the number of expected values minus the number of received values
-                  // 0 = finalized
-                  // for a streaming input initialized to std::numeric_limits<std::int64_t>::max()
-                  // which indicates that the value needs to be initialized
-      std::array<std::size_t, numins> stream_size;  // Expected number of values to receive, to be used for streaming
-                                                    // inputs (0 = unbounded stream, >0 = bounded stream)
-      input_values_tuple_type input_values;         // The input values (does not include control)
-      derivedT *derived;                            // Pointer to derived class instance
-      bool pull_terminals_invoked = false;
+      std::atomic<int> counter;  // Tracks the number of arguments not yet finalized
+      std::array<std::atomic<detail::input_state::word_type>, numins>
+          state;  // Per-argument stream size, received count and finalized flag, see detail::input_state
+      detail::stream_partials_tuple_t<input_values_full_tuple_type>
+          partials;                                  // Per-thread partial reductions of the streaming inputs
+      input_values_tuple_type input_values;          // The input values (does not include control)
+      derivedT *derived;                             // Pointer to derived class instance
       std::conditional_t<ttg::meta::is_void_v<keyT>, ttg::Void, keyT> key;  // Task key
+      bool balanced = false;  // True if the task counts towards the load of this rank, see detail::load_balancer
 
       /// makes a tuple of references out of tuple of
       template <typename Tuple, std::size_t... Is>
@@ -288,20 +1033,29 @@ namespace ttg_madness {
       }
 
       TTArgs(int prio = 0)
-          : TaskInterface(TaskAttributes(prio ? TaskAttributes::HIGHPRIORITY : 0))
-          , counter(numins)
-          , nargs()
-          , stream_size()
-          , input_values() {
-        std::fill(nargs.begin(), nargs.end(), std::numeric_limits<std::int64_t>::max());
+          : TaskInterface(TaskAttributes(prio ? TaskAttributes::HIGHPRIORITY : 0)), counter(numins), input_values() {
+        for (auto &s : state) s.store(0, std::memory_order_relaxed);
+      }
+
+      /// @return true if argument \c i has been finalized
+      bool finalized(std::size_t i) const {
+        return detail::input_state::finalized(state[i].load(std::memory_order_acquire));
       }
 
+      /// accounts for the finalization of one argument
+      /// @return the number of arguments still to be finalized, zero if the task is ready to run; every value is
+      ///         returned to exactly one caller
+      int finalize_arg() { return counter.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
       virtual void run(::madness::World &world) override {
         // ttg::print("starting task");
 
+        if (balanced) derived->world.impl().load_balancer()->task_started();
+
         using ttg::hash;
         ttT::threaddata.key_hash = hash<decltype(key)>{}(key);
         ttT::threaddata.call_depth++;
+        detail::task_scope scope(derived, &derived->coroutine_resumer);
 
         if constexpr (!ttg::meta::is_void_v<keyT> && !ttg::meta::is_empty_tuple_v<input_values_tuple_type>) {
           derived->op(key, this->make_input_refs(),
@@ -315,6 +1069,7 @@ namespace ttg_madness {
           derived->op(derived->output_terminals);
         } else
           abort();
+        scope.complete();
 
         ttT::threaddata.call_depth--;
 
@@ -322,22 +1077,256 @@ namespace ttg_madness {
       }
 
       virtual ~TTArgs() {}  // Will be deleted via TaskInterface*
-
-     private:
-      ::madness::Spinlock lock_;  // synchronizes access to data
-     public:
-      void lock() { lock_.lock(); }
-      void unlock() { lock_.unlock(); }
     };
 
     using hashable_keyT = std::conditional_t<ttg::meta::is_void_v<keyT>, int, keyT>;
     using cacheT = ::madness::ConcurrentHashMap<hashable_keyT, TTArgs *, ttg::hash<hashable_keyT>>;
     using accessorT = typename cacheT::accessor;
     cacheT cache;
+    detail::pull_states_tuple_t<hashable_keyT, input_values_tuple_type> pull_states;  // remote pulls, per terminal
+
+    /// resumes the suspended coroutine bodies of this TT, see ttg::task
+    class coroutine_scheduler : public ttg::detail::coroutine_scheduler {
+      ttT *tt;
+
+     public:
+      explicit coroutine_scheduler(ttT *tt) : tt(tt) {}
+
+      void *suspend() override {
+        auto *task = new detail::resume_task;
+        tt->world.impl().impl().taskq.add(task);
+        return task;
+      }
+
+      void resume(void *token, std::function<void()> resume_fn) override {
+        static_cast<detail::resume_task *>(token)->submit([tt = this->tt, resume_fn = std::move(resume_fn)]() {
+          ttg::trace(tt->world.rank(), ":", tt->get_name(), " : resuming coroutine body");
+          auto old_output_tls_ptr = tt->outputs_tls_ptr_accessor();
+          tt->set_outputs_tls_ptr();
+          detail::task_scope scope(tt, &tt->coroutine_resumer);
+          resume_fn();
+          scope.complete();
+          tt->set_outputs_tls_ptr(old_output_tls_ptr);
+        });
+      }
+    };
+    coroutine_scheduler coroutine_resumer{this};
+
+    std::mutex batch_mtx;
+    std::deque<TTArgs *> batch_ready;  // ready tasks waiting to be executed by op_batch
+    std::size_t batch_tasks = 0;       // number of tasks in the task queue that will execute a batch
+
+    /// @return true if derivedT can execute batches of tasks, see TTBase::set_batch_size()
+    static constexpr bool derived_has_op_batch() {
+      if constexpr (ttg::meta::is_void_v<keyT>)
+        return false;
+      else
+        return ttg::meta::is_detected_v<detail::op_batch_t, derivedT, keyT, input_values_tuple_type,
+                                        output_terminalsT>;
+    }
+
+    /// queues the ready task \p args to be executed as part of a batch; the batch is formed by the ready tasks
+    /// queued until the task executing it runs. A new batch task is submitted whenever the queued tasks exceed
+    /// what the batch tasks already in the task queue will execute, hence several batches may execute concurrently.
+    void submit_batched(TTArgs *args) {
+      bool schedule = false;
+      {
+        std::lock_guard<std::mutex> lock(batch_mtx);
+        batch_ready.push_back(args);
+        if (batch_ready.size() > batch_tasks * this->get_batch_size()) {
+          ++batch_tasks;
+          schedule = true;
+        }
+      }
+      if (schedule) world.impl().impl().taskq.add([this]() { this->run_batch(); });
+    }
+
+    /// executes up to get_batch_size() queued tasks by a single call to op_batch
+    void run_batch() {
+      std::vector<TTArgs *> batch;
+      bool schedule = false;
+      {
+        std::lock_guard<std::mutex> lock(batch_mtx);
+        const auto n = std::min(batch_ready.size(), this->get_batch_size());
+        batch.assign(batch_ready.begin(), batch_ready.begin() + n);
+        batch_ready.erase(batch_ready.begin(), batch_ready.begin() + n);
+        --batch_tasks;
+        // the other batch tasks in the queue execute the rest, unless it exceeds their capacity
+        if (batch_ready.size() > batch_tasks * this->get_batch_size()) {
+          ++batch_tasks;
+          schedule = true;
+        }
+      }
+      if (schedule) world.impl().impl().taskq.add([this]() { this->run_batch(); });
+      // the queued tasks were taken by the concurrent batch tasks
+      if (batch.empty()) return;
+
+      std::vector<keyT> keys;
+      std::vector<input_values_tuple_type> values;
+      keys.reserve(batch.size());
+      values.reserve(batch.size());
+      for (auto *args : batch) {
+        keys.emplace_back(std::move(args->key));
+        values.emplace_back(std::move(args->input_values));
+        delete args;
+      }
+
+      ttg::trace(world.rank(), ":", get_name(), " : executing batch of ", keys.size(), " tasks");
+      threaddata.call_depth++;
+      detail::task_scope scope(this, &coroutine_resumer);
+      static_cast<derivedT *>(this)->op_batch(ttg::span<const keyT>(keys.data(), keys.size()),
+                                              ttg::span<input_values_tuple_type>(values.data(), values.size()),
+                                              output_terminals);
+      scope.complete();
+      threaddata.call_depth--;
+    }
+
+    /// submits the ready task \p args to the task queue, or to the queue of its preferred thread if
+    /// the affinity map is set; the tasks of relocatable TTs may be delegated to another rank instead
+    void submit_ready(TTArgs *args) {
+      // only the tasks of relocatable TTs are accounted for, the others do not touch the load balancer
+      if constexpr (!ttg::meta::is_void_v<keyT>) {
+        if (this->is_relocatable()) {
+          auto *balancer = world.impl().load_balancer();
+          if (const int target = balancer->choose_target(); target >= 0) {
+            ttg::trace(world.rank(), ":", get_name(), " : ", args->key, ": delegating task to rank ", target);
+            worldobjT::send(target, &ttT::run_delegated, world.rank(), balancer->get_load(), args->key,
+                            args->input_values);
+            delete args;
+            return;
+          }
+          args->balanced = balancer->task_queued();
+        }
+      }
+      if (affinitymap) {
+        int thread;
+        if constexpr (!ttg::meta::is_void_v<keyT>) {
+          thread = affinitymap(args->key);
+        } else {
+          thread = affinitymap();
+        }
+        detail::affinity_queues::instance().submit(world.impl().impl(), args, thread);
+      } else {
+        world.impl().impl().taskq.add(args);
+      }
+    }
+
+    /// executes the task for \p key with inputs \p values delegated by rank \p source , whose load was
+    /// \p source_load , see submit_ready()
+    void run_delegated(int source, long source_load, const hashable_keyT &key, const input_values_tuple_type &values) {
+      auto *balancer = world.impl().load_balancer();
+      balancer->update(source, source_load);
+      ttg::trace(world.rank(), ":", get_name(), " : ", key, ": received task delegated by rank ", source);
+      auto *args = new TTArgs(this->priomap(key));
+      args->derived = static_cast<derivedT *>(this);
+      args->key = key;
+      args->input_values = values;
+      // delegated tasks are not delegated again
+      args->balanced = balancer->task_queued();
+      if (affinitymap)
+        detail::affinity_queues::instance().submit(world.impl().impl(), args, affinitymap(key));
+      else
+        world.impl().impl().taskq.add(args);
+    }
+
+    /// looks up the arguments of the task with key \p key , creating them if needed;
+    /// the cache entry is locked only for the duration of the lookup, the returned object is updated via its
+    /// atomic state
+    /// \param[out] inserted set to true if the arguments were created by this call
+    template <typename Key>
+    TTArgs *find_or_create_args(const Key &key, int prio, bool &inserted) {
+      while (true) {
+        {
+          accessorT acc;
+          bool created;
+          if constexpr (!ttg::meta::is_void_v<Key>)
+            created = cache.insert(acc, key);
+          else
+            created = cache.insert(acc, 0);
+          if (created) acc->second = new TTArgs(prio);  // It will be deleted by the task q
+          // a ready task is erased from the cache before it is submitted, wait for that to happen
+          if (created || acc->second->counter.load(std::memory_order_acquire) != 0) {
+            inserted = created;
+            return acc->second;
+          }
+        }
+        std::this_thread::yield();
+      }
+    }
+
+    /// removes the cache entry of a ready task; must precede the submission of the task since
+    /// afterwards its arguments may be deleted by the task queue at any time
+    template <typename Key>
+    void erase_args(const Key &key) {
+      if constexpr (!ttg::meta::is_void_v<Key>)
+        cache.erase(key);
+      else
+        cache.erase(0);
+    }
+
+    /// accounts for the finalization of an input of the task with key \p key . With lazy pulling, the caller that
+    /// leaves only the pull inputs to be finalized invokes the pull terminals; since those inputs are still pending,
+    /// \p args is alive at that point.
+    /// \warning \p args must not be accessed once this returned false: the last input may be finalized concurrently,
+    ///          and the task submitted, executed and deleted
+    /// @return true if the task is ready to run
+    template <typename Key>
+    bool input_finalized(const Key &key, TTArgs *args) {
+      const int remaining = args->finalize_arg();
+      if (remaining != 0 && remaining == num_pullins && is_lazy_pull())
+        return invoke_pull_terminals(std::make_index_sequence<std::tuple_size_v<input_values_tuple_type>>{}, key,
+                                     args);
+      return remaining == 0;
+    }
+
+    /// marks nonstreaming input \c i finalized
+    /// @return true if the task is ready to run, see input_finalized()
+    template <std::size_t i, typename Key>
+    bool finalize_arg(const Key &key, TTArgs *args) {
+      const auto s = args->state[i].fetch_or(detail::input_state::finalized_bit, std::memory_order_acq_rel);
+      if (detail::input_state::finalized(s)) {
+        ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error argument is already finalized : ", i);
+        throw std::runtime_error("TT::set_arg called for a finalized stream");
+      }
+      return input_finalized(key, args);
+    }
+
+    /// accounts for a value received on streaming input \c i ; the stream is finalized when the number of
+    /// received values reaches the stream size set for this task, or else the static stream size
+    /// @return true if this value finalized the stream
+    template <std::size_t i, typename Key>
+    bool stream_arg_received(const Key &key, TTArgs *args) {
+      using state_t = detail::input_state;
+      auto &state = args->state[i];
+      auto s = state.load(std::memory_order_acquire);
+      state_t::word_type next;
+      do {
+        if (state_t::finalized(s)) {
+          ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error argument is already finalized : ", i);
+          throw std::runtime_error("TT::set_arg called for a finalized stream");
+        }
+        const auto size = state_t::size(s) != 0 ? state_t::size(s) : state_t::word_type(static_streamsize[i]);
+        const auto received = state_t::received(s) + 1;
+        assert(received <= state_t::received_mask);
+        next = state_t::make(size, received, size != 0 && received == size);
+      } while (!state.compare_exchange_weak(s, next, std::memory_order_acq_rel, std::memory_order_acquire));
+      return state_t::finalized(next);
+    }
+
+    /// combines the per-thread partial results of streaming input \c i into its input value
+    /// \pre the stream has been finalized
+    template <std::size_t i>
+    void combine_stream_partials(TTArgs *args) {
+      if constexpr (i < std::tuple_size_v<input_values_tuple_type>) {
+        using valueT = std::tuple_element_t<i, input_values_tuple_type>;
+        std::get<i>(args->partials).combine(std::get<i>(input_reducers), this->get<i, valueT &>(args->input_values));
+      }
+    }
 
    protected:
+    /// @return true if the task is ready to run
     template <typename terminalT, std::size_t i, typename Key>
-    void invoke_pull_terminal(terminalT &in, const Key &key, TTArgs *args) {
+    bool invoke_pull_terminal(terminalT &in, const Key &key, TTArgs *args) {
       if (in.is_pull_terminal) {
         int owner;
         if constexpr (!ttg::meta::is_void_v<Key>) {
@@ -347,37 +1336,40 @@ namespace ttg_madness {
         }
 
         if (owner != world.rank()) {
-          get_terminal_data<i, Key>(owner, key);
-        } else {
-          if constexpr (!ttg::meta::is_void_v<Key>) {
-            auto value = (in.container).get(key);
-            if (args->nargs[i] == 0) {
-              ::ttg::print_error(world.rank(), ":", get_name(), " : ", key,
-                                 ": error argument is already finalized : ", i);
-              throw std::runtime_error("Op::set_arg called for a finalized stream");
-            }
-
-            if (typeid(value) != typeid(std::nullptr_t) && i < std::tuple_size_v<input_values_tuple_type>) {
-              this->get<i, std::decay_t<decltype(value)> &>(args->input_values) = std::forward<decltype(value)>(value);
-              args->nargs[i] = 0;
-              args->counter--;
+          if constexpr (!ttg::meta::is_void_v<Key> && i < std::tuple_size_v<input_values_tuple_type>) {
+            // a remote pull completes via set_arg, unless the value was prefetched already
+            if (auto value = request_pull<i>(key, owner)) {
+              if (args->finalized(i)) {
+                ::ttg::print_error(world.rank(), ":", get_name(), " : ", key,
+                                   ": error argument is already finalized : ", i);
+                throw std::runtime_error("Op::set_arg called for a finalized stream");
+              }
+              this->get<i, std::decay_t<decltype(*value)> &>(args->input_values) = std::move(*value);
+              return finalize_arg<i>(key, args);
             }
           } else {
-            auto value = (in.container).get();
-            if (args->nargs[i] == 0) {
-              ::ttg::print_error(world.rank(), ":", get_name(), " : ", key,
-                                 ": error argument is already finalized : ", i);
-              throw std::runtime_error("Op::set_arg called for a finalized stream");
-            }
+            get_terminal_data<i, Key>(owner, key);
+          }
+        } else {
+          auto value = [&]() {
+            if constexpr (!ttg::meta::is_void_v<Key>)
+              return (in.container).get(key);
+            else
+              return (in.container).get();
+          }();
+          if (args->finalized(i)) {
+            ::ttg::print_error(world.rank(), ":", get_name(), " : ", key,
+                               ": error argument is already finalized : ", i);
+            throw std::runtime_error("Op::set_arg called for a finalized stream");
+          }
 
-            if (typeid(value) != typeid(std::nullptr_t) && i < std::tuple_size_v<input_values_tuple_type>) {
-              this->get<i, std::decay_t<decltype(value)> &>(args->input_values) = std::forward<decltype(value)>(value);
-              args->nargs[i] = 0;
-              args->counter--;
-            }
+          if (typeid(value) != typeid(std::nullptr_t) && i < std::tuple_size_v<input_values_tuple_type>) {
+            this->get<i, std::decay_t<decltype(value)> &>(args->input_values) = std::forward<decltype(value)>(value);
+            return finalize_arg<i>(key, args);
           }
         }
       }
+      return false;
     }
 
     template <std::size_t i, typename Key>
@@ -398,12 +1390,187 @@ namespace ttg_madness {
       }
     }
 
+    /// requests the value of pull terminal \c i for \p key from rank \p owner ; the request is coalesced with an
+    /// outstanding request for the same container element, or else batched with the other requests for \p owner
+    /// together with the keys suggested by the prefetch hint of the terminal's container
+    /// @param[in] awaiter if set, is called with the value when it arrives, instead of delivering the value to the
+    ///            task with key \p key
+    /// @return the value, if it has been prefetched already
+    template <std::size_t i>
+    std::optional<std::tuple_element_t<i, input_values_tuple_type>> request_pull(
+        const hashable_keyT &key, int owner,
+        std::function<void(const std::tuple_element_t<i, input_values_tuple_type> &)> awaiter = {}) {
+      using valueT = std::tuple_element_t<i, input_values_tuple_type>;
+      auto &in = std::get<i>(input_terminals);
+      auto &state = std::get<i>(pull_states);
+      std::optional<valueT> result;
+      bool schedule_flush = false;
+      {
+        std::lock_guard<std::mutex> lock(state.mtx);
+        if (auto it = state.prefetched.find(key); it != state.prefetched.end()) {
+          if (state.retain) {
+            result = it->second;
+          } else {
+            result = std::move(it->second);
+            state.prefetched.erase(it);
+          }
+          return result;
+        }
+        auto [it, inserted] = state.inflight.try_emplace(key);
+        if (awaiter)
+          state.awaiting[key].push_back(std::move(awaiter));
+        else
+          it->second.push_back(key);
+        if (!inserted) return result;  // the element was requested already, possibly as a prefetch
+        state.outbox[owner].push_back(key);
+        if (in.container.prefetch) {
+          for (auto &&k : in.container.prefetch(key)) {
+            // prefetch only the remote values that will be consumed by tasks on this rank
+            const int k_owner = in.container.owner(k);
+            if (k_owner == world.rank() || keymap(k) != world.rank() || state.prefetched.count(k) != 0) continue;
+            if (state.inflight.try_emplace(k).second) state.outbox[k_owner].push_back(k);
+          }
+        }
+        schedule_flush = !std::exchange(state.flush_scheduled, true);
+      }
+      // requests issued until the flush task runs are sent in the same batch
+      if (schedule_flush) world.impl().impl().taskq.add([this]() { this->template flush_pulls<i>(); });
+      return result;
+    }
+
+    /// sends the batched pull requests of terminal \c i , one message per owner rank
+    template <std::size_t i>
+    void flush_pulls() {
+      std::map<int, std::vector<hashable_keyT>> outbox;
+      {
+        auto &state = std::get<i>(pull_states);
+        std::lock_guard<std::mutex> lock(state.mtx);
+        outbox.swap(state.outbox);
+        state.flush_scheduled = false;
+      }
+      for (auto &&[owner, keys] : outbox) {
+        ttg::trace(world.rank(), ":", get_name(), " : pulling ", keys.size(), " values for terminal ", i, " from ",
+                   owner);
+        worldobjT::send(owner, &ttT::template serve_pulls<i>, world.rank(), keys);
+      }
+    }
+
+    /// serves a batch of pull requests for terminal \c i issued by rank \p requester
+    template <std::size_t i>
+    void serve_pulls(int requester, const std::vector<hashable_keyT> &keys) {
+      using valueT = std::tuple_element_t<i, input_values_tuple_type>;
+      auto &in = std::get<i>(input_terminals);
+      std::vector<valueT> values;
+      values.reserve(keys.size());
+      for (auto &&key : keys) values.emplace_back(in.container.get(key));
+      worldobjT::send(requester, &ttT::template receive_pulls<i>, keys, values);
+    }
+
+    /// delivers the elements pulled via terminal \c i to the waiting tasks, and stores the prefetched or shared
+    /// ones
+    template <std::size_t i>
+    void receive_pulls(const std::vector<hashable_keyT> &keys,
+                       const std::vector<std::tuple_element_t<i, input_values_tuple_type>> &values) {
+      assert(keys.size() == values.size());
+      auto &state = std::get<i>(pull_states);
+      for (std::size_t k = 0; k != keys.size(); ++k) {
+        std::vector<hashable_keyT> waiting;
+        std::vector<std::function<void(const std::tuple_element_t<i, input_values_tuple_type> &)>> awaiters;
+        {
+          std::lock_guard<std::mutex> lock(state.mtx);
+          auto it = state.inflight.find(keys[k]);
+          assert(it != state.inflight.end());
+          waiting = std::move(it->second);
+          state.inflight.erase(it);
+          if (auto a = state.awaiting.find(keys[k]); a != state.awaiting.end()) {
+            awaiters = std::move(a->second);
+            state.awaiting.erase(a);
+          }
+          if ((waiting.empty() && awaiters.empty()) || state.retain) state.prefetched.emplace(keys[k], values[k]);
+        }
+        for (auto &&key : waiting) set_arg<i>(key, values[k]);
+        for (auto &&awaiter : awaiters) awaiter(values[k]);
+      }
+    }
+
+    /// drops the elements cached by the pull terminals; called at fence
+    void clear_pull_states() {
+      std::apply([](auto &...states) { (states.clear(), ...); }, pull_states);
+    }
+
+    /// @return true if the task is ready to run
     template <std::size_t... IS, typename Key = keyT>
-    void invoke_pull_terminals(std::index_sequence<IS...>, const Key &key, TTArgs *args) {
-      int junk[] = {0, (invoke_pull_terminal<typename std::tuple_element<IS, input_terminals_type>::type, IS>(
-                            std::get<IS>(input_terminals), key, args),
-                        0)...};
-      junk[0]++;
+    bool invoke_pull_terminals(std::index_sequence<IS...>, const Key &key, TTArgs *args) {
+      return (false | ... |
+              invoke_pull_terminal<typename std::tuple_element<IS, input_terminals_type>::type, IS>(
+                  std::get<IS>(input_terminals), key, args));
+    }
+
+    /// If this TT was fused with its producer (see ttg::TTBase::get_fused_producer()) and the calling thread is
+    /// executing a task of the producer, defers the task for \p key until the producer task completes, then it runs
+    /// in the calling thread, bypassing the task queue, unless the producer task sends more tasks to this TT (see
+    /// detail::task_scope). Only used for TTs with a single input, i.e. the task is ready as soon as its argument
+    /// arrives.
+    /// @return true if the task was deferred
+    template <std::size_t i, typename Key, typename Value>
+    bool try_run_fused(const Key &key, Value &&value) {
+      static_assert(numins == 1);
+      auto *scope = detail::task_scope::current();
+      if (scope == nullptr || this->get_fused_producer() == nullptr ||
+          detail::current_tt_accessor() != this->get_fused_producer() ||
+          detail::fused_call_depth_accessor() >= detail::max_fused_call_depth || !is_fusable() ||
+          std::get<i>(input_reducers) || !scope->may_defer(this))
+        return false;
+
+      scope->defer(this, [this, key, value = std::decay_t<Value>(std::forward<Value>(value))](bool run_inline) mutable {
+        if (run_inline)
+          run_fused<i>(key, std::move(value));
+        else
+          set_arg<i, Key, std::decay_t<Value>>(key, std::move(value));
+      });
+      return true;
+    }
+
+    /// executes the task of a fused TT for \p key in the calling thread, see try_run_fused()
+    template <std::size_t i, typename Key, typename Value>
+    void run_fused(const Key &key, Value &&value) {
+      ttg::trace(world.rank(), ":", get_name(), " : ", key, ": running fused task for op ");
+      using ttg::hash;
+      const auto caller_key_hash = std::exchange(threaddata.key_hash, hash<keyT>{}(key));
+      threaddata.call_depth++;
+      detail::fused_call_depth_accessor()++;
+      detail::task_scope scope(this, &coroutine_resumer);
+
+      auto *derived = static_cast<derivedT *>(this);
+      if constexpr (ttg::meta::is_empty_tuple_v<input_values_tuple_type>) {
+        if constexpr (!ttg::meta::is_void_v<keyT>) {
+          derived->op(key, output_terminals);
+        } else {
+          derived->op(output_terminals);
+        }
+      } else {
+        using ref_t = std::tuple_element_t<0, input_refs_tuple_type>;
+        auto invoke = [&](auto &arg) {
+          if constexpr (!ttg::meta::is_void_v<keyT>) {
+            derived->op(key, input_refs_tuple_type{static_cast<ref_t>(arg)}, output_terminals);
+          } else {
+            derived->op(input_refs_tuple_type{static_cast<ref_t>(arg)}, output_terminals);
+          }
+        };
+        // the op may consume its argument: bind it to the given value only if that is an rvalue, copy otherwise
+        if constexpr (std::is_const_v<std::remove_reference_t<ref_t>> ||
+                      (std::is_rvalue_reference_v<Value &&> && !std::is_const_v<std::remove_reference_t<Value>>)) {
+          invoke(value);
+        } else {
+          std::decay_t<Value> copy(value);
+          invoke(copy);
+        }
+      }
+      scope.complete();
+
+      detail::fused_call_depth_accessor()--;
+      threaddata.call_depth--;
+      threaddata.key_hash = caller_key_hash;
     }
 
     // there are 6 types of set_arg:
@@ -455,99 +1622,70 @@ namespace ttg_madness {
       } else {
         ttg::trace(world.rank(), ":", get_name(), " : ", key, ": received value for argument : ", i);
 
-        bool pullT_invoked = false;
-        accessorT acc;
+        if constexpr (numins == 1) {
+          if (try_run_fused<i>(key, std::forward<Value>(value))) return;
+        }
 
         int prio;
         if constexpr (!ttg::meta::is_void_v<Key>) {
           prio = this->priomap(key);
-          if (cache.insert(acc, key)) {
-            acc->second = new TTArgs(prio);  // It will be deleted by the task q
-            if (!is_lazy_pull()) {
-              // Invoke pull terminals for only the terminals with non-void values.
-              invoke_pull_terminals(std::make_index_sequence<std::tuple_size_v<input_values_tuple_type>>{}, key,
-                                    acc->second);
-              pullT_invoked = true;
-            }
-          }
         } else {
           prio = this->priomap();
-          if (cache.insert(acc, 0)) acc->second = new TTArgs(prio);  // It will be deleted by the task q
         }
+        bool inserted;
+        TTArgs *args = find_or_create_args(key, prio, inserted);
+        bool ready = false;
 
-        TTArgs *args = acc->second;
-        if (!is_lazy_pull() && pullT_invoked) args->pull_terminals_invoked = true;
+        if constexpr (!ttg::meta::is_void_v<Key>) {
+          if (inserted && !is_lazy_pull()) {
+            // Invoke pull terminals for only the terminals with non-void values.
+            ready |= invoke_pull_terminals(std::make_index_sequence<std::tuple_size_v<input_values_tuple_type>>{}, key,
+                                           args);
+          }
+        }
 
-        if (args->nargs[i] == 0) {
+        if (args->finalized(i)) {
           ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error argument is already finalized : ", i);
           throw std::runtime_error("TT::set_arg called for a finalized stream");
         }
 
         const auto &reducer = std::get<i>(input_reducers);
         if (reducer) {  // is this a streaming input? reduce the received value
-          // N.B. Right now reductions are done eagerly, without spawning tasks
-          //      this means we must lock
-          args->lock();
-
-          bool initialize_not_reduce = false;
-          if (args->nargs[i] == std::numeric_limits<std::int64_t>::max()) {
-            // upon first datum initialize, if needed
-            if constexpr (!ttg::meta::is_void_v<valueT>) {
-              initialize_not_reduce = true;
-            }
-
-            // initialize nargs
-            // if we have a stream size for the op, use it first
-            if (args->stream_size[i] != 0) {
-              assert(args->stream_size[i] <= static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max()));
-              args->nargs[i] = args->stream_size[i];
-            } else if (static_streamsize[i] != 0) {
-              assert(static_streamsize[i] <= static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max()));
-              args->stream_size[i] = static_streamsize[i];
-              args->nargs[i] = static_streamsize[i];
-            } else {
-              args->nargs[i] = 0;
-            }
-          }
-
+          // N.B. Right now reductions are done eagerly, without spawning tasks; each thread reduces into its own
+          //      partial result, the partial results are combined by the thread that finalizes the stream
           if constexpr (!ttg::meta::is_void_v<valueT>) {  // for data values
-            if (initialize_not_reduce)
-              this->get<i, std::decay_t<valueT> &>(args->input_values) = std::forward<Value>(value);
-            else
-              reducer(this->get<i, std::decay_t<valueT> &>(args->input_values), value);
+            std::get<i>(args->partials).reduce(reducer, std::forward<Value>(value));
           } else {
             reducer();  // even if this was a control input, must execute the reducer for possible side effects
           }
 
-          // update the counter
-          args->nargs[i]--;
-
           // is this the last message?
-          if (args->nargs[i] == 0) args->counter--;
-
-          args->unlock();
+          if (stream_arg_received<i>(key, args)) {
+            combine_stream_partials<i>(args);
+            ready |= input_finalized(key, args);
+          }
         } else {                                          // this is a nonstreaming input => set the value
           if constexpr (!ttg::meta::is_void_v<valueT>) {  // for data values
             this->get<i, std::decay_t<valueT> &>(args->input_values) = std::forward<Value>(value);
           }
-          args->nargs[i] = 0;
-          args->counter--;
-        }
-
-        // If lazy pulling in enabled, check it here.
-        if (numins - args->counter == num_pullins) {
-          if (is_lazy_pull() && !args->pull_terminals_invoked) {
-            // Invoke pull terminals for only the terminals with non-void values.
-            invoke_pull_terminals(std::make_index_sequence<std::tuple_size_v<input_values_tuple_type>>{}, key, args);
-          }
+          ready |= finalize_arg<i>(key, args);
         }
+        // N.B. unless ready, args may have been deleted by now (lazy pulls were issued by input_finalized)
 
         // ready to run the task?
-        if (args->counter == 0) {
+        if (ready) {
           ttg::trace(world.rank(), ":", get_name(), " : ", key, ": submitting task for op ");
+          erase_args(key);
           args->derived = static_cast<derivedT *>(this);
           args->key = key;
 
+          if constexpr (derived_has_op_batch()) {
+            if (this->get_batch_size() > 1) {
+              submit_batched(args);
+              return;
+            }
+          }
+
           using ttg::hash;
           auto curhash = hash<keyT>{}(key);
 
@@ -555,6 +1693,7 @@ namespace ttg_madness {
 
             // ttg::print("directly invoking:", get_name(), key, curhash, threaddata.key_hash, threaddata.call_depth);
             ttT::threaddata.call_depth++;
+            detail::task_scope scope(this, &coroutine_resumer);
             if constexpr (!ttg::meta::is_void_v<keyT> && !ttg::meta::is_empty_tuple_v<input_values_tuple_type>) {
               static_cast<derivedT *>(this)->op(key, args->make_input_refs(), output_terminals);  // Runs immediately
             } else if constexpr (!ttg::meta::is_void_v<keyT> && ttg::meta::is_empty_tuple_v<input_values_tuple_type>) {
@@ -565,14 +1704,13 @@ namespace ttg_madness {
               static_cast<derivedT *>(this)->op(output_terminals);  // Runs immediately
             } else
               abort();
+            scope.complete();
             ttT::threaddata.call_depth--;
 
           } else {
             // ttg::print("enqueuing task", get_name(), key, curhash, threaddata.key_hash, threaddata.call_depth);
-            world.impl().impl().taskq.add(args);
+            submit_ready(args);
           }
-
-          cache.erase(acc);
         }
       }
     }
@@ -595,6 +1733,24 @@ namespace ttg_madness {
       set_arg<i, ttg::Void, ttg::Void>(ttg::Void{}, ttg::Void{});
     }
 
+    /// broadcasts an rvalue to the tasks in keylist: remote tasks and all local tasks but one receive copies,
+    /// the last local task takes ownership of the value
+    template <std::size_t i, typename Key, typename Value>
+    std::enable_if_t<!ttg::meta::is_void_v<Key> && !std::is_void_v<std::decay_t<Value>>, void> broadcast_arg(
+        const ttg::span<const Key> &keylist, Value &&value) {
+      const int rank = world.rank();
+      const Key *move_key = nullptr;
+      for (auto &&key : keylist) {
+        if (keymap(key) == rank) {
+          if (nullptr != move_key) set_arg<i, Key, const std::decay_t<Value> &>(*move_key, value);
+          move_key = &key;
+        } else {
+          set_arg<i, Key, const std::decay_t<Value> &>(key, value);
+        }
+      }
+      if (nullptr != move_key) set_arg<i, Key, Value>(*move_key, std::forward<Value>(value));
+    }
+
     // Used by invoke to set all arguments associated with a task
     // Is: index sequence of elements in args
     // Js: index sequence of input terminals to set
@@ -652,49 +1808,46 @@ namespace ttg_madness {
       } else {
         ttg::trace(world.rank(), ":", get_name(), " : setting stream size to ", size, " for terminal ", i);
 
-        accessorT acc;
-        if (cache.insert(acc, 0)) acc->second = new TTArgs();  // It will be deleted by the task q
-        TTArgs *args = acc->second;
-
-        args->lock();
-
-        // check if stream is already bounded
-        if (args->stream_size[i] > 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : error stream is already bounded : ", i);
-          throw std::runtime_error("TT::set_argstream_size called for a bounded stream");
-        }
+        bool inserted;
+        TTArgs *args = find_or_create_args(ttg::Void{}, 0, inserted);
+
+        using state_t = detail::input_state;
+        auto s = args->state[i].load(std::memory_order_acquire);
+        state_t::word_type next;
+        do {
+          // check if stream is already bounded
+          if (state_t::size(s) > 0) {
+            ttg::print_error(world.rank(), ":", get_name(), " : error stream is already bounded : ", i);
+            throw std::runtime_error("TT::set_argstream_size called for a bounded stream");
+          }
 
-        // check if stream is already finalized
-        if (args->nargs[i] == 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : error stream is already finalized : ", i);
-          throw std::runtime_error("TT::set_argstream_size called for a finalized stream");
-        }
+          // check if stream is already finalized
+          if (state_t::finalized(s)) {
+            ttg::print_error(world.rank(), ":", get_name(), " : error stream is already finalized : ", i);
+            throw std::runtime_error("TT::set_argstream_size called for a finalized stream");
+          }
 
-        // commit changes
-        args->stream_size[i] = size;
-        // if messages already received for this key update the expected-received counter
-        const auto messages_received_already = args->nargs[i] != std::numeric_limits<std::int64_t>::max();
-        if (messages_received_already) {
           // cannot have received more messages than expected
-          if (-(args->nargs[i]) > size) {
+          if (state_t::received(s) > size) {
             ttg::print_error(world.rank(), ":", get_name(),
                              " : error stream received more messages than specified via set_argstream_size : ", i);
             throw std::runtime_error("TT::set_argstream_size(n): n less than the number of messages already received");
           }
-          args->nargs[i] += size;
-        }
-        // if done, update the counter
-        if (args->nargs[i] == 0) args->counter--;
-        args->unlock();
 
-        // ready to run the task?
-        if (args->counter == 0) {
-          ttg::trace(world.rank(), ":", get_name(), " : submitting task for op ");
-          args->derived = static_cast<derivedT *>(this);
+          // commit changes; if all messages were received already the stream is done
+          next = state_t::make(size, state_t::received(s), state_t::received(s) == size);
+        } while (!args->state[i].compare_exchange_weak(s, next, std::memory_order_acq_rel, std::memory_order_acquire));
 
-          world.impl().impl().taskq.add(args);
+        // if done, update the counter; ready to run the task?
+        if (state_t::finalized(next)) {
+          combine_stream_partials<i>(args);
+          if (input_finalized(ttg::Void{}, args)) {
+            ttg::trace(world.rank(), ":", get_name(), " : submitting task for op ");
+            erase_args(ttg::Void{});
+            args->derived = static_cast<derivedT *>(this);
 
-          cache.erase(acc);
+            submit_ready(args);
+          }
         }
       }
     }
@@ -734,43 +1887,47 @@ namespace ttg_madness {
       } else {
         ttg::trace(world.rank(), ":", get_name(), " : ", key, ": setting stream size for terminal ", i);
 
-        accessorT acc;
-        if (cache.insert(acc, key)) acc->second = new TTArgs(this->priomap(key));  // It will be deleted by the task q
-        TTArgs *args = acc->second;
-
-        args->lock();
-
-        // check if stream is already bounded
-        if (args->stream_size[i] > 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already bounded : ", i);
-          throw std::runtime_error("TT::set_argstream_size called for a bounded stream");
-        }
-
-        // check if stream is already finalized
-        if (args->nargs[i] == 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already finalized : ", i);
-          throw std::runtime_error("TT::set_argstream_size called for a finalized stream");
-        }
+        bool inserted;
+        TTArgs *args = find_or_create_args(key, this->priomap(key), inserted);
+
+        using state_t = detail::input_state;
+        auto s = args->state[i].load(std::memory_order_acquire);
+        state_t::word_type next;
+        do {
+          // check if stream is already bounded
+          if (state_t::size(s) > 0) {
+            ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already bounded : ", i);
+            throw std::runtime_error("TT::set_argstream_size called for a bounded stream");
+          }
 
-        // commit changes
-        args->stream_size[i] = size;
-        // if messages already received for this key update the expected-received counter
-        const auto messages_received_already = args->nargs[i] != std::numeric_limits<std::int64_t>::max();
-        if (messages_received_already) args->nargs[i] += size;
-        // if done, update the counter
-        if (args->nargs[i] == 0) args->counter--;
+          // check if stream is already finalized
+          if (state_t::finalized(s)) {
+            ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already finalized : ", i);
+            throw std::runtime_error("TT::set_argstream_size called for a finalized stream");
+          }
 
-        args->unlock();
+          // cannot have received more messages than expected
+          if (state_t::received(s) > size) {
+            ttg::print_error(world.rank(), ":", get_name(), " : ", key,
+                             ": error stream received more messages than specified via set_argstream_size : ", i);
+            throw std::runtime_error("TT::set_argstream_size(n): n less than the number of messages already received");
+          }
 
-        // ready to run the task?
-        if (args->counter == 0) {
-          ttg::trace(world.rank(), ":", get_name(), " : ", key, ": submitting task for op ");
-          args->derived = static_cast<derivedT *>(this);
-          args->key = key;
+          // commit changes; if all messages were received already the stream is done
+          next = state_t::make(size, state_t::received(s), state_t::received(s) == size);
+        } while (!args->state[i].compare_exchange_weak(s, next, std::memory_order_acq_rel, std::memory_order_acquire));
 
-          world.impl().impl().taskq.add(args);
+        // if done, update the counter; ready to run the task?
+        if (state_t::finalized(next)) {
+          combine_stream_partials<i>(args);
+          if (input_finalized(key, args)) {
+            ttg::trace(world.rank(), ":", get_name(), " : ", key, ": submitting task for op ");
+            erase_args(key);
+            args->derived = static_cast<derivedT *>(this);
+            args->key = key;
 
-          cache.erase(acc);
+            submit_ready(args);
+          }
         }
       }
     }
@@ -789,37 +1946,43 @@ namespace ttg_madness {
       } else {
         ttg::trace(world.rank(), ":", get_name(), " : ", key, ": finalizing stream for terminal ", i);
 
-        accessorT acc;
-        const auto found = cache.find(acc, key);
-        assert(found && "TT::finalize_argstream called but no values had been received yet for this key");
-        TTGUNUSED(found);
-        TTArgs *args = acc->second;
-
-        // check if stream is already bounded
-        if (args->stream_size[i] > 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error finalize called on bounded stream: ", i);
-          throw std::runtime_error("TT::finalize called for a bounded stream");
+        TTArgs *args;
+        {
+          accessorT acc;
+          const auto found = cache.find(acc, key);
+          assert(found && "TT::finalize_argstream called but no values had been received yet for this key");
+          TTGUNUSED(found);
+          args = acc->second;
         }
 
-        // check if stream is already finalized
-        if (args->nargs[i] == 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already finalized : ", i);
-          throw std::runtime_error("TT::finalize called for a finalized stream");
-        }
+        using state_t = detail::input_state;
+        auto s = args->state[i].load(std::memory_order_acquire);
+        do {
+          // check if stream is already bounded
+          if (state_t::size(s) > 0) {
+            ttg::print_error(world.rank(), ":", get_name(), " : ", key,
+                             ": error finalize called on bounded stream: ", i);
+            throw std::runtime_error("TT::finalize called for a bounded stream");
+          }
 
-        // commit changes
-        args->nargs[i] = 0;
-        args->counter--;
-        // ready to run the task?
-        if (args->counter == 0) {
+          // check if stream is already finalized
+          if (state_t::finalized(s)) {
+            ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": error stream is already finalized : ", i);
+            throw std::runtime_error("TT::finalize called for a finalized stream");
+          }
+        } while (!args->state[i].compare_exchange_weak(s, s | state_t::finalized_bit, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire));
+
+        // commit changes; ready to run the task?
+        combine_stream_partials<i>(args);
+        if (input_finalized(key, args)) {
           ttg::trace(world.rank(), ":", get_name(), " : ", key, ": submitting task for op ");
+          erase_args(key);
           args->derived = static_cast<derivedT *>(this);
           args->key = key;
 
-          world.impl().impl().taskq.add(args);
+          submit_ready(args);
           // static_cast<derivedT*>(this)->op(key, std::move(args->t), output_terminals); // Runs immediately
-
-          cache.erase(acc);
         }
       }
     }
@@ -838,36 +2001,41 @@ namespace ttg_madness {
       } else {
         ttg::trace(world.rank(), ":", get_name(), " : finalizing stream for terminal ", i);
 
-        accessorT acc;
-        const auto found = cache.find(acc, 0);
-        assert(found && "TT::finalize_argstream called but no values had been received yet for this key");
-        TTGUNUSED(found);
-        TTArgs *args = acc->second;
-
-        // check if stream is already bounded
-        if (args->stream_size[i] > 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : error finalize called on bounded stream: ", i);
-          throw std::runtime_error("TT::finalize called for a bounded stream");
+        TTArgs *args;
+        {
+          accessorT acc;
+          const auto found = cache.find(acc, 0);
+          assert(found && "TT::finalize_argstream called but no values had been received yet for this key");
+          TTGUNUSED(found);
+          args = acc->second;
         }
 
-        // check if stream is already finalized
-        if (args->nargs[i] == 0) {
-          ttg::print_error(world.rank(), ":", get_name(), " : error stream is already finalized : ", i);
-          throw std::runtime_error("TT::finalize called for a finalized stream");
-        }
+        using state_t = detail::input_state;
+        auto s = args->state[i].load(std::memory_order_acquire);
+        do {
+          // check if stream is already bounded
+          if (state_t::size(s) > 0) {
+            ttg::print_error(world.rank(), ":", get_name(), " : error finalize called on bounded stream: ", i);
+            throw std::runtime_error("TT::finalize called for a bounded stream");
+          }
 
-        // commit changes
-        args->nargs[i] = 0;
-        args->counter--;
-        // ready to run the task?
-        if (args->counter == 0) {
+          // check if stream is already finalized
+          if (state_t::finalized(s)) {
+            ttg::print_error(world.rank(), ":", get_name(), " : error stream is already finalized : ", i);
+            throw std::runtime_error("TT::finalize called for a finalized stream");
+          }
+        } while (!args->state[i].compare_exchange_weak(s, s | state_t::finalized_bit, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire));
+
+        // commit changes; ready to run the task?
+        combine_stream_partials<i>(args);
+        if (input_finalized(ttg::Void{}, args)) {
           ttg::trace(world.rank(), ":", get_name(), " : submitting task for op ");
+          erase_args(ttg::Void{});
           args->derived = static_cast<derivedT *>(this);
 
-          world.impl().impl().taskq.add(args);
+          submit_ready(args);
           // static_cast<derivedT*>(this)->op(key, std::move(args->t), output_terminals); // Runs immediately
-
-          cache.erase(acc);
         }
       }
     }
@@ -896,6 +2064,14 @@ namespace ttg_madness {
 
       if (input.is_pull_terminal) {
         num_pullins++;
+        if constexpr (!ttg::meta::is_void_v<keyT> && i < std::tuple_size_v<input_values_tuple_type>) {
+          std::get<i>(pull_states).bind(input.container.element_hash, input.container.same_element);
+          world.impl().add_fence_hook(this, [this]() { clear_pull_states(); });
+        }
+      }
+
+      if constexpr (!ttg::meta::is_void_v<keyT>) {
+        input.set_keymap_callback([this](const keyT &key) { return keymap(key); });
       }
 
       //////////////////////////////////////////////////////////////////
@@ -911,7 +2087,19 @@ namespace ttg_madness {
         };
         auto setsize_callback = [this](const keyT &key, std::size_t size) { set_argstream_size<i>(key, size); };
         auto finalize_callback = [this](const keyT &key) { finalize_argstream<i>(key); };
-        input.set_callback(send_callback, move_callback, {}, setsize_callback, finalize_callback);
+        auto move_broadcast_callback = [this](const ttg::span<const keyT> &keylist, valueT &&value) {
+          broadcast_arg<i, keyT, valueT>(keylist, std::forward<valueT>(value));
+        };
+        input.set_callback(send_callback, move_callback, {}, setsize_callback, finalize_callback,
+                           move_broadcast_callback);
+        input.set_static_callback(
+            this,
+            [](void *tt, const keyT &key, const valueT &value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, const valueT &>(key, value);
+            },
+            [](void *tt, const keyT &key, valueT &&value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, valueT>(key, std::forward<valueT>(value));
+            });
       }
       //////////////////////////////////////////////////////////////////
       // case 4: void key, nonvoid value
@@ -923,6 +2111,14 @@ namespace ttg_madness {
         auto setsize_callback = [this](std::size_t size) { set_argstream_size<i>(size); };
         auto finalize_callback = [this]() { finalize_argstream<i>(); };
         input.set_callback(send_callback, move_callback, {}, setsize_callback, finalize_callback);
+        input.set_static_callback(
+            this,
+            [](void *tt, const valueT &value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, const valueT &>(value);
+            },
+            [](void *tt, valueT &&value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, valueT>(std::forward<valueT>(value));
+            });
       }
       //////////////////////////////////////////////////////////////////
       // case 2: nonvoid key, void value, mixed inputs
@@ -933,6 +2129,10 @@ namespace ttg_madness {
         auto setsize_callback = [this](const keyT &key, std::size_t size) { set_argstream_size<i>(key, size); };
         auto finalize_callback = [this](const keyT &key) { finalize_argstream<i>(key); };
         input.set_callback(send_callback, send_callback, {}, setsize_callback, finalize_callback);
+        auto static_send_callback = [](void *tt, const keyT &key) {
+          static_cast<TT *>(tt)->template set_arg<i, keyT, void>(key);
+        };
+        input.set_static_callback(this, static_send_callback, static_send_callback);
       }
       //////////////////////////////////////////////////////////////////
       // case 5: void key, void value, mixed inputs
@@ -943,6 +2143,8 @@ namespace ttg_madness {
         auto setsize_callback = [this](std::size_t size) { set_argstream_size<i>(size); };
         auto finalize_callback = [this]() { finalize_argstream<i>(); };
         input.set_callback(send_callback, send_callback, {}, setsize_callback, finalize_callback);
+        auto static_send_callback = [](void *tt) { static_cast<TT *>(tt)->template set_arg<i, keyT, void>(); };
+        input.set_static_callback(this, static_send_callback, static_send_callback);
       } else
         abort();
     }
@@ -1052,6 +2254,8 @@ namespace ttg_madness {
 
     // Destructor checks for unexecuted tasks
     virtual ~TT() {
+      if (world.is_valid() && world.impl().broadcast_relay()) world.impl().broadcast_relay()->deregister_tt(this);
+      if (world.is_valid()) world.impl().remove_fence_hook(this);
       if (cache.size() != 0) {
         std::cerr << world.rank() << ":"
                   << "warning: unprocessed tasks in destructor of operation '" << get_name()
@@ -1067,7 +2271,7 @@ namespace ttg_madness {
           using ::madness::operators::operator<<;
           std::cerr << world.rank() << ":"
                     << "   unused: " << item.first << " : ( ";
-          for (std::size_t i = 0; i < numins; i++) std::cerr << (item.second->nargs[i] == 0 ? "T" : "F") << " ";
+          for (std::size_t i = 0; i < numins; i++) std::cerr << (item.second->finalized(i) ? "T" : "F") << " ";
           std::cerr << ")" << std::endl;
         }
         abort();
@@ -1113,10 +2317,29 @@ namespace ttg_madness {
       priomap = std::forward<Priomap>(pm);
     }
 
+    auto get_affinitymap(void) const { return affinitymap; }
+
+    /// Set the affinity map, mapping a Key to the index of the thread that should preferably execute the task
+    /// (modulo the number of threads). Ready tasks are queued for the preferred thread; idle threads steal from
+    /// the queues of other threads, hence the map is only a hint that keeps e.g. successive updates of the same
+    /// data on the same core. Not set by default.
+    template <typename Affinitymap>
+    void set_affinitymap(Affinitymap &&am) {
+      affinitymap = std::forward<Affinitymap>(am);
+    }
+
+    /// implementation of TTBase::is_fusable(): tasks with a single (push) input can run inside their producer's task,
+    /// unless they are executed in batches
+    bool is_fusable() const override {
+      return numins == 1 && num_pullins == 0 && !(derived_has_op_batch() && this->get_batch_size() > 1);
+    }
+
     /// implementation of TTBase::make_executable()
     void make_executable() override {
       TTBase::make_executable();
+      if (this->is_relocatable()) world.impl().load_balancer()->enable();
       this->process_pending();
+      world.impl().broadcast_relay()->register_tt(this);
     }
 
     /// Waits for the entire TTG associated with this TT to be completed (collective)
@@ -1189,6 +2412,35 @@ namespace ttg_madness {
         TTBase::invoke();
     }
 
+#ifdef TTG_HAVE_COROUTINE
+    /// Pulls the element of the container of pull terminal \c i that \p key maps to, for a coroutine body (see
+    /// ttg::task) that awaits it, e.g. to read the elements of neighboring keys besides its own input.
+    /// A remote element is requested like the inputs of the tasks, i.e. the request is coalesced with the other
+    /// requests for the same element and batched per owner rank.
+    /// @return the value that will hold the element
+    template <std::size_t i, typename Key = keyT>
+    std::enable_if_t<!ttg::meta::is_void_v<Key>, ttg::async_value<std::tuple_element_t<i, input_values_tuple_type>>>
+    pull(const Key &key) {
+      using valueT = std::tuple_element_t<i, input_values_tuple_type>;
+      TTG_OP_ASSERT_EXECUTABLE();
+      auto &in = std::get<i>(input_terminals);
+      if (!in.is_pull_terminal) {
+        ttg::print_error(world.rank(), ":", get_name(), " : ", key, ": input ", i, " is not a pull terminal");
+        throw std::logic_error("TT::pull called for an input that is not a pull terminal");
+      }
+      ttg::async_value<valueT> result;
+      const int owner = in.container.owner(key);
+      if (owner == world.rank()) {
+        result.set_value(in.container.get(key));
+      } else if (auto value = request_pull<i>(key, owner, [result](const valueT &value) mutable {
+                   result.set_value(value);
+                 })) {
+        result.set_value(std::move(*value));
+      }
+      return result;
+    }
+#endif  // TTG_HAVE_COROUTINE
+
     void set_defer_writer(bool _) {}
 
     bool get_defer_writer(bool _) { return false; }
@@ -1217,6 +2469,85 @@ namespace ttg_madness {
 
 }  // namespace ttg_madness
 
+/// Fuses a broadcast to several output terminals: the keys are grouped by the rank that owns them, and each remote
+/// rank receives a single message holding the value and the keys of every successor of every terminal on that rank
+template <>
+struct ttg::detail::multi_broadcast_handler<ttg::Runtime::MADWorld> {
+  template <typename... RangesT, typename Value, typename... OutsT>
+  void operator()(const std::tuple<RangesT...> &keylists, Value &&value,
+                  const std::tuple<OutsT *...> &terminals) const {
+    auto world = ttg::default_execution_context();
+    ttg::TTBase *tt = std::get<0>(terminals)->get_tt();
+    const bool same_tt = std::apply([tt](auto *...out) { return ((out->get_tt() == tt) && ...); }, terminals);
+    if (world.size() == 1 || !same_tt || !tt->is_executable()) {
+      ttg::detail::broadcast_each(keylists, std::forward<Value>(value), terminals);
+      return;
+    }
+
+    using relay_t = ttg_madness::detail::broadcast_relay;
+    using table_t = std::tuple<relay_t::terminal_keys_t<typename OutsT::key_type>...>;
+    auto make_table = [&terminals]() {
+      table_t table;
+      set_terminal_indices(table, terminals, std::index_sequence_for<OutsT...>{});
+      return table;
+    };
+    // keys owned by this rank, or by successors that cannot report the owner (those keys are routed by the terminal)
+    table_t local = make_table();
+    std::map<int, table_t> remote;
+    group_keys(keylists, terminals, world.rank(), local, remote, make_table, std::index_sequence_for<OutsT...>{});
+
+    auto &relay = *world.impl().broadcast_relay();
+    for (auto &&[owner, table] : remote) {
+      relay.send(owner, &relay_t::template deliver<std::decay_t<Value>, typename OutsT::key_type...>,
+                 tt->get_instance_id(), table, static_cast<const std::remove_reference_t<Value> &>(value));
+    }
+    relay_t::deliver_table(tt, local, std::forward<Value>(value));
+  }
+
+ private:
+  template <typename Table, typename... OutsT, std::size_t... J>
+  static void set_terminal_indices(Table &table, const std::tuple<OutsT *...> &terminals, std::index_sequence<J...>) {
+    ((std::get<J>(table).first = std::get<J>(terminals)->get_index()), ...);
+  }
+
+  template <typename... RangesT, typename... OutsT, typename Table, typename MakeTable, std::size_t... J>
+  static void group_keys(const std::tuple<RangesT...> &keylists, const std::tuple<OutsT *...> &terminals, int rank,
+                         Table &local, std::map<int, Table> &remote, const MakeTable &make_table,
+                         std::index_sequence<J...>) {
+    (group_keys<J>(std::get<J>(keylists), std::get<J>(terminals), rank, local, remote, make_table), ...);
+  }
+
+  /// appends the keys in \p keylist to the tables of the ranks that own them, for each successor of \p out
+  template <std::size_t J, typename RangeT, typename Out, typename Table, typename MakeTable>
+  static void group_keys(const RangeT &keylist, const Out *out, int rank, Table &local, std::map<int, Table> &remote,
+                         const MakeTable &make_table) {
+    using key_t = typename Out::key_type;
+    for (auto *successor : out->successors()) {
+      auto *in = static_cast<const ttg::InTerminalBase<key_t> *>(successor);
+      const auto id = ttg_madness::detail::broadcast_relay::successor_id(in);
+      auto add = [&](const key_t &key) {
+        const int owner = in->has_owner() ? in->owner(key) : rank;
+        auto *table = &local;
+        if (owner != rank) {
+          auto it = remote.find(owner);
+          if (it == remote.end()) it = remote.emplace(owner, make_table()).first;
+          table = &it->second;
+        }
+        auto &successor_keys = std::get<J>(*table).second;
+        if (successor_keys.empty() || successor_keys.back().first != id) {
+          successor_keys.emplace_back(id, std::vector<key_t>{});
+        }
+        successor_keys.back().second.push_back(key);
+      };
+      if constexpr (ttg::meta::is_iterable_v<RangeT>) {
+        for (auto &&key : keylist) add(key);
+      } else {
+        add(keylist);
+      }
+    }
+  }
+};
+
 #include "ttg/madness/watch.h"
 
 #endif  // MADNESS_TTG_H_INCLUDED
@@ -141,58 +141,69 @@ class CallableWrapTTArgs
   using noref_funcT = std::remove_reference_t<funcT>;
   std::conditional_t<std::is_function_v<noref_funcT>, std::add_pointer_t<noref_funcT>, noref_funcT> func;
 
+  // points the thread-local output terminals to those of this TT for the lifetime of this object
+  class outputs_tls_scope {
+    const std::vector<ttg::TerminalBase *> *old_output_tls_ptr;
+    CallableWrapTTArgs *tt;
+
+   public:
+    explicit outputs_tls_scope(CallableWrapTTArgs *tt) : old_output_tls_ptr(tt->outputs_tls_ptr_accessor()), tt(tt) {
+      tt->set_outputs_tls_ptr();
+    }
+    ~outputs_tls_scope() { tt->set_outputs_tls_ptr(old_output_tls_ptr); }
+  };
+
   template <typename Key, typename Tuple, std::size_t... S>
-  void call_func(Key &&key, Tuple &&args_tuple, output_terminalsT &out, std::index_sequence<S...>) {
+  auto call_func(Key &&key, Tuple &&args_tuple, output_terminalsT &out, std::index_sequence<S...>) {
     using func_args_t = ttg::meta::tuple_concat_t<std::tuple<const Key &>, input_refs_tuple_type, output_edges_type>;
     if constexpr (funcT_receives_outterm_tuple)
-      func(std::forward<Key>(key),
-           baseT::template get<S, std::tuple_element_t<S + 1, func_args_t>>(std::forward<Tuple>(args_tuple))..., out);
+      return func(std::forward<Key>(key),
+                  baseT::template get<S, std::tuple_element_t<S + 1, func_args_t>>(std::forward<Tuple>(args_tuple))...,
+                  out);
     else {
-      auto old_output_tls_ptr = this->outputs_tls_ptr_accessor();
-      this->set_outputs_tls_ptr();
-      func(std::forward<Key>(key),
-           baseT::template get<S, std::tuple_element_t<S + 1, func_args_t>>(std::forward<Tuple>(args_tuple))...);
-      this->set_outputs_tls_ptr(old_output_tls_ptr);
+      outputs_tls_scope scope(this);
+      return func(std::forward<Key>(key),
+                  baseT::template get<S, std::tuple_element_t<S + 1, func_args_t>>(std::forward<Tuple>(args_tuple))...);
     }
   }
 
   template <typename Tuple, std::size_t... S>
-  void call_func(Tuple &&args_tuple, output_terminalsT &out, std::index_sequence<S...>) {
+  auto call_func(Tuple &&args_tuple, output_terminalsT &out, std::index_sequence<S...>) {
     using func_args_t = ttg::meta::tuple_concat_t<input_refs_tuple_type, output_edges_type>;
     if constexpr (funcT_receives_outterm_tuple)
-      func(baseT::template get<S, std::tuple_element_t<S, func_args_t>>(std::forward<Tuple>(args_tuple))..., out);
+      return func(baseT::template get<S, std::tuple_element_t<S, func_args_t>>(std::forward<Tuple>(args_tuple))...,
+                  out);
     else {
-      auto old_output_tls_ptr = this->outputs_tls_ptr_accessor();
-      this->set_outputs_tls_ptr();
-      func(baseT::template get<S, std::tuple_element_t<S, func_args_t>>(std::forward<Tuple>(args_tuple))...);
-      this->set_outputs_tls_ptr(old_output_tls_ptr);
+      outputs_tls_scope scope(this);
+      return func(baseT::template get<S, std::tuple_element_t<S, func_args_t>>(std::forward<Tuple>(args_tuple))...);
     }
   }
 
   template <typename Key>
-  void call_func(Key &&key, output_terminalsT &out) {
+  auto call_func(Key &&key, output_terminalsT &out) {
     if constexpr (funcT_receives_outterm_tuple)
-      func(std::forward<Key>(key), out);
+      return func(std::forward<Key>(key), out);
     else {
-      auto old_output_tls_ptr = this->outputs_tls_ptr_accessor();
-      this->set_outputs_tls_ptr();
-      func(std::forward<Key>(key));
-      this->set_outputs_tls_ptr(old_output_tls_ptr);
+      outputs_tls_scope scope(this);
+      return func(std::forward<Key>(key));
     }
   }
 
   template <typename OutputTerminals>
-  void call_func(OutputTerminals &out) {
+  auto call_func(OutputTerminals &out) {
     if constexpr (funcT_receives_outterm_tuple)
-      func(out);
+      return func(out);
     else {
-      auto old_output_tls_ptr = this->outputs_tls_ptr_accessor();
-      this->set_outputs_tls_ptr();
-      func();
-      this->set_outputs_tls_ptr(old_output_tls_ptr);
+      outputs_tls_scope scope(this);
+      return func();
     }
   }
 
+  template <std::size_t... S>
+  static input_refs_tuple_type make_input_refs(input_values_tuple_type &values, std::index_sequence<S...>) {
+    return input_refs_tuple_type{baseT::template get<S, std::tuple_element_t<S, input_refs_tuple_type>>(values)...};
+  }
+
   template <typename Tuple, std::size_t... I>
   static auto make_output_terminal_ptrs(const Tuple &output_terminals, std::index_sequence<I...>) {
     return std::array<ttg::TerminalBase *, sizeof...(I)>{
@@ -217,8 +228,18 @@ class CallableWrapTTArgs
                    void>
   op(Key &&key, ArgsTuple &&args_tuple, output_terminalsT &out) {
     assert(&out == &baseT::get_output_terminals());
-    call_func(std::forward<Key>(key), std::forward<ArgsTuple>(args_tuple), out,
-              std::make_index_sequence<std::tuple_size_v<ArgsTuple>>{});
+    using seq_t = std::make_index_sequence<std::tuple_size_v<ArgsTuple>>;
+    using result_t = decltype(call_func(std::forward<Key>(key), std::forward<ArgsTuple>(args_tuple), out, seq_t{}));
+    if constexpr (ttg::detail::is_task_v<result_t>) {
+      static_assert(detail::supports_coroutine_bodies && ttg::detail::is_task_v<result_t>,
+                    "coroutine TT bodies (returning ttg::task<>) are not supported by this backend");
+      // a coroutine body refers to its arguments after it suspends, hence they are moved to storage it keeps alive
+      auto args = std::make_shared<std::pair<std::decay_t<Key>, input_values_tuple_type>>(
+          std::forward<Key>(key), std::forward<ArgsTuple>(args_tuple));
+      call_func(std::as_const(args->first), make_input_refs(args->second, seq_t{}), out, seq_t{})
+          .keep_alive(std::move(args));
+    } else
+      call_func(std::forward<Key>(key), std::forward<ArgsTuple>(args_tuple), out, seq_t{});
   };
 
   template <typename ArgsTuple, typename Key = keyT>
@@ -227,14 +248,28 @@ class CallableWrapTTArgs
                    void>
   op(ArgsTuple &&args_tuple, output_terminalsT &out) {
     assert(&out == &baseT::get_output_terminals());
-    call_func(std::forward<ArgsTuple>(args_tuple), out, std::make_index_sequence<std::tuple_size_v<ArgsTuple>>{});
+    using seq_t = std::make_index_sequence<std::tuple_size_v<ArgsTuple>>;
+    using result_t = decltype(call_func(std::forward<ArgsTuple>(args_tuple), out, seq_t{}));
+    if constexpr (ttg::detail::is_task_v<result_t>) {
+      static_assert(detail::supports_coroutine_bodies && ttg::detail::is_task_v<result_t>,
+                    "coroutine TT bodies (returning ttg::task<>) are not supported by this backend");
+      auto args = std::make_shared<input_values_tuple_type>(std::forward<ArgsTuple>(args_tuple));
+      call_func(make_input_refs(*args, seq_t{}), out, seq_t{}).keep_alive(std::move(args));
+    } else
+      call_func(std::forward<ArgsTuple>(args_tuple), out, seq_t{});
   };
 
   template <typename Key, typename ArgsTuple = input_refs_tuple_type>
   std::enable_if_t<ttg::meta::is_empty_tuple_v<ArgsTuple> && !ttg::meta::is_void_v<Key>, void> op(
       Key &&key, output_terminalsT &out) {
     assert(&out == &baseT::get_output_terminals());
-    call_func(std::forward<Key>(key), out);
+    if constexpr (ttg::detail::is_task_v<decltype(call_func(std::forward<Key>(key), out))>) {
+      static_assert(detail::supports_coroutine_bodies && !ttg::meta::is_void_v<Key>,
+                    "coroutine TT bodies (returning ttg::task<>) are not supported by this backend");
+      auto key_copy = std::make_shared<std::decay_t<Key>>(std::forward<Key>(key));
+      call_func(std::as_const(*key_copy), out).keep_alive(std::move(key_copy));
+    } else
+      call_func(std::forward<Key>(key), out);
   };
 
   template <typename Key = keyT, typename ArgsTuple = input_refs_tuple_type>
@@ -265,6 +300,91 @@ struct CallableWrapTTArgsAsTypelist<funcT, funcT_receives_outterm_tuple, keyT, o
                                   std::remove_reference_t<input_valuesT>...>;
 };
 
+// Class to wrap a callable that executes a batch of tasks at once, with signature
+//
+// void op(ttg::span<const keyT> keys, ttg::span<std::tuple<input_valuesT...>> args, std::tuple<output_terminalsT...>&)
+//
+// where args[i] holds the (consumable) input values of the task with key keys[i], see TTBase::set_batch_size
+//
+template <typename funcT, bool funcT_receives_outterm_tuple, typename keyT, typename output_terminalsT,
+          typename... input_valuesT>
+class CallableWrapTTBatch
+    : public TT<keyT, output_terminalsT,
+                CallableWrapTTBatch<funcT, funcT_receives_outterm_tuple, keyT, output_terminalsT, input_valuesT...>,
+                ttg::typelist<input_valuesT...>> {
+  static_assert(!ttg::meta::is_void_v<keyT>, "CallableWrapTTBatch: batches of tasks require a nonvoid task id");
+  using baseT = typename CallableWrapTTBatch::ttT;
+
+  using input_values_tuple_type = typename baseT::input_values_tuple_type;
+  using input_refs_tuple_type = typename baseT::input_refs_tuple_type;
+  using input_edges_type = typename baseT::input_edges_type;
+  using output_edges_type = typename baseT::output_edges_type;
+
+  using noref_funcT = std::remove_reference_t<funcT>;
+  std::conditional_t<std::is_function_v<noref_funcT>, std::add_pointer_t<noref_funcT>, noref_funcT> func;
+
+ public:
+  template <typename funcT_>
+  CallableWrapTTBatch(funcT_ &&f, const input_edges_type &inedges, const output_edges_type &outedges,
+                      const std::string &name, const std::vector<std::string> &innames,
+                      const std::vector<std::string> &outnames)
+      : baseT(inedges, outedges, name, innames, outnames), func(std::forward<funcT_>(f)) {}
+
+  template <typename funcT_>
+  CallableWrapTTBatch(funcT_ &&f, const std::string &name, const std::vector<std::string> &innames,
+                      const std::vector<std::string> &outnames)
+      : baseT(name, innames, outnames), func(std::forward<funcT_>(f)) {}
+
+  void op_batch(ttg::span<const keyT> keys, ttg::span<input_values_tuple_type> args, output_terminalsT &out) {
+    assert(keys.size() == args.size());
+    if constexpr (funcT_receives_outterm_tuple)
+      func(keys, args, out);
+    else {
+      auto old_output_tls_ptr = this->outputs_tls_ptr_accessor();
+      this->set_outputs_tls_ptr();
+      func(keys, args);
+      this->set_outputs_tls_ptr(old_output_tls_ptr);
+    }
+  }
+
+  // a single task is executed as a batch of one, this is used if batching is disabled or not supported by the backend
+  template <typename Key, typename ArgsTuple>
+  std::enable_if_t<std::is_same_v<ArgsTuple, input_refs_tuple_type> && !ttg::meta::is_empty_tuple_v<ArgsTuple> &&
+                       !ttg::meta::is_void_v<Key>,
+                   void>
+  op(Key &&key, ArgsTuple &&args_tuple, output_terminalsT &out) {
+    input_values_tuple_type args(std::forward<ArgsTuple>(args_tuple));
+    op_batch(ttg::span<const keyT>(&key, 1), ttg::span<input_values_tuple_type>(&args, 1), out);
+  }
+
+  template <typename Key, typename ArgsTuple = input_values_tuple_type>
+  std::enable_if_t<ttg::meta::is_empty_tuple_v<ArgsTuple> && !ttg::meta::is_void_v<Key>, void> op(
+      Key &&key, output_terminalsT &out) {
+    input_values_tuple_type args;
+    op_batch(ttg::span<const keyT>(&key, 1), ttg::span<input_values_tuple_type>(&args, 1), out);
+  }
+};
+
+namespace detail {
+  /// true if \c funcT executes a batch of tasks, i.e. is a nongeneric callable with signature
+  /// `void(ttg::span<const keyT>, ttg::span<input_values_tupleT>[, output_terminalsT&])`
+  template <typename funcT, typename keyT, typename input_values_tupleT, typename output_terminalsT,
+            typename Enabler = void>
+  inline constexpr bool is_batch_callable_v = false;
+  template <typename funcT, typename keyT, typename input_values_tupleT, typename output_terminalsT>
+  inline constexpr bool is_batch_callable_v<
+      funcT, keyT, input_values_tupleT, output_terminalsT,
+      std::enable_if_t<!ttg::meta::is_void_v<keyT> && !ttg::meta::is_generic_callable_v<funcT>>> =
+      std::is_invocable_v<funcT, ttg::span<const keyT>, ttg::span<input_values_tupleT>, output_terminalsT &> ||
+      std::is_invocable_v<funcT, ttg::span<const keyT>, ttg::span<input_values_tupleT>>;
+
+  template <typename funcT, typename keyT, typename output_terminalsT, typename... input_edge_valuesT>
+  inline constexpr bool is_batch_callable_for_edges_v =
+      is_batch_callable_v<funcT, keyT,
+                          ttg::meta::drop_void_t<std::tuple<std::decay_t<input_edge_valuesT>...>>,
+                          output_terminalsT>;
+}  // namespace detail
+
 // clang-format off
 /// @brief Factory function to assist in wrapping a callable with signature
 ///
@@ -417,8 +537,18 @@ auto make_tt_tpl(funcT &&func, const std::tuple<ttg::Edge<keyT, input_edge_value
 ///
 /// @warning Although generic arguments annotated by `const auto&` are also permitted, their use is discouraged to avoid confusion;
 ///          namely, `const auto&` denotes a _consumable_ argument, NOT read-only, despite the `const`.
+///
+/// @note With C++20 and the MADNESS backend @p func can be a coroutine returning `ttg::task<>` that can `co_await`
+///       values that become available later (see ttg::async_value, e.g. the elements returned by TT::pull); while
+///       suspended it does not occupy a worker thread. Generic coroutines must declare the return type explicitly,
+///       e.g. `[](auto& key, auto&& datum) -> ttg::task<> { ... }`.
 // clang-format on
-template <typename keyT = void, typename funcT, typename... input_edge_valuesT, typename... output_edgesT>
+template <typename keyT = void, typename funcT, typename... input_edge_valuesT, typename... output_edgesT,
+          std::enable_if_t<!detail::is_batch_callable_for_edges_v<
+                               funcT, keyT,
+                               typename ttg::edges_to_output_terminals<std::tuple<output_edgesT...>>::type,
+                               input_edge_valuesT...>,
+                           bool> = true>
 auto make_tt(funcT &&func, const std::tuple<ttg::Edge<keyT, input_edge_valuesT>...> &inedges = std::tuple<>{},
              const std::tuple<output_edgesT...> &outedges = std::tuple<>{}, const std::string &name = "wrapper",
              const std::vector<std::string> &innames = std::vector<std::string>(sizeof...(input_edge_valuesT), "input"),
@@ -493,6 +623,46 @@ auto make_tt(funcT &&func, const std::tuple<ttg::Edge<keyT, input_edge_valuesT>.
   return std::make_unique<wrapT>(std::forward<funcT>(func), inedges, outedges, name, innames, outnames);
 }
 
+// clang-format off
+/// @brief Factory function to assist in wrapping a callable that executes a batch of tasks at once
+///
+/// This overload is selected if @p func is a nongeneric callable with signature
+///   - `void(ttg::span<const keyT> keys, ttg::span<std::tuple<input_valuesT...>> args, std::tuple<output_terminalsT...>&)`: full form, or
+///   - `void(ttg::span<const keyT> keys, ttg::span<std::tuple<input_valuesT...>> args)`: simplified form,
+///
+/// where `args[i]` holds the input values (which can be consumed) of the task with id `keys[i]` (the inputs of
+/// void type do not appear in the tuple).
+/// The tasks are batched once the maximum batch size has been set by TTBase::set_batch_size(); until then
+/// @p func is invoked with one task at a time. Only the MADNESS backend supports batching.
+/// @param[in] func a callable object
+/// @param[in] inedges a tuple of input edges
+/// @param[in] outedges a tuple of output edges
+/// @param[in] name a string label for the resulting TT
+/// @param[in] innames string labels for the respective input terminals of the resulting TT
+/// @param[in] outnames string labels for the respective output terminals of the resulting TT
+// clang-format on
+template <typename keyT = void, typename funcT, typename... input_edge_valuesT, typename... output_edgesT,
+          std::enable_if_t<detail::is_batch_callable_for_edges_v<
+                               funcT, keyT,
+                               typename ttg::edges_to_output_terminals<std::tuple<output_edgesT...>>::type,
+                               input_edge_valuesT...>,
+                           bool> = true>
+auto make_tt(funcT &&func, const std::tuple<ttg::Edge<keyT, input_edge_valuesT>...> &inedges = std::tuple<>{},
+             const std::tuple<output_edgesT...> &outedges = std::tuple<>{}, const std::string &name = "wrapper",
+             const std::vector<std::string> &innames = std::vector<std::string>(sizeof...(input_edge_valuesT), "input"),
+             const std::vector<std::string> &outnames = std::vector<std::string>(sizeof...(output_edgesT), "output")) {
+  static_assert(ttg::meta::is_none_Void_v<input_edge_valuesT...>, "ttg::Void is for internal use only, do not use it");
+  using output_terminals_type = typename ttg::edges_to_output_terminals<std::tuple<output_edgesT...>>::type;
+  using input_values_tuple_type = ttg::meta::drop_void_t<std::tuple<std::decay_t<input_edge_valuesT>...>>;
+  constexpr bool have_outterm_tuple =
+      std::is_invocable_v<funcT, ttg::span<const keyT>, ttg::span<input_values_tuple_type>, output_terminals_type &>;
+  // the inputs of a batch are consumable, hence nonconst
+  using wrapT = CallableWrapTTBatch<funcT, have_outterm_tuple, keyT, output_terminals_type,
+                                    std::decay_t<input_edge_valuesT>...>;
+
+  return std::make_unique<wrapT>(std::forward<funcT>(func), inedges, outedges, name, innames, outnames);
+}
+
 template <typename keyT, typename funcT, typename... input_valuesT, typename... output_edgesT>
 [[deprecated("use make_tt_tpl instead")]] inline auto wrapt(
     funcT &&func, const std::tuple<ttg::Edge<keyT, input_valuesT>...> &inedges,
@@ -4,7 +4,9 @@
 #include "ttg/fwd.h"
 #include "ttg/util/typelist.h"
 
+#include <cstddef>
 #include <future>
+#include <vector>
 
 extern "C" struct parsec_context_s;
 
@@ -51,6 +53,21 @@ namespace ttg_parsec {
   template <typename T>
   static void ttg_broadcast(ttg::World world, T &data, int source_rank);
 
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T &value, Op &&op);
+
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T *values, std::size_t n, Op &&op);
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T &value, Op &&op, int root);
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T *values, std::size_t n, Op &&op, int root);
+
+  template <typename T>
+  inline std::vector<T> ttg_gather(ttg::World world, const T &value, int root);
+
 }  // namespace ttg_parsec
 
 #endif  // TTG_PARSEC_FWD_H
@@ -25,6 +25,7 @@
 #include "ttg/util/hash.h"
 #include "ttg/util/meta.h"
 #include "ttg/util/meta/callable.h"
+#include "ttg/util/mpi_collectives.h"
 #include "ttg/util/print.h"
 #include "ttg/util/trace.h"
 #include "ttg/util/typelist.h"
@@ -35,6 +36,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <experimental/type_traits>
@@ -42,6 +44,7 @@
 #include <future>
 #include <iostream>
 #include <list>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -97,6 +100,10 @@ namespace ttg_parsec {
   inline std::mutex static_map_mutex;
   typedef std::tuple<int, void *, size_t> static_set_arg_fct_arg_t;
   inline std::multimap<uint64_t, static_set_arg_fct_arg_t> delayed_unpack_actions;
+  /// the current epoch of the taskpool, i.e. the number of fences it went through if `TTG_PARSEC_FENCE_EPOCH` is
+  /// defined (otherwise fences re-create the taskpool and the epoch stays 0); every message carries the epoch in
+  /// which it was sent
+  inline std::atomic<uint32_t> taskpool_epoch = 0;
 
   struct msg_header_t {
     typedef enum {
@@ -105,6 +112,7 @@ namespace ttg_parsec {
       MSG_FINALIZE_ARGSTREAM_SIZE = 2,
       MSG_GET_FROM_PULL =3 } fn_id_t;
     uint32_t taskpool_id;
+    uint32_t epoch;
     uint64_t op_id;
     fn_id_t fn_id;
     int32_t param_id;
@@ -115,6 +123,10 @@ namespace ttg_parsec {
 
   namespace detail {
 
+    /// true if the TTs of this backend can have coroutine bodies (see ttg::task); the PaRSEC backend cannot resume
+    /// suspended bodies yet
+    inline constexpr bool supports_coroutine_bodies = false;
+
     static int static_unpack_msg(parsec_comm_engine_t *ce, uint64_t tag, void *data, long unsigned int size,
                                  int src_rank, void *obj) {
       static_set_arg_fct_type static_set_arg_fct;
@@ -129,6 +141,9 @@ namespace ttg_parsec {
       }
       tp = parsec_taskpool_lookup(msg->taskpool_id);
       assert(NULL != tp);
+      // no message crosses a fence: the previous epoch terminated before the fence completed, and the next one only
+      // starts sending once every process advanced its epoch (see WorldImpl::start_epoch())
+      assert(msg->epoch == taskpool_epoch.load(std::memory_order_relaxed));
       static_map_mutex.lock();
       try {
         auto op_pair = static_id_to_op_map.at(op_id);
@@ -231,6 +246,8 @@ namespace ttg_parsec {
       parsec_ce.tag_register(_PARSEC_TTG_TAG, &detail::static_unpack_msg, this, PARSEC_TTG_MAX_AM_SIZE);
       parsec_ce.tag_register(_PARSEC_TTG_RMA_TAG, &detail::get_remote_complete_cb, this, 128);
 
+      MPI_Comm_dup(comm(), &m_collectives_comm);
+
       create_tpool();
     }
 
@@ -289,6 +306,10 @@ namespace ttg_parsec {
 
     MPI_Comm comm() const { return MPI_COMM_WORLD; }
 
+    /// @return the communicator of the collectives of ttg::World (see ttg::detail::mpi), a duplicate of comm() made
+    ///         once, so that their messages cannot match those of the application or of PaRSEC
+    MPI_Comm collectives_comm() const { return m_collectives_comm; }
+
     virtual void execute() override {
       if (!parsec_taskpool_started) {
         parsec_enqueue(ctx, tpool);
@@ -327,6 +348,7 @@ namespace ttg_parsec {
         release_ops();
         ttg::detail::deregister_world(*this);
         destroy_tpool();
+        MPI_Comm_free(&m_collectives_comm);
         if (own_ctx) {
           unregister_parsec_tags(nullptr);
         } else {
@@ -457,22 +479,44 @@ namespace ttg_parsec {
       ttg::trace("ttg_parsec(", rank, "): waiting for completion");
       parsec_taskpool_wait(tpool);
 
+#if defined(TTG_PARSEC_FENCE_EPOCH)
+      start_epoch();
+#else   // TTG_PARSEC_FENCE_EPOCH
       // We need the synchronization between the end of the context and the restart of the taskpool
-      // until we use parsec_taskpool_wait and implement an epoch in the PaRSEC taskpool
       // see Issue #118 (TTG)
       MPI_Barrier(comm());
 
       destroy_tpool();
       create_tpool();
+#endif  // TTG_PARSEC_FENCE_EPOCH
       execute();
     }
 
+    /// Starts the next epoch of the (terminated) taskpool: re-arms its termination detection and advances the epoch.
+    /// Unlike destroy_tpool() + create_tpool() this keeps the taskpool (and its id), and synchronizes only once.
+    /// fence() uses it instead of re-creating the taskpool only if `TTG_PARSEC_FENCE_EPOCH` is defined, since it
+    /// relies on re-arming the termination detection of a terminated taskpool, which PaRSEC does not document.
+    void start_epoch() {
+      assert(NULL != tpool->tdm.monitor);
+      tpool->tdm.module->unmonitor_taskpool(tpool);
+      tpool->tdm.module->monitor_taskpool(tpool, parsec_taskpool_termination_detected);
+      tpool->tdm.module->taskpool_set_nb_pa(tpool, 0);
+      parsec_taskpool_started = false;
+      taskpool_epoch.fetch_add(1, std::memory_order_relaxed);
+
+      // PaRSEC's termination detection messages do not carry the epoch, so all processes must have re-armed it
+      // before any of them starts the new epoch (see create_tpool()); this also guarantees that no message of the
+      // new epoch reaches a process that is still in the previous one
+      MPI_Barrier(comm());
+    }
+
    private:
     parsec_context_t *ctx = nullptr;
     bool own_ctx = false;  //< whether I own the context
     parsec_execution_stream_t *es = nullptr;
     parsec_taskpool_t *tpool = nullptr;
     bool parsec_taskpool_started = false;
+    MPI_Comm m_collectives_comm = MPI_COMM_NULL;
 #if defined(PARSEC_PROF_TRACE)
     int        *profiling_array;
     std::size_t profiling_array_size;
@@ -1080,21 +1124,32 @@ namespace ttg_parsec {
   /// @tparam T a serializable type
   template <typename T>
   void ttg_broadcast(::ttg::World world, T &data, int source_rank) {
-    int64_t BUFLEN;
-    if (world.rank() == source_rank) {
-      BUFLEN = ttg::default_data_descriptor<T>::payload_size(&data);
-    }
-    MPI_Bcast(&BUFLEN, 1, MPI_INT64_T, source_rank, world.impl().comm());
+    ttg::detail::mpi::broadcast(data, source_rank, world.impl().collectives_comm());
+  }
 
-    unsigned char *buf = new unsigned char[BUFLEN];
-    if (world.rank() == source_rank) {
-      ttg::default_data_descriptor<T>::pack_payload(&data, BUFLEN, 0, buf);
-    }
-    MPI_Bcast(buf, BUFLEN, MPI_UNSIGNED_CHAR, source_rank, world.impl().comm());
-    if (world.rank() != source_rank) {
-      ttg::default_data_descriptor<T>::unpack_payload(&data, BUFLEN, 0, buf);
-    }
-    delete[] buf;
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T &value, Op &&op) {
+    ttg::detail::mpi::allreduce(value, op, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_allreduce(ttg::World world, T *values, std::size_t n, Op &&op) {
+    ttg::detail::mpi::allreduce(values, n, op, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T &value, Op &&op, int root) {
+    ttg::detail::mpi::reduce(value, op, root, world.impl().collectives_comm());
+  }
+
+  template <typename T, typename Op>
+  inline void ttg_reduce(ttg::World world, T *values, std::size_t n, Op &&op, int root) {
+    ttg::detail::mpi::reduce(values, n, op, root, world.impl().collectives_comm());
+  }
+
+  template <typename T>
+  inline std::vector<T> ttg_gather(ttg::World world, const T &value, int root) {
+    return ttg::detail::mpi::gather(value, root, world.impl().collectives_comm());
   }
 
   namespace detail {
@@ -1112,7 +1167,7 @@ namespace ttg_parsec {
 
       msg_t() = default;
       msg_t(uint64_t tt_id, uint32_t taskpool_id, msg_header_t::fn_id_t fn_id, int32_t param_id, int num_keys = 1)
-          : tt_id{taskpool_id, tt_id, fn_id, param_id, num_keys} {}
+          : tt_id{taskpool_id, taskpool_epoch.load(std::memory_order_relaxed), tt_id, fn_id, param_id, num_keys} {}
     };
   }  // namespace detail
 
@@ -1233,6 +1288,7 @@ namespace ttg_parsec {
     ttg::World world;
     ttg::meta::detail::keymap_t<keyT> keymap;
     ttg::meta::detail::keymap_t<keyT> priomap;
+    ttg::meta::detail::keymap_t<keyT> affinitymap;  // empty = no preferred thread, see set_affinitymap()
     // For now use same type for unary/streaming input terminals, and stream reducers assigned at runtime
     ttg::meta::detail::input_reducers_t<actual_input_tuple_type>
         input_reducers;  //!< Reducers for the input terminals (empty = expect single value)
@@ -1360,7 +1416,7 @@ namespace ttg_parsec {
     uint64_t unpack(T &obj, void *_bytes, uint64_t pos) {
       const ttg_data_descriptor *dObj = ttg::get_data_descriptor<ttg::meta::remove_cvr_t<T>>();
       uint64_t payload_size;
-      if constexpr (!ttg::default_data_descriptor<ttg::meta::remove_cvr_t<T>>::serialize_size_is_const) {
+      if constexpr (!ttg::detail::data_descriptor_t<ttg::meta::remove_cvr_t<T>>::serialize_size_is_const) {
         const ttg_data_descriptor *dSiz = ttg::get_data_descriptor<uint64_t>();
         dSiz->unpack_payload(&payload_size, sizeof(uint64_t), pos, _bytes);
         pos += sizeof(uint64_t);
@@ -1371,17 +1427,32 @@ namespace ttg_parsec {
       return pos + payload_size;
     }
 
+    /// packs \p obj into \p bytes at \p pos , preceded by its size unless its serialized size is constant
+    /// \param size the size of \p bytes
+    /// \return the position in \p bytes past the packed object
     template <typename T>
-    uint64_t pack(T &obj, void *bytes, uint64_t pos) {
+    uint64_t pack(T &obj, void *bytes, uint64_t pos, uint64_t size = sizeof(detail::msg_t::bytes)) {
       const ttg_data_descriptor *dObj = ttg::get_data_descriptor<ttg::meta::remove_cvr_t<T>>();
-      uint64_t payload_size = dObj->payload_size(&obj);
-      if constexpr (!ttg::default_data_descriptor<ttg::meta::remove_cvr_t<T>>::serialize_size_is_const) {
-        const ttg_data_descriptor *dSiz = ttg::get_data_descriptor<uint64_t>();
-        dSiz->pack_payload(&payload_size, sizeof(uint64_t), pos, bytes);
-        pos += sizeof(uint64_t);
+      uint64_t end = ttg::detail::pack_payload_overflow;
+      if constexpr (!ttg::detail::data_descriptor_t<ttg::meta::remove_cvr_t<T>>::serialize_size_is_const) {
+        // serialize in a single pass, then back-patch the size header
+        const uint64_t payload_pos = pos + sizeof(uint64_t);
+        if (payload_pos <= size) end = dObj->pack_payload_once(&obj, size - payload_pos, payload_pos, bytes);
+        if (end != ttg::detail::pack_payload_overflow) {
+          uint64_t payload_size = end - payload_pos;
+          const ttg_data_descriptor *dSiz = ttg::get_data_descriptor<uint64_t>();
+          dSiz->pack_payload(&payload_size, sizeof(uint64_t), pos, bytes);
+        }
+      } else {
+        const uint64_t payload_size = dObj->payload_size(&obj);
+        if (pos + payload_size <= size) end = dObj->pack_payload(&obj, payload_size, pos, bytes);
       }
-      dObj->pack_payload(&obj, payload_size, pos, bytes);
-      return pos + payload_size;
+      if (end == ttg::detail::pack_payload_overflow) {
+        ttg::print_error(world.rank(), ":", get_name(), " : serialized object does not fit into the ", size,
+                         "-byte message buffer");
+        throw std::runtime_error("TT::pack: message buffer overflow");
+      }
+      return end;
     }
 
     static void static_set_arg(void *data, std::size_t size, ttg::TTBase *bop) {
@@ -1436,8 +1507,8 @@ namespace ttg_parsec {
       return &mempools.thread_mempools[index];
     }
 
-    template <size_t i, typename valueT>
-    void set_arg_from_msg_keylist(ttg::span<keyT> &&keylist, detail::ttg_data_copy_t *copy) {
+    template <size_t i, typename valueT, typename KeyT = keyT>
+    void set_arg_from_msg_keylist(ttg::span<KeyT> &&keylist, detail::ttg_data_copy_t *copy) {
       /* create a dummy task that holds the copy, which can be reused by others */
       task_t *dummy;
       parsec_execution_stream_s *es = world.impl().execution_stream();
@@ -1484,6 +1555,172 @@ namespace ttg_parsec {
     // - case 6:    void Key, void Value, no inputs
     // implementation of these will be further split into "local-only" and global+local
 
+    /// packs the keys in [\p begin, \p end) into \p buf starting at \p pos and sets \p num_keys;
+    /// integral keys that form an arithmetic progression (in the given order) are packed as a {start, stride} pair
+    /// and signalled by a negative \p num_keys, other keys are packed like by pack() one after another; keys stored
+    /// contiguously are packed with a single call of ttg::detail::pack_n (a single `memcpy` for bit-copyable keys).
+    /// The stride is computed in the unsigned counterpart of the key type (see ttg::detail::key_difference), hence
+    /// it cannot overflow for signed keys.
+    /// \sa broadcast_strided_arg, which sends the keys of a ttg::strided_range without scanning them
+    /// \return the position in \p buf past the packed keys
+    template <typename Iterator>
+    uint64_t pack_keylist(Iterator begin, Iterator end, void *buf, uint64_t pos, int &num_keys) {
+      const int count = std::distance(begin, end);
+      if constexpr (std::is_integral_v<keyT> && !std::is_same_v<keyT, bool>) {
+        if (count > 2) {
+          const keyT stride = ttg::detail::key_difference(*begin, *std::next(begin));
+          bool is_strided = true;
+          for (auto it = std::next(begin); is_strided && std::next(it) != end; ++it) {
+            is_strided = (ttg::detail::key_difference(*it, *std::next(it)) == stride);
+          }
+          if (is_strided) {
+            pos = pack(*begin, buf, pos);
+            pos = pack(stride, buf, pos);
+            num_keys = -count;
+            return pos;
+          }
+        }
+      }
+      if constexpr (!std::is_same_v<keyT, bool> && (std::is_same_v<Iterator, typename std::vector<keyT>::iterator> ||
+                                                    std::is_same_v<Iterator, keyT *>)) {
+        const uint64_t size = sizeof(detail::msg_t::bytes);
+        const uint64_t end_pos =
+            pos <= size ? ttg::detail::pack_n<keyT>(&*begin, count, sizeof(keyT), size - pos, pos, buf)
+                        : ttg::detail::pack_payload_overflow;
+        if (end_pos == ttg::detail::pack_payload_overflow) {
+          ttg::print_error(world.rank(), ":", get_name(), " : ", count, " keys do not fit into the ", size,
+                           "-byte message buffer");
+          throw std::runtime_error("TT::pack_keylist: message buffer overflow");
+        }
+        pos = end_pos;
+      } else {
+        for (auto it = begin; it != end; ++it) {
+          pos = pack(*it, buf, pos);
+        }
+      }
+      num_keys = count;
+      return pos;
+    }
+
+    /// unpacks \p num_keys keys packed by pack_keylist from \p buf starting at \p pos into \p keylist
+    /// \return the position in \p buf past the packed keys
+    uint64_t unpack_keylist(std::vector<keyT> &keylist, int num_keys, void *buf, uint64_t pos) {
+      [[maybe_unused]] auto rank = world.rank();
+      if (num_keys < 0) {
+        if constexpr (std::is_integral_v<keyT> && !std::is_same_v<keyT, bool>) {
+          keyT start, stride;
+          pos = unpack(start, buf, pos);
+          pos = unpack(stride, buf, pos);
+          keylist.reserve(-num_keys);
+          for (int k = 0; k < -num_keys; ++k) {
+            keylist.push_back(ttg::detail::advance_key(start, k, stride));
+            assert(keymap(keylist.back()) == rank);
+          }
+        } else {
+          ttg::print_error(get_name(), " : received a strided key list for non-integral keys");
+          throw std::logic_error("bad key list");
+        }
+      } else {
+        keylist.resize(num_keys);
+        pos = ttg::detail::unpack_n<keyT>(keylist.data(), num_keys, sizeof(keyT), sizeof(detail::msg_t::bytes) - pos,
+                                          pos, buf);
+        for ([[maybe_unused]] const auto &key : keylist) assert(keymap(key) == rank);
+      }
+      return pos;
+    }
+
+    /// unpacks the value of a split-metadata or gather-mode type from \p msg starting at \p pos , fetches by RMA the
+    /// parts of the value that were not packed into \p msg , then delivers the value to argument \p i of the tasks
+    /// with keys \p keylist (a single ttg::Void if \c keyT is void)
+    template <std::size_t i, typename decvalueT, typename KeyT>
+    void set_arg_from_msg_rma(detail::msg_t *msg, uint64_t pos, std::size_t size, std::vector<KeyT> &&keylist) {
+      /* create the value from the metadata, or from the header of the gather-mode serialization, and collect
+       * the iovecs of the payload, i.e. the parts of the value to be filled by RMA */
+      detail::ttg_data_copy_t *copy;
+      auto iovecs = [&]() {
+        if constexpr (ttg::has_split_metadata<decvalueT>::value) {
+          ttg::SplitMetadataDescriptor<decvalueT> descr;
+          using metadata_t = decltype(descr.get_metadata(std::declval<decvalueT>()));
+          size_t metadata_size = sizeof(metadata_t);
+          metadata_t metadata;
+          std::memcpy(&metadata, msg->bytes + pos, metadata_size);
+          pos += metadata_size;
+          copy = detail::create_new_datacopy(descr.create_from_metadata(metadata));
+          return descr.get_data(*static_cast<decvalueT *>(copy->device_private));
+        } else {
+          uint64_t header_size;
+          std::memcpy(&header_size, msg->bytes + pos, sizeof(header_size));
+          pos += sizeof(header_size);
+          copy = detail::create_new_datacopy(decvalueT{});
+          auto scattered = ttg::detail::scatter_payload(*static_cast<decvalueT *>(copy->device_private),
+                                                        header_size, msg->bytes + pos);
+          pos += header_size;
+          return scattered;
+        }
+      }();
+
+      /* unpack the remote rank */
+      int remote;
+      std::memcpy(&remote, msg->bytes + pos, sizeof(remote));
+      pos += sizeof(remote);
+
+      assert(remote < world.size());
+
+      /* extract the number of chunks */
+      int32_t num_iovecs;
+      std::memcpy(&num_iovecs, msg->bytes + pos, sizeof(num_iovecs));
+      pos += sizeof(num_iovecs);
+
+      /* nothing else to do if the object is empty */
+      if (0 == num_iovecs) {
+        set_arg_from_msg_keylist<i, decvalueT, KeyT>(keylist, copy);
+      } else {
+        /* extract the callback tag */
+        parsec_ce_tag_t cbtag;
+        std::memcpy(&cbtag, msg->bytes + pos, sizeof(cbtag));
+        pos += sizeof(cbtag);
+
+        auto activation = new detail::rma_delayed_activate(
+            std::move(keylist), copy, num_iovecs, [this](std::vector<KeyT> &&keylist, detail::ttg_data_copy_t *copy) {
+              set_arg_from_msg_keylist<i, decvalueT, KeyT>(keylist, copy);
+              this->world.impl().decrement_inflight_msg();
+            });
+        using ActivationT = std::decay_t<decltype(*activation)>;
+
+        int nv = 0;
+        /* start the RMA transfers */
+        for (auto &&iov : iovecs) {
+          ++nv;
+          parsec_ce_mem_reg_handle_t rreg;
+          int32_t rreg_size_i;
+          std::memcpy(&rreg_size_i, msg->bytes + pos, sizeof(rreg_size_i));
+          pos += sizeof(rreg_size_i);
+          rreg = static_cast<parsec_ce_mem_reg_handle_t>(msg->bytes + pos);
+          pos += rreg_size_i;
+          // std::intptr_t *fn_ptr = reinterpret_cast<std::intptr_t *>(msg->bytes + pos);
+          // pos += sizeof(*fn_ptr);
+          std::intptr_t fn_ptr;
+          std::memcpy(&fn_ptr, msg->bytes + pos, sizeof(fn_ptr));
+          pos += sizeof(fn_ptr);
+
+          /* register the local memory */
+          parsec_ce_mem_reg_handle_t lreg;
+          size_t lreg_size;
+          parsec_ce.mem_register(iov.data, PARSEC_MEM_TYPE_NONCONTIGUOUS, iov.num_bytes, parsec_datatype_int8_t,
+                                 iov.num_bytes, &lreg, &lreg_size);
+          world.impl().increment_inflight_msg();
+          /* TODO: PaRSEC should treat the remote callback as a tag, not a function pointer! */
+          parsec_ce.get(&parsec_ce, lreg, 0, rreg, 0, iov.num_bytes, remote,
+                        &detail::get_complete_cb<ActivationT>, activation,
+                        /*world.impl().parsec_ttg_rma_tag()*/
+                        cbtag, &fn_ptr, sizeof(std::intptr_t));
+        }
+
+        assert(num_iovecs == nv);
+        assert(size == (pos + sizeof(msg_header_t)));
+      }
+    }
+
     template <std::size_t i>
     void set_arg_from_msg(void *data, std::size_t size) {
       using valueT = std::tuple_element_t<i, actual_input_tuple_type>;
@@ -1493,100 +1730,19 @@ namespace ttg_parsec {
         /* unpack the keys */
         uint64_t pos = 0;
         std::vector<keyT> keylist;
-        int num_keys = msg->tt_id.num_keys;
-        keylist.reserve(num_keys);
-        auto rank = world.rank();
-        for (int k = 0; k < num_keys; ++k) {
-          keyT key;
-          pos = unpack(key, msg->bytes, pos);
-          assert(keymap(key) == rank);
-          keylist.push_back(std::move(key));
-        }
+        pos = unpack_keylist(keylist, msg->tt_id.num_keys, msg->bytes, pos);
+        int num_keys = keylist.size();
         // case 1
         if constexpr (!ttg::meta::is_void_v<valueT>) {
           using decvalueT = std::decay_t<valueT>;
-          if constexpr (!ttg::has_split_metadata<decvalueT>::value) {
+          if constexpr (!ttg::has_split_metadata<decvalueT>::value &&
+                        !ttg::detail::use_gather_serialization_v<decvalueT>) {
             detail::ttg_data_copy_t *copy = detail::create_new_datacopy(decvalueT{});
             unpack(*static_cast<decvalueT *>(copy->device_private), msg->bytes, pos);
 
             set_arg_from_msg_keylist<i, decvalueT>(ttg::span<keyT>(&keylist[0], num_keys), copy);
           } else {
-            /* unpack the header and start the RMA transfers */
-            ttg::SplitMetadataDescriptor<decvalueT> descr;
-            using metadata_t = decltype(descr.get_metadata(std::declval<decvalueT>()));
-            size_t metadata_size = sizeof(metadata_t);
-
-            /* unpack the metadata */
-            metadata_t metadata;
-            std::memcpy(&metadata, msg->bytes + pos, metadata_size);
-            pos += metadata_size;
-
-            /* unpack the remote rank */
-            int remote;
-            std::memcpy(&remote, msg->bytes + pos, sizeof(remote));
-            pos += sizeof(remote);
-
-            assert(remote < world.size());
-
-            /* extract the number of chunks */
-            int32_t num_iovecs;
-            std::memcpy(&num_iovecs, msg->bytes + pos, sizeof(num_iovecs));
-            pos += sizeof(num_iovecs);
-
-            detail::ttg_data_copy_t *copy = detail::create_new_datacopy(descr.create_from_metadata(metadata));
-            /* nothing else to do if the object is empty */
-            if (0 == num_iovecs) {
-              set_arg_from_msg_keylist<i, decvalueT>(keylist, copy);
-            } else {
-              /* extract the callback tag */
-              parsec_ce_tag_t cbtag;
-              std::memcpy(&cbtag, msg->bytes + pos, sizeof(cbtag));
-              pos += sizeof(cbtag);
-
-              /* create the value from the metadata */
-              auto activation = new detail::rma_delayed_activate(
-                  std::move(keylist), copy, num_iovecs, [this](std::vector<keyT> &&keylist, detail::ttg_data_copy_t *copy) {
-                    set_arg_from_msg_keylist<i, decvalueT>(keylist, copy);
-                    this->world.impl().decrement_inflight_msg();
-                  });
-              auto &val = *static_cast<decvalueT *>(copy->device_private);
-
-              using ActivationT = std::decay_t<decltype(*activation)>;
-
-              int nv = 0;
-              /* process payload iovecs */
-              auto iovecs = descr.get_data(val);
-              /* start the RMA transfers */
-              for (auto &&iov : iovecs) {
-                ++nv;
-                parsec_ce_mem_reg_handle_t rreg;
-                int32_t rreg_size_i;
-                std::memcpy(&rreg_size_i, msg->bytes + pos, sizeof(rreg_size_i));
-                pos += sizeof(rreg_size_i);
-                rreg = static_cast<parsec_ce_mem_reg_handle_t>(msg->bytes + pos);
-                pos += rreg_size_i;
-                // std::intptr_t *fn_ptr = reinterpret_cast<std::intptr_t *>(msg->bytes + pos);
-                // pos += sizeof(*fn_ptr);
-                std::intptr_t fn_ptr;
-                std::memcpy(&fn_ptr, msg->bytes + pos, sizeof(fn_ptr));
-                pos += sizeof(fn_ptr);
-
-                /* register the local memory */
-                parsec_ce_mem_reg_handle_t lreg;
-                size_t lreg_size;
-                parsec_ce.mem_register(iov.data, PARSEC_MEM_TYPE_NONCONTIGUOUS, iov.num_bytes, parsec_datatype_int8_t,
-                                       iov.num_bytes, &lreg, &lreg_size);
-                world.impl().increment_inflight_msg();
-                /* TODO: PaRSEC should treat the remote callback as a tag, not a function pointer! */
-                parsec_ce.get(&parsec_ce, lreg, 0, rreg, 0, iov.num_bytes, remote,
-                              &detail::get_complete_cb<ActivationT>, activation,
-                              /*world.impl().parsec_ttg_rma_tag()*/
-                              cbtag, &fn_ptr, sizeof(std::intptr_t));
-              }
-
-              assert(num_iovecs == nv);
-              assert(size == (pos + sizeof(msg_header_t)));
-            }
+            set_arg_from_msg_rma<i, decvalueT>(msg, pos, size, std::move(keylist));
           }
           // case 2 and 3
         } else if constexpr (!ttg::meta::is_void_v<keyT> && std::is_void_v<valueT>) {
@@ -1597,10 +1753,14 @@ namespace ttg_parsec {
         // case 4
       } else if constexpr (ttg::meta::is_void_v<keyT> && !std::is_void_v<valueT>) {
         using decvalueT = std::decay_t<valueT>;
-        decvalueT val;
-        /* TODO: handle split-metadata case as with non-void keys */
-        unpack(val, msg->bytes, 0);
-        set_arg<i, keyT, valueT>(std::move(val));
+        if constexpr (!ttg::has_split_metadata<decvalueT>::value &&
+                      !ttg::detail::use_gather_serialization_v<decvalueT>) {
+          decvalueT val;
+          unpack(val, msg->bytes, 0);
+          set_arg<i, keyT, valueT>(std::move(val));
+        } else {
+          set_arg_from_msg_rma<i, decvalueT>(msg, 0, size, std::vector<ttg::Void>{ttg::Void{}});
+        }
         // case 5 and 6
       } else if constexpr (ttg::meta::is_void_v<keyT> && std::is_void_v<valueT>) {
         set_arg<i, keyT, ttg::Void>(ttg::Void{});
@@ -1661,6 +1821,7 @@ namespace ttg_parsec {
         uint64_t pos = 0;
         keyT key;
         pos = unpack(key, msg->bytes, pos);
+        /* reply with the element; like any set_arg, this transfers split-metadata and gather-mode values by RMA */
         set_arg<i>(key, (in.container).get(key));
       }
     }
@@ -1874,6 +2035,27 @@ namespace ttg_parsec {
       }
     }
 
+    /// @return the execution stream of the thread preferred by the affinity map for \p task , see set_affinitymap()
+    parsec_execution_stream_t *affine_execution_stream(task_t *task) {
+      int thread;
+      if constexpr (!ttg::meta::is_void_v<keyT>) {
+        thread = affinitymap(task->key);
+      } else {
+        thread = affinitymap();
+      }
+      auto *context = world.impl().context();
+      int nthreads = 0;
+      for (int vp = 0; vp < context->nb_vp; ++vp) nthreads += context->virtual_processes[vp]->nb_cores;
+      thread %= nthreads;
+      if (thread < 0) thread += nthreads;
+      for (int vp = 0; vp < context->nb_vp; ++vp) {
+        auto *vproc = context->virtual_processes[vp];
+        if (thread < vproc->nb_cores) return vproc->execution_streams[thread];
+        thread -= vproc->nb_cores;
+      }
+      return world.impl().execution_stream();
+    }
+
     void release_task(task_t *task,
                       parsec_task_t **task_ring = nullptr) {
       constexpr const bool keyT_is_Void = ttg::meta::is_void_v<keyT>;
@@ -1903,7 +2085,10 @@ namespace ttg_parsec {
           }
         }
         if (task->remove_from_hash) parsec_hash_table_remove(&tasks_table, hk);
-        if (nullptr == task_ring) {
+        if (affinitymap) {
+          /* tasks with a preferred thread bypass the ring and go directly to that thread's queue */
+          __parsec_schedule(affine_execution_stream(task), &task->parsec_task, 0);
+        } else if (nullptr == task_ring) {
           __parsec_schedule(es, &task->parsec_task, 0);
         } else if (*task_ring == nullptr) {
           /* the first task is set directly */
@@ -1989,7 +2174,8 @@ namespace ttg_parsec {
       }
 
       if constexpr (!ttg::meta::is_void_v<decvalueT>) {
-        if constexpr (!ttg::has_split_metadata<decvalueT>::value) {
+        if constexpr (!ttg::has_split_metadata<decvalueT>::value &&
+                      !ttg::detail::use_gather_serialization_v<decvalueT>) {
           pos = pack(value, msg->bytes, pos);
         } else {
           detail::ttg_data_copy_t *copy;
@@ -1999,20 +2185,44 @@ namespace ttg_parsec {
             copy = detail::create_new_datacopy(std::forward<Value>(value));
           }
           copy = detail::register_data_copy<decvalueT>(copy, nullptr, true);
-
-          ttg::SplitMetadataDescriptor<decvalueT> descr;
-          auto metadata = descr.get_metadata(value);
-          size_t metadata_size = sizeof(metadata);
-          /* pack the metadata */
-          std::memcpy(msg->bytes + pos, &metadata, metadata_size);
-          pos += metadata_size;
+          /* the copy is released once the receiver has read all iovecs, or right away if there are none */
+          auto copy_ptr = std::shared_ptr<void>{
+              copy, [](void *ptr) { detail::release_data_copy(static_cast<detail::ttg_data_copy_t *>(ptr)); }};
+
+          /* pack the metadata, or the header of the gather-mode serialization preceded by its size, and collect the
+           * iovecs of the payload */
+          auto iovecs = [&]() {
+            auto &copy_value = *static_cast<decvalueT *>(copy->device_private);
+            if constexpr (ttg::has_split_metadata<decvalueT>::value) {
+              ttg::SplitMetadataDescriptor<decvalueT> descr;
+              /* value might have been moved into the copy */
+              auto metadata = descr.get_metadata(copy_value);
+              size_t metadata_size = sizeof(metadata);
+              std::memcpy(msg->bytes + pos, &metadata, metadata_size);
+              pos += metadata_size;
+              return descr.get_data(copy_value);
+            } else {
+              std::vector<ttg::iovec> gathered;
+              const uint64_t header_pos = pos + sizeof(uint64_t);
+              uint64_t header_size = ttg::detail::pack_payload_overflow;
+              if (header_pos <= sizeof(msg->bytes))
+                header_size = ttg::detail::gather_payload(copy_value, sizeof(msg->bytes) - header_pos,
+                                                          msg->bytes + header_pos, gathered);
+              if (header_size == ttg::detail::pack_payload_overflow) {
+                ttg::print_error(world.rank(), ":", get_name(), " : serialized object does not fit into the ",
+                                 sizeof(msg->bytes), "-byte message buffer");
+                throw std::runtime_error("TT::set_arg: message buffer overflow");
+              }
+              std::memcpy(msg->bytes + pos, &header_size, sizeof(header_size));
+              pos = header_pos + header_size;
+              return gathered;
+            }
+          }();
           /* pack the local rank */
           int rank = world.rank();
           std::memcpy(msg->bytes + pos, &rank, sizeof(rank));
           pos += sizeof(rank);
 
-          auto iovecs = descr.get_data(*static_cast<decvalueT *>(copy->device_private));
-
           int32_t num_iovs = std::distance(std::begin(iovecs), std::end(iovecs));
           std::memcpy(msg->bytes + pos, &num_iovs, sizeof(num_iovs));
           pos += sizeof(num_iovs);
@@ -2047,7 +2257,7 @@ namespace ttg_parsec {
             std::function<void(void)> *fn = new std::function<void(void)>([=]() mutable {
               /* shared_ptr of value and registration captured by value so resetting
                * them here will eventually release the memory/registration */
-              detail::release_data_copy(copy);
+              copy_ptr.reset();
               lreg_ptr.reset();
             });
             std::intptr_t fn_ptr{reinterpret_cast<std::intptr_t>(fn)};
@@ -2090,25 +2300,42 @@ namespace ttg_parsec {
     }
 
     template <int i, typename Iterator, typename Value>
-    void broadcast_arg_local(Iterator &&begin, Iterator &&end, const Value &value) {
+    void broadcast_arg_local(Iterator &&begin, Iterator &&end, Value &&value) {
 #if defined(PARSEC_PROF_TRACE) && defined(PARSEC_TTG_PROFILE_BACKEND)
       if(world.impl().profiling()) {
         parsec_profiling_ts_trace(world.impl().parsec_ttg_profile_backend_bcast_arg_start, 0, 0, NULL);
       }
 #endif
+      using decvalueT = std::decay_t<Value>;
       parsec_task_t *task_ring = nullptr;
       detail::ttg_data_copy_t *copy = nullptr;
+      bool own_copy = false;
       if (nullptr != parsec_ttg_caller) {
         copy = detail::find_copy_in_task(parsec_ttg_caller, &value);
       }
 
-      for (auto it = begin; it != end; ++it) {
-        set_arg_local_impl<i>(*it, value, copy, &task_ring);
+      if (nullptr == copy && std::distance(begin, end) <= 1) {
+        /* at most one untracked target: hand over the value directly */
+        if (begin != end) set_arg_local_impl<i>(*begin, std::forward<Value>(value), nullptr, &task_ring);
+      } else {
+        if (nullptr == copy) {
+          /* the value is not tracked by the caller: create a single copy (moving the value in if we were given
+           * an rvalue) that all readers share and the first writer takes over once we release it below */
+          copy = detail::create_new_datacopy(std::forward<Value>(value));
+          own_copy = true;
+        }
+        const decvalueT &shared_value = own_copy ? *reinterpret_cast<decvalueT *>(copy->device_private) : value;
+        for (auto it = begin; it != end; ++it) {
+          set_arg_local_impl<i>(*it, shared_value, copy, &task_ring);
+        }
       }
       /* submit all ready tasks at once */
       if (nullptr != task_ring) {
         __parsec_schedule(world.impl().execution_stream(), task_ring, 0);
       }
+      if (own_copy) {
+        detail::release_data_copy(copy);
+      }
 #if defined(PARSEC_PROF_TRACE) && defined(PARSEC_TTG_PROFILE_BACKEND)
       if(world.impl().profiling()) {
         parsec_profiling_ts_trace(world.impl().parsec_ttg_profile_backend_set_arg_end, 0, 0, NULL);
@@ -2120,7 +2347,7 @@ namespace ttg_parsec {
     std::enable_if_t<!ttg::meta::is_void_v<Key> && !std::is_void_v<std::decay_t<Value>> &&
                          !ttg::has_split_metadata<std::decay_t<Value>>::value,
                      void>
-    broadcast_arg(const ttg::span<const Key> &keylist, const Value &value) {
+    broadcast_arg(const ttg::span<const Key> &keylist, Value &&value) {
       auto world = ttg_default_execution_context();
       int rank = world.rank();
 
@@ -2135,7 +2362,7 @@ namespace ttg_parsec {
         auto local_end = keylist_sorted.end();
 
         /* sort the input key list by owner and check whether there are remote keys */
-        std::sort(keylist_sorted.begin(), keylist_sorted.end(), [&](const Key &a, const Key &b) mutable {
+        std::stable_sort(keylist_sorted.begin(), keylist_sorted.end(), [&](const Key &a, const Key &b) mutable {
           int rank_a = keymap(a);
           int rank_b = keymap(b);
           return rank_a < rank_b;
@@ -2161,14 +2388,10 @@ namespace ttg_parsec {
           }
 
           /* pack all keys for this owner */
-          int num_keys = 0;
-          uint64_t pos = 0;
-          do {
-            ++num_keys;
-            pos = pack(*it, msg->bytes, pos);
-            ++it;
-          } while (it < keylist_sorted.end() && keymap(*it) == owner);
-          msg->tt_id.num_keys = num_keys;
+          auto owner_end = std::find_if_not(std::next(it), keylist_sorted.end(),
+                                            [&](const Key &key) { return keymap(key) == owner; });
+          uint64_t pos = pack_keylist(it, owner_end, msg->bytes, 0, msg->tt_id.num_keys);
+          it = owner_end;
 
           /* TODO: use RMA to transfer the value */
           pos = pack(value, msg->bytes, pos);
@@ -2180,11 +2403,78 @@ namespace ttg_parsec {
                             sizeof(msg_header_t) + pos);
         }
         /* handle local keys */
-        broadcast_arg_local<i>(local_begin, local_end, value);
+        broadcast_arg_local<i>(local_begin, local_end, std::forward<Value>(value));
       } else {
         /* only local keys */
-        broadcast_arg_local<i>(keylist.begin(), keylist.end(), value);
+        broadcast_arg_local<i>(keylist.begin(), keylist.end(), std::forward<Value>(value));
+      }
+    }
+
+    /// broadcasts \p value to the keys `start + k*stride`, `k = 0, ..., count-1`, of a ttg::strided_range without
+    /// materializing them: the keys owned by each remote rank are sent as a {start, stride} pair (see
+    /// unpack_keylist) as long as their positions in the range form an arithmetic progression, which is the case
+    /// e.g. for block and cyclic keymaps; only the local keys and the keys of ranks with irregular positions are
+    /// stored
+    template <std::size_t i, typename Value>
+    void broadcast_strided_arg(const keyT &start, const keyT &stride, std::size_t count, const Value &value) {
+      static_assert(std::is_integral_v<keyT> && !ttg::has_split_metadata<std::decay_t<Value>>::value);
+      /// the positions in the range of the keys owned by one rank
+      struct owner_keys_t {
+        std::size_t first = 0, step = 0, last = 0, count = 0;
+        std::vector<keyT> irregular;  // all keys, once their positions stop forming an arithmetic progression
+      };
+      auto world = ttg_default_execution_context();
+      const int rank = world.rank();
+      std::map<int, owner_keys_t> remote_keys;
+      std::vector<keyT> local_keys;
+      for (std::size_t k = 0; k != count; ++k) {
+        const keyT key = ttg::detail::advance_key(start, k, stride);
+        const int owner = keymap(key);
+        if (owner == rank) {
+          local_keys.push_back(key);
+          continue;
+        }
+        auto &keys = remote_keys[owner];
+        if (keys.count == 1) {
+          keys.step = k - keys.first;
+        } else if (keys.count == 0) {
+          keys.first = k;
+        } else if (keys.irregular.empty() && k - keys.last != keys.step) {
+          keys.irregular.reserve(keys.count + 1);
+          for (std::size_t j = 0; j != keys.count; ++j)
+            keys.irregular.push_back(ttg::detail::advance_key(start, keys.first + j * keys.step, stride));
+        }
+        if (!keys.irregular.empty()) keys.irregular.push_back(key);
+        keys.last = k;
+        ++keys.count;
       }
+
+      using msg_t = detail::msg_t;
+      auto &world_impl = world.impl();
+      parsec_taskpool_t *tp = world_impl.taskpool();
+      std::unique_ptr<msg_t> msg =
+          std::make_unique<msg_t>(get_instance_id(), tp->taskpool_id, msg_header_t::MSG_SET_ARG, i);
+      for (auto &&[owner, keys] : remote_keys) {
+        uint64_t pos = 0;
+        if (keys.irregular.empty()) {
+          if (keys.count > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            ttg::print_error(world.rank(), ":", get_name(), " : cannot broadcast to ", keys.count, " keys of rank ",
+                             owner);
+            throw std::runtime_error("TT::broadcast_strided_arg: too many keys");
+          }
+          pos = pack(ttg::detail::advance_key(start, keys.first, stride), msg->bytes, pos);
+          pos = pack(ttg::detail::advance_key(keyT{0}, keys.step, stride), msg->bytes, pos);
+          msg->tt_id.num_keys = -static_cast<int>(keys.count);
+        } else {
+          pos = pack_keylist(keys.irregular.begin(), keys.irregular.end(), msg->bytes, pos, msg->tt_id.num_keys);
+        }
+        pos = pack(value, msg->bytes, pos);
+        tp->tdm.module->outgoing_message_start(tp, owner, NULL);
+        tp->tdm.module->outgoing_message_pack(tp, owner, NULL, NULL, 0);
+        parsec_ce.send_am(&parsec_ce, world_impl.parsec_ttg_tag(), owner, static_cast<void *>(msg.get()),
+                          sizeof(msg_header_t) + pos);
+      }
+      broadcast_arg_local<i>(local_keys.begin(), local_keys.end(), value);
     }
 
     template <std::size_t i, typename Key, typename Value>
@@ -2203,7 +2493,7 @@ namespace ttg_parsec {
 
         /* sort the input key list by owner and check whether there are remote keys */
         std::vector<Key> keylist_sorted(keylist.begin(), keylist.end());
-        std::sort(keylist_sorted.begin(), keylist_sorted.end(), [&](const Key &a, const Key &b) mutable {
+        std::stable_sort(keylist_sorted.begin(), keylist_sorted.end(), [&](const Key &a, const Key &b) mutable {
           int rank_a = keymap(a);
           int rank_b = keymap(b);
           return rank_a < rank_b;
@@ -2258,16 +2548,11 @@ namespace ttg_parsec {
             continue;
           }
 
-          /* count keys and set it afterwards */
-          uint64_t pos = 0;
           /* pack all keys for this owner */
-          int num_keys = 0;
-          do {
-            ++num_keys;
-            pos = pack(*it, msg->bytes, pos);
-            ++it;
-          } while (it < keylist_sorted.end() && keymap(*it) == owner);
-          msg->tt_id.num_keys = num_keys;
+          auto owner_end = std::find_if_not(std::next(it), keylist_sorted.end(),
+                                            [&](const Key &key) { return keymap(key) == owner; });
+          uint64_t pos = pack_keylist(it, owner_end, msg->bytes, 0, msg->tt_id.num_keys);
+          it = owner_end;
 
           /* pack the metadata */
           std::memcpy(msg->bytes + pos, &metadata, metadata_size);
@@ -2625,12 +2910,35 @@ namespace ttg_parsec {
           if constexpr (ttg::has_split_metadata<std::decay_t<valueT>>::value) {
             splitmd_broadcast_arg<i, keyT, valueT>(keylist, value);
           } else {
-            broadcast_arg<i, keyT, valueT>(keylist, value);
+            broadcast_arg<i, keyT, const valueT &>(keylist, value);
+          }
+        };
+        auto move_broadcast_callback = [this](const ttg::span<const keyT> &keylist, valueT &&value) {
+          if constexpr (ttg::has_split_metadata<std::decay_t<valueT>>::value) {
+            splitmd_broadcast_arg<i, keyT, valueT>(keylist, value);
+          } else {
+            broadcast_arg<i, keyT, valueT>(keylist, std::forward<valueT>(value));
           }
         };
         auto setsize_callback = [this](const keyT &key, std::size_t size) { set_argstream_size<i>(key, size); };
         auto finalize_callback = [this](const keyT &key) { finalize_argstream<i>(key); };
-        input.set_callback(send_callback, move_callback, broadcast_callback, setsize_callback, finalize_callback);
+        input.set_callback(send_callback, move_callback, broadcast_callback, setsize_callback, finalize_callback,
+                           move_broadcast_callback);
+        if constexpr (std::is_integral_v<keyT> && !std::is_same_v<keyT, bool> &&
+                      !ttg::has_split_metadata<std::decay_t<valueT>>::value) {
+          input.set_strided_broadcast_callback(
+              [this](const keyT &start, const keyT &stride, std::size_t count, const valueT &value) {
+                broadcast_strided_arg<i>(start, stride, count, value);
+              });
+        }
+        input.set_static_callback(
+            this,
+            [](void *tt, const keyT &key, const valueT &value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, const valueT &>(key, value);
+            },
+            [](void *tt, const keyT &key, valueT &&value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, valueT>(key, std::forward<valueT>(value));
+            });
       }
       //////////////////////////////////////////////////////////////////
       // case 2: nonvoid key, void value, mixed inputs
@@ -2640,6 +2948,10 @@ namespace ttg_parsec {
         auto setsize_callback = [this](const keyT &key, std::size_t size) { set_argstream_size<i>(key, size); };
         auto finalize_callback = [this](const keyT &key) { finalize_argstream<i>(key); };
         input.set_callback(send_callback, send_callback, {}, setsize_callback, finalize_callback);
+        auto static_send_callback = [](void *tt, const keyT &key) {
+          static_cast<TT *>(tt)->template set_arg<i, keyT, ttg::Void>(key, ttg::Void{});
+        };
+        input.set_static_callback(this, static_send_callback, static_send_callback);
       }
       //////////////////////////////////////////////////////////////////
       // case 3: nonvoid key, void value, no inputs
@@ -2654,6 +2966,14 @@ namespace ttg_parsec {
         auto setsize_callback = [this](std::size_t size) { set_argstream_size<i>(size); };
         auto finalize_callback = [this]() { finalize_argstream<i>(); };
         input.set_callback(send_callback, move_callback, {}, setsize_callback, finalize_callback);
+        input.set_static_callback(
+            this,
+            [](void *tt, const valueT &value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, const valueT &>(value);
+            },
+            [](void *tt, valueT &&value) {
+              static_cast<TT *>(tt)->template set_arg<i, keyT, valueT>(std::forward<valueT>(value));
+            });
       }
       //////////////////////////////////////////////////////////////////
       // case 5: void key, void value, mixed inputs
@@ -2663,6 +2983,10 @@ namespace ttg_parsec {
         auto setsize_callback = [this](std::size_t size) { set_argstream_size<i>(size); };
         auto finalize_callback = [this]() { finalize_argstream<i>(); };
         input.set_callback(send_callback, send_callback, {}, setsize_callback, finalize_callback);
+        auto static_send_callback = [](void *tt) {
+          static_cast<TT *>(tt)->template set_arg<i, keyT, ttg::Void>(ttg::Void{});
+        };
+        input.set_static_callback(this, static_send_callback, static_send_callback);
       }
       //////////////////////////////////////////////////////////////////
       // case 6: void key, void value, no inputs
@@ -3095,6 +3419,11 @@ namespace ttg_parsec {
 
    public:
     void make_executable() override {
+      if (this->get_batch_size() > 1) {
+        ttg::print_error(get_name(), " : batched execution of tasks (TTBase::set_batch_size) is not supported by the "
+                                     "PaRSEC backend");
+        throw std::logic_error("ttg_parsec::TT::make_executable: batched execution of tasks is not supported");
+      }
       world.impl().register_tt_profiling(this);
       register_static_op_function();
       ttg::TTBase::make_executable();
@@ -3121,6 +3450,20 @@ namespace ttg_parsec {
       priomap = std::forward<Priomap>(pm);
     }
 
+    /// affinity map accessor
+    /// @return the affinity map; empty if not set
+    const decltype(affinitymap) &get_affinitymap() const { return affinitymap; }
+
+    /// affinity map setter
+    /// @arg am a function that maps a key to the index of the thread that should preferably execute the task;
+    ///      the index is taken modulo the number of threads. Ready tasks are pushed to the local queue of the
+    ///      preferred thread, from which other threads can still steal them, so that e.g. successive updates of the
+    ///      same data run on the same core.
+    template <typename Affinitymap>
+    void set_affinitymap(Affinitymap &&am) {
+      affinitymap = std::forward<Affinitymap>(am);
+    }
+
     // Register the static_op function to associate it to instance_id
     void register_static_op_function(void) {
       int rank;
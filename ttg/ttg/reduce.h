@@ -5,10 +5,21 @@
 #ifndef TTG_REDUCE_H
 #define TTG_REDUCE_H
 
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include "ttg/tt.h"
+#include "ttg/util/env.h"
+#include "ttg/util/print.h"
 #include "ttg/util/tree.h"
 
 namespace ttg {
@@ -100,41 +111,407 @@ namespace ttg {
     }
   };
 
-#if 0
-/// @brief generic reduction operation
-///
-/// This reduces a set of {Key,Value} pairs using Reducer
-///
-template <typename InKey, template Value, template Reducer, template OutKey>
-class Reduce : public TT<InKey, std::tuple<Out<OutKey, Value>>, Reduce<InKey, Value, Reducer, OutKey>, Value> {
- public:
-  using baseT = TT<InKey, std::tuple<Out<OutKey, Value>>, Reduce<InKey, Value, Reducer, OutKey>, Value>;
-
-  Reduce(Edge<InKey, Value> &in, Edge<OutKey, Value> &out, OutKey dest_key = OutKey(), std::size_t nitems = 1,
-         World &world = default_execution_context())
-      : baseT(edges(in), edges(out, Edge<OutKey, Value>("reduce")), "Reduce", {"in"}, {"out"}, world)
-      , dest_key_(dest_key)
-      , nitems_(nitems) {}
-
-  void op(const InKey &key, baseT::input_values_tuple_type &&indata, std::tuple<Out<OutKey, Value>> &outdata) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (nitems_) {
-      reducer_(value_, baseT::get<0>(indata));
-      --nitems_;
+  /// @brief generic reduction of a set of key-value pairs over a spanning tree of selectable shape
+  ///
+  /// This reduces a set of Value objects keyed by an integer in the @c [0,max_key) interval using BinaryOp @c op ,
+  /// over a SpanningTree of shape @c shape rooted at @c root . Each node receives its own value and the values
+  /// reduced by its subtrees on a single streaming input terminal, and reduces them in the order of arrival; hence,
+  /// unlike BinaryTreeReduce, @c op must be commutative as well as associative, but no stub values are needed.
+  /// The primary use is for reducing over a World, hence by default the keymap is identity (keymap(key) = key) and
+  /// @c max_key=world.size() . The result is associated with output key @c dest_key .
+  ///
+  /// @note this is equivalent to MPI_Reduce; unlike std::reduce this lacks the initializer value.
+  /// @note each key receives exactly one value, hence a TreeReduce object performs a single reduction.
+  ///
+  template <typename Value, typename BinaryOp, typename OutKey>
+  class TreeReduce : public TT<int, std::tuple<Out<int, Value>, Out<OutKey, Value>>,
+                               TreeReduce<Value, BinaryOp, OutKey>, ttg::typelist<Value>> {
+   public:
+    using baseT = typename TreeReduce::ttT;
+
+    TreeReduce(Edge<int, Value> &in, Edge<OutKey, Value> &out, TreeShape shape = TreeShape::binary, int arity = 2,
+               int root = 0, OutKey dest_key = OutKey(), BinaryOp op = BinaryOp{},
+               World world = ttg::default_execution_context(), int max_key = -1,
+               Edge<int, Value> inout = Edge<int, Value>{})
+        : baseT(edges(fuse(in, inout)), edges(inout, out), "TreeReduce", {"in|inout"}, {"inout", "out"}, world,
+                [](int key) { return key; })
+        , tree_((max_key == -1 ? world.size() : max_key), root, shape, arity)
+        , dest_key_(dest_key)
+        , op_(std::move(op)) {
+      init();
+    }
+
+    void op(const int &key, typename baseT::input_values_tuple_type &&indata,
+            std::tuple<Out<int, Value>, Out<OutKey, Value>> &outdata) {
+      assert(key < tree_.size());
+      assert(key == this->get_world().rank());
+      auto parent = tree_.parent_key(key);
+      if (parent != -1)
+        send<0>(parent, baseT::template get<0, Value &&>(indata), outdata);
+      else
+        send<1>(dest_key_, baseT::template get<0, Value &&>(indata), outdata);
+    }
+
+   private:
+    SpanningTree tree_;
+    OutKey dest_key_;
+    BinaryOp op_;
+
+    /// each node expects its own value and one value per child
+    void init() {
+      this->template set_input_reducer<0>([op = op_](Value &a, const Value &b) { a = op(std::move(a), b); });
+      const auto my_rank = this->get_world().rank();
+      for (auto key = 0; key != tree_.size(); ++key) {
+        if (my_rank == this->get_keymap()(key)) this->template set_argstream_size<0>(key, 1 + tree_.num_children(key));
+      }
+    }
+  };
+
+  /// Specialize to (a class that provides the members of) `reduce_slicing<std::vector<T>>` to allow reducing objects of
+  /// type @p Value in segments (see make_segmented_tree_reduce())
+  template <typename Value, typename Enabler = void>
+  struct reduce_slicing {
+    static constexpr bool enabled = false;
+  };
+
+  /// vectors are sliced into contiguous ranges of elements
+  template <typename T, typename Allocator>
+  struct reduce_slicing<std::vector<T, Allocator>> {
+    using value_type = std::vector<T, Allocator>;
+    static constexpr bool enabled = true;
+
+    /// @return the number of elements of @p value
+    static std::size_t size(const value_type &value) { return value.size(); }
+    /// @return the elements @c [begin,end) of @p value
+    static value_type slice(const value_type &value, std::size_t begin, std::size_t end) {
+      return value_type(value.begin() + begin, value.begin() + end, value.get_allocator());
+    }
+    /// @return the concatenation of @p slices
+    static value_type join(std::vector<value_type> &&slices) {
+      std::size_t size = 0;
+      for (const auto &slice : slices) size += slice.size();
+      value_type result(std::move(slices.front()));
+      result.reserve(size);
+      for (std::size_t s = 1; s < slices.size(); ++s)
+        result.insert(result.end(), std::make_move_iterator(slices[s].begin()),
+                      std::make_move_iterator(slices[s].end()));
+      return result;
+    }
+  };
+
+  namespace detail {
+
+    /// the key of segment @c segment of the value of node @c node of a tree of size @c tree_size in a
+    /// SegmentedTreeReduce
+    inline int segment_key(int node, int segment, int tree_size) { return segment * tree_size + node; }
+
+    /// splits each input value into @c nsegments segments (see reduce_slicing) keyed by segment_key()
+    template <typename Value>
+    class SegmentSplitter : public TT<int, std::tuple<Out<int, Value>>, SegmentSplitter<Value>, ttg::typelist<Value>> {
+     public:
+      using baseT = typename SegmentSplitter::ttT;
+      using slicing = reduce_slicing<Value>;
+      static_assert(slicing::enabled, "ttg::detail::SegmentSplitter: specialize ttg::reduce_slicing for Value");
+
+      SegmentSplitter(Edge<int, Value> &in, Edge<int, Value> &out, int nsegments, int tree_size, World world)
+          : baseT(edges(in), edges(out), "SegmentSplitter", {"in"}, {"segments"}, world, [](int key) { return key; })
+          , nsegments_(nsegments)
+          , tree_size_(tree_size) {}
+
+      void op(const int &key, typename baseT::input_values_tuple_type &&indata, std::tuple<Out<int, Value>> &outdata) {
+        const Value &value = baseT::template get<0, const Value &>(indata);
+        const std::size_t size = slicing::size(value);
+        for (int s = 0; s != nsegments_; ++s)
+          send<0>(segment_key(key, s, tree_size_),
+                  slicing::slice(value, size * s / nsegments_, size * (s + 1) / nsegments_), outdata);
+      }
+
+     private:
+      int nsegments_;
+      int tree_size_;
+    };
+
+  }  // namespace detail
+
+  /// @brief reduction over a spanning tree of selectable shape of values split into segments
+  ///
+  /// Same as TreeReduce, but reduces (elementwise) each of the @c nsegments segments of the values independently, so
+  /// that segments flow up the tree in a pipeline: a node reduces one segment while its children still send the next.
+  /// The input values are segments keyed by @c detail::segment_key(node,segment,max_key) (see
+  /// make_segmented_tree_reduce(), which splits whole values), and the result is reassembled by the root's process.
+  ///
+  template <typename Value, typename BinaryOp, typename OutKey>
+  class SegmentedTreeReduce : public TT<int, std::tuple<Out<int, Value>, Out<OutKey, Value>>,
+                                        SegmentedTreeReduce<Value, BinaryOp, OutKey>, ttg::typelist<Value>> {
+   public:
+    using baseT = typename SegmentedTreeReduce::ttT;
+    using slicing = reduce_slicing<Value>;
+    static_assert(slicing::enabled, "ttg::SegmentedTreeReduce: specialize ttg::reduce_slicing for Value");
+
+    SegmentedTreeReduce(Edge<int, Value> &in, Edge<OutKey, Value> &out, int nsegments,
+                        TreeShape shape = TreeShape::binary, int arity = 2, int root = 0, OutKey dest_key = OutKey(),
+                        BinaryOp op = BinaryOp{}, World world = ttg::default_execution_context(), int max_key = -1,
+                        Edge<int, Value> inout = Edge<int, Value>{})
+        : baseT(edges(fuse(in, inout)), edges(inout, out), "SegmentedTreeReduce", {"in|inout"}, {"inout", "out"},
+                world, [size = (max_key == -1 ? world.size() : max_key)](int key) { return key % size; })
+        , tree_((max_key == -1 ? world.size() : max_key), root, shape, arity)
+        , nsegments_(nsegments)
+        , dest_key_(dest_key)
+        , op_(std::move(op))
+        , segments_(nsegments) {
+      assert(nsegments > 0);
+      init();
+    }
+
+    void op(const int &key, typename baseT::input_values_tuple_type &&indata,
+            std::tuple<Out<int, Value>, Out<OutKey, Value>> &outdata) {
+      const auto node = key % tree_.size();
+      const auto segment = key / tree_.size();
+      assert(segment < nsegments_);
+      auto parent = tree_.parent_key(node);
+      if (parent != -1) {
+        send<0>(detail::segment_key(parent, segment, tree_.size()), baseT::template get<0, Value &&>(indata), outdata);
+      } else {
+        std::vector<Value> segments;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          segments_[segment] = baseT::template get<0, Value &&>(indata);
+          if (++nreceived_ == nsegments_) segments.swap(segments_);
+        }
+        if (!segments.empty()) send<1>(dest_key_, slicing::join(std::move(segments)), outdata);
+      }
     }
-    if (nitems_ == 0) {
-      binary_tree_reduce_.set_arg<0>(world.rank(), std::move(value_));
+
+   private:
+    SpanningTree tree_;
+    int nsegments_;
+    OutKey dest_key_;
+    BinaryOp op_;
+    std::mutex mutex_;
+    std::vector<Value> segments_;  //!< the reduced segments received by the root
+    int nreceived_ = 0;
+
+    /// each segment of each node expects its own value and one value per child
+    void init() {
+      this->template set_input_reducer<0>([op = op_](Value &a, const Value &b) { a = op(std::move(a), b); });
+      const auto my_rank = this->get_world().rank();
+      for (auto node = 0; node != tree_.size(); ++node) {
+        if (my_rank == this->get_keymap()(node)) {
+          for (auto s = 0; s != nsegments_; ++s)
+            this->template set_argstream_size<0>(detail::segment_key(node, s, tree_.size()),
+                                                 1 + tree_.num_children(node));
+        }
+      }
     }
+  };
+
+  /// @brief makes a TTG that splits the values keyed by an integer in the @c [0,max_key) interval into @c nsegments
+  /// segments and reduces them with a SegmentedTreeReduce
+  ///
+  /// @return a TTG with input terminal @c in and output terminal @c out (see TreeReduce for the other parameters)
+  template <typename Value, typename BinaryOp, typename OutKey>
+  auto make_segmented_tree_reduce(Edge<int, Value> &in, Edge<OutKey, Value> &out, int nsegments,
+                                  TreeShape shape = TreeShape::binary, int arity = 2, int root = 0,
+                                  OutKey dest_key = OutKey(), BinaryOp op = BinaryOp{},
+                                  World world = ttg::default_execution_context(), int max_key = -1) {
+    const auto tree_size = max_key == -1 ? world.size() : max_key;
+    Edge<int, Value> segments("segments");
+    auto splitter = std::make_unique<detail::SegmentSplitter<Value>>(in, segments, nsegments, tree_size, world);
+    auto reduce = std::make_unique<SegmentedTreeReduce<Value, BinaryOp, OutKey>>(
+        segments, out, nsegments, shape, arity, root, dest_key, std::move(op), world, max_key);
+    auto ins = std::make_tuple(splitter->template in<0>());
+    auto outs = std::make_tuple(reduce->template out<1>());
+    std::vector<std::unique_ptr<TTBase>> ops;
+    ops.emplace_back(std::move(splitter));
+    ops.emplace_back(std::move(reduce));
+    return make_ttg(std::move(ops), ins, outs, "SegmentedTreeReduce");
   }
 
- private:
-  OutKey dest_key_;
-  size_t nitems_;
-  std::mutex mutex_;
-  Value value_;
-  Reducer reducer_;
-};  // class Reduce
-#endif
+  namespace detail {
+
+    /// combines the values processed by this process of a Reduce, then sends the result, keyed by the rank, to the
+    /// TreeReduce over the processes (see Reduce)
+    template <typename InKey, typename Value, typename BinaryOp>
+    class LocalReduce
+        : public TT<InKey, std::tuple<Out<int, Value>>, LocalReduce<InKey, Value, BinaryOp>, ttg::typelist<Value>> {
+     public:
+      using baseT = typename LocalReduce::ttT;
+
+      LocalReduce(Edge<InKey, Value> &in, Edge<int, Value> &out, std::size_t nitems, BinaryOp op, Value identity,
+                  World world)
+          : baseT(edges(in), edges(out), "LocalReduce", {"in"}, {"result"}, world)
+          , nitems_(nitems)
+          , op_(std::move(op))
+          , identity_(std::move(identity))
+          , nslots_(ttg::detail::num_threads() + 1)
+          , slots_(std::make_unique<partial_result_t[]>(nslots_)) {}
+
+      void op(const InKey &key, typename baseT::input_values_tuple_type &&indata,
+              std::tuple<Out<int, Value>> &outdata) {
+        if (nitems_ == 0 && contributed_.load(std::memory_order_acquire)) {
+          ttg::print_error(this->get_world().rank(), ":", this->get_name(), " : received a value after finalize()");
+          throw std::runtime_error("ttg::Reduce: received a value after finalize()");
+        }
+        auto &partial = partial_result().value;
+        if (partial)
+          partial = op_(std::move(*partial), baseT::template get<0, const Value &>(indata));
+        else
+          partial = baseT::template get<0, Value &&>(indata);
+        if (nitems_ != 0) {
+          // the partial result is released to the thread that processes the last value
+          const auto nprocessed = nprocessed_.fetch_add(1, std::memory_order_acq_rel) + 1;
+          if (nprocessed > nitems_) {
+            ttg::print_error(this->get_world().rank(), ":", this->get_name(), " : received more than ", nitems_,
+                             " values");
+            throw std::runtime_error("ttg::Reduce: received more values than expected");
+          }
+          if (nprocessed == nitems_) contribute();
+        }
+      }
+
+      /// see Reduce::finalize()
+      void finalize() {
+        if (nitems_ != 0) {
+          ttg::print_error(this->get_world().rank(), ":", this->get_name(), " : finalize() called, but ", nitems_,
+                           " values were expected");
+          throw std::logic_error("ttg::Reduce::finalize: the process contributes after nitems values");
+        }
+        if (contributed_.load(std::memory_order_acquire)) {
+          ttg::print_error(this->get_world().rank(), ":", this->get_name(), " : finalize() called twice");
+          throw std::logic_error("ttg::Reduce::finalize: called twice");
+        }
+        contribute();
+      }
+
+     private:
+      /// the partial result of one thread, on its own cache line
+      struct alignas(64) partial_result_t {
+        std::atomic<std::thread::id> owner{};  //!< the thread that owns this slot, if any
+        std::optional<Value> value;
+      };
+
+      std::size_t nitems_;
+      BinaryOp op_;
+      Value identity_;
+      std::atomic<std::size_t> nprocessed_ = 0;
+      std::atomic<bool> contributed_ = false;  //!< whether this process contributed to the reduction over processes
+      /// the slots of the partial results, one per worker thread and one for the main thread
+      const std::size_t nslots_;
+      std::unique_ptr<partial_result_t[]> slots_;
+      std::mutex overflow_mutex_;              //!< guards overflow_
+      std::list<partial_result_t> overflow_;   //!< the partial results of the threads that found no free slot
+
+      /// @return the partial result of the calling thread, in the first free slot after the one its id hashes to;
+      ///         only the threads that find no free slot, if more threads process values than expected, take a lock
+      partial_result_t &partial_result() {
+        const auto me = std::this_thread::get_id();
+        const std::size_t first = std::hash<std::thread::id>{}(me) % nslots_;
+        for (std::size_t i = 0; i != nslots_; ++i) {
+          auto &slot = slots_[(first + i) % nslots_];
+          auto owner = slot.owner.load(std::memory_order_acquire);
+          if (owner == me) return slot;
+          if (owner == std::thread::id{} && slot.owner.compare_exchange_strong(owner, me, std::memory_order_acq_rel))
+            return slot;
+        }
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        for (auto &partial : overflow_)
+          if (partial.owner.load(std::memory_order_relaxed) == me) return partial;
+        overflow_.emplace_back().owner.store(me, std::memory_order_relaxed);
+        return overflow_.back();
+      }
+
+      /// sends the combination of the partial results, or identity_ if there are none, to the reduction over the
+      /// processes
+      void contribute() {
+        std::optional<Value> result;
+        auto combine = [&](partial_result_t &partial) {
+          if (!partial.value) return;
+          if (result)
+            result = op_(std::move(*result), *partial.value);
+          else
+            result = std::move(partial.value);
+          partial.value.reset();
+        };
+        contributed_.store(true, std::memory_order_release);
+        for (std::size_t i = 0; i != nslots_; ++i) combine(slots_[i]);
+        {
+          std::lock_guard<std::mutex> lock(overflow_mutex_);
+          for (auto &partial : overflow_) combine(partial);
+        }
+        this->template out<0>()->send(this->get_world().rank(), result ? std::move(*result) : identity_);
+      }
+    };
+
+  }  // namespace detail
+
+  /// @brief generic keyed many-to-one reduction
+  ///
+  /// This reduces the Value objects sent to it, each keyed by a distinct @c InKey , using BinaryOp @c op into a single
+  /// Value associated with output key @c dest_key . The values are combined in three stages:
+  /// - each thread combines the values it processes into its own partial result, without synchronization;
+  /// - once all values of a process have been processed, the partial results of its threads are combined;
+  /// - the results of the processes are reduced over a TreeReduce rooted at process @c root .
+  /// The first two stages are performed by a detail::LocalReduce TT, connected to the TreeReduce by an edge; Reduce is
+  /// the TTG of both, with the input terminal of the former and the output terminal of the latter.
+  ///
+  /// Every process must contribute exactly once, else the reduction over the processes never completes. @c nitems is
+  /// the number of values processed by this process (i.e. mapped to it by the keymap), and may differ between
+  /// processes: the process contributes once it has processed @c nitems values. A process that passes zero, e.g.
+  /// because it processes no values or does not know their number, contributes when it calls finalize(), which it
+  /// must do. A process that processed no values contributes @c identity . Since the values are combined in no
+  /// particular order, @c op must be commutative as well as associative.
+  ///
+  /// @note each key receives exactly one value, hence a Reduce object performs a single reduction.
+  ///
+  template <typename InKey, typename Value, typename BinaryOp, typename OutKey>
+  class Reduce : public TTG<std::tuple<In<InKey, Value> *>, std::tuple<Out<OutKey, Value> *>> {
+    using local_type = detail::LocalReduce<InKey, Value, BinaryOp>;
+    using tree_type = TreeReduce<Value, BinaryOp, OutKey>;
+
+   public:
+    using baseT = TTG<std::tuple<In<InKey, Value> *>, std::tuple<Out<OutKey, Value> *>>;
+
+    Reduce(Edge<InKey, Value> &in, Edge<OutKey, Value> &out, std::size_t nitems = 0, OutKey dest_key = OutKey(),
+           BinaryOp op = BinaryOp{}, Value identity = Value(), TreeShape shape = TreeShape::binary, int arity = 2,
+           int root = 0, World world = ttg::default_execution_context())
+        : Reduce(make_parts(in, out, nitems, dest_key, std::move(op), std::move(identity), shape, arity, root, world)) {
+    }
+
+    /// Combines the values processed by this process and contributes them to the reduction over the processes; must
+    /// be called once, after this process has processed all of its values, by every process that passed zero
+    /// @c nitems
+    /// @throw std::logic_error if this process passed nonzero @c nitems , or already called finalize()
+    void finalize() { local_->finalize(); }
+
+    /// sets the keymap of the input values, i.e. which process processes each of them
+    template <typename Keymap>
+    void set_keymap(Keymap &&keymap) {
+      local_->set_keymap(std::forward<Keymap>(keymap));
+    }
+
+   private:
+    struct parts {
+      std::vector<std::unique_ptr<TTBase>> tts;
+      local_type *local;
+      std::tuple<In<InKey, Value> *> ins;
+      std::tuple<Out<OutKey, Value> *> outs;
+    };
+
+    static parts make_parts(Edge<InKey, Value> &in, Edge<OutKey, Value> &out, std::size_t nitems, OutKey dest_key,
+                            BinaryOp op, Value identity, TreeShape shape, int arity, int root, World world) {
+      Edge<int, Value> results("results");
+      auto local = std::make_unique<local_type>(in, results, nitems, op, std::move(identity), world);
+      auto tree = std::make_unique<tree_type>(results, out, shape, arity, root, dest_key, std::move(op), world);
+      parts result{{}, local.get(), std::make_tuple(local->template in<0>()), std::make_tuple(tree->template out<1>())};
+      result.tts.emplace_back(std::move(local));
+      result.tts.emplace_back(std::move(tree));
+      return result;
+    }
+
+    explicit Reduce(parts &&p) : baseT(std::move(p.tts), p.ins, p.outs, "Reduce"), local_(p.local) {}
+
+    local_type *local_;  //!< owned by the base
+  };  // class Reduce
 
 }  // namespace ttg
 
@@ -16,6 +16,8 @@
 #include <boost/archive/impl/basic_binary_oarchive.ipp>
 #include <boost/archive/impl/basic_binary_oprimitive.ipp>
 
+#include "ttg/serialization/stream.h"
+
 namespace ttg::detail {
 
   // used to serialize data only
@@ -141,6 +143,7 @@ namespace ttg::detail {
 
     const auto& streambuf() const { return this->pbase(); }
     const auto& stream() const { return this->pbase(); }
+    auto& stream() { return this->pbase(); }
   };
 
   /// an archive that counts the size of serialized representation of an object
@@ -149,6 +152,9 @@ namespace ttg::detail {
   /// an archive that constructs an IOVEC (= sequence of {pointer,size} pairs) representation of an object
   using boost_iovec_oarchive = boost_optimized_oarchive<iovec_ostreambuf>;
 
+  /// an archive that serializes an object in gather mode (see gather_ostreambuf)
+  using boost_gather_oarchive = boost_optimized_oarchive<gather_ostreambuf>;
+
   /// an archive that constructs serialized representation of an object in a memory buffer
   using boost_buffer_oarchive =
       boost_optimized_oarchive<boost::iostreams::stream<boost::iostreams::basic_array_sink<char>>>;
@@ -246,6 +252,9 @@ namespace ttg::detail {
   /// the deserializer for boost_iovec_oarchive
   using boost_iovec_iarchive = boost_optimized_iarchive<iovec_istreambuf>;
 
+  /// the deserializer for boost_gather_oarchive
+  using boost_scatter_iarchive = boost_optimized_iarchive<scatter_istreambuf>;
+
   /// the deserializer for boost_buffer_oarchive
   using boost_buffer_iarchive =
       boost_optimized_iarchive<boost::iostreams::stream<boost::iostreams::basic_array_source<char>>>;
@@ -287,10 +296,14 @@ BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_counting_oarchive);
 BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_counting_oarchive);
 BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_iovec_oarchive);
 BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_iovec_oarchive);
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_gather_oarchive);
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_gather_oarchive);
 BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_buffer_oarchive);
 BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_buffer_oarchive);
 BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_iovec_iarchive);
 BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_iovec_iarchive);
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_scatter_iarchive);
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_scatter_iarchive);
 BOOST_SERIALIZATION_REGISTER_ARCHIVE(ttg::detail::boost_buffer_iarchive);
 BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION_FOR_THIS_AND_BASE(ttg::detail::boost_buffer_iarchive);
 
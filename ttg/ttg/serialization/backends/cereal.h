@@ -12,6 +12,8 @@
 #include <cereal/cereal.hpp>
 #include <cereal/details/helpers.hpp>
 #include <cereal/details/traits.hpp>
+
+#include "ttg/serialization/backends/cereal/archive.h"
 #endif
 
 namespace ttg::detail {
@@ -37,12 +39,13 @@ namespace ttg::detail {
 
 #ifdef TTG_SERIALIZATION_SUPPORTS_CEREAL
   template <typename T>
-  struct is_cereal_buffer_serializable<T, std::enable_if_t<is_cereal_serializable_v<cereal::BinaryInputArchive, T> &&
-                                                           is_cereal_serializable_v<cereal::BinaryOutputArchive, T>>>
+  struct is_cereal_buffer_serializable<T, std::enable_if_t<is_cereal_serializable_v<cereal_buffer_iarchive, T> &&
+                                                           is_cereal_serializable_v<cereal_buffer_oarchive, T>>>
       : std::true_type {};
 #endif  // TTG_SERIALIZATION_SUPPORTS_CEREAL
 
-  /// evaluates to true if can serialize @p T to/from buffer using Cereal serialization
+  /// evaluates to true if can serialize @p T to/from buffer using Cereal serialization (i.e., using
+  /// cereal_buffer_oarchive and cereal_buffer_iarchive)
   template <typename T>
   inline constexpr bool is_cereal_buffer_serializable_v = is_cereal_buffer_serializable<T>::value;
 
@@ -85,8 +88,8 @@ namespace ttg::detail {
 #ifdef TTG_SERIALIZATION_SUPPORTS_CEREAL
   template <typename T>
   struct is_cereal_user_buffer_serializable<
-      T, std::enable_if_t<is_cereal_user_serializable_v<cereal::BinaryInputArchive, T> ||
-                          is_cereal_user_serializable_v<cereal::BinaryOutputArchive, T>>> : std::true_type {};
+      T, std::enable_if_t<is_cereal_user_serializable_v<cereal_buffer_iarchive, T> ||
+                          is_cereal_user_serializable_v<cereal_buffer_oarchive, T>>> : std::true_type {};
 #endif  // TTG_SERIALIZATION_SUPPORTS_CEREAL
 
   /// evaluates to true if can serialize @p T to/from buffer using user-provided Cereal serialization
@@ -0,0 +1,133 @@
+#ifndef TTG_SERIALIZATION_BACKENDS_CEREAL_ARCHIVE_H
+#define TTG_SERIALIZATION_BACKENDS_CEREAL_ARCHIVE_H
+
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include <cereal/cereal.hpp>
+#include <cereal/details/helpers.hpp>
+#include <cereal/details/traits.hpp>
+
+namespace ttg::detail {
+
+  /// Cereal binary output archive that writes directly to a raw memory buffer
+
+  /// Produces the same representation as `cereal::BinaryOutputArchive`, but without the overhead of `std::ostream`.
+  /// Contiguous arrays of arithmetic types (`cereal::BinaryData`, used by the Cereal serializers of `std::vector`,
+  /// `std::array`, `std::string`, and C arrays) are copied with a single `memcpy`.
+  /// A default-constructed archive only counts the bytes.
+  class cereal_buffer_oarchive : public cereal::OutputArchive<cereal_buffer_oarchive, cereal::AllowEmptyClassElision> {
+   public:
+    /// constructs an archive that counts the bytes of the serialized representation without writing it
+    cereal_buffer_oarchive()
+        : cereal::OutputArchive<cereal_buffer_oarchive, cereal::AllowEmptyClassElision>(this)
+        , buf_(nullptr)
+        , size_(std::numeric_limits<std::size_t>::max()) {}
+
+    /// @param[out] buf the buffer to write to
+    /// @param[in] size the size of @p buf , in bytes
+    /// @param[in] pos the position in @p buf at which to start writing
+    cereal_buffer_oarchive(void* buf, std::size_t size, std::size_t pos = 0)
+        : cereal::OutputArchive<cereal_buffer_oarchive, cereal::AllowEmptyClassElision>(this)
+        , buf_(static_cast<unsigned char*>(buf))
+        , size_(size)
+        , pos_(pos) {}
+
+    /// @throw cereal::Exception if the data do not fit into the buffer
+    void saveBinary(const void* data, std::streamsize n) {
+      if (static_cast<std::size_t>(n) > size_ - pos_)
+        throw cereal::Exception("ttg::detail::cereal_buffer_oarchive::saveBinary: buffer overflow");
+      if (buf_) std::memcpy(buf_ + pos_, data, n);
+      pos_ += n;
+    }
+
+    /// @return the position in the buffer after the last byte written (or counted)
+    std::size_t pos() const { return pos_; }
+
+   private:
+    unsigned char* buf_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+  };
+
+  /// Cereal binary input archive that reads directly from a raw memory buffer (see cereal_buffer_oarchive)
+  class cereal_buffer_iarchive : public cereal::InputArchive<cereal_buffer_iarchive, cereal::AllowEmptyClassElision> {
+   public:
+    /// @param[in] buf the buffer to read from
+    /// @param[in] size the size of @p buf , in bytes
+    /// @param[in] pos the position in @p buf at which to start reading
+    cereal_buffer_iarchive(const void* buf, std::size_t size, std::size_t pos = 0)
+        : cereal::InputArchive<cereal_buffer_iarchive, cereal::AllowEmptyClassElision>(this)
+        , buf_(static_cast<const unsigned char*>(buf))
+        , size_(size)
+        , pos_(pos) {}
+
+    /// @throw cereal::Exception if the buffer does not contain the data
+    void loadBinary(void* const data, std::streamsize n) {
+      if (static_cast<std::size_t>(n) > size_ - pos_)
+        throw cereal::Exception("ttg::detail::cereal_buffer_iarchive::loadBinary: buffer underflow");
+      std::memcpy(data, buf_ + pos_, n);
+      pos_ += n;
+    }
+
+    /// @return the position in the buffer after the last byte read
+    std::size_t pos() const { return pos_; }
+
+   private:
+    const unsigned char* buf_;
+    std::size_t size_;
+    std::size_t pos_;
+  };
+
+}  // namespace ttg::detail
+
+namespace cereal {
+
+  // serializers of the primitives of ttg::detail::cereal_buffer_{i,o}archive, same as those of the Cereal binary
+  // archives
+
+  template <class T>
+  inline std::enable_if_t<std::is_arithmetic_v<T>> CEREAL_SAVE_FUNCTION_NAME(ttg::detail::cereal_buffer_oarchive& ar,
+                                                                             const T& t) {
+    ar.saveBinary(std::addressof(t), sizeof(t));
+  }
+
+  template <class T>
+  inline std::enable_if_t<std::is_arithmetic_v<T>> CEREAL_LOAD_FUNCTION_NAME(ttg::detail::cereal_buffer_iarchive& ar,
+                                                                             T& t) {
+    ar.loadBinary(std::addressof(t), sizeof(t));
+  }
+
+  template <class Archive, class T>
+  inline CEREAL_ARCHIVE_RESTRICT(ttg::detail::cereal_buffer_iarchive, ttg::detail::cereal_buffer_oarchive)
+      CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, NameValuePair<T>& t) {
+    ar(t.value);
+  }
+
+  template <class Archive, class T>
+  inline CEREAL_ARCHIVE_RESTRICT(ttg::detail::cereal_buffer_iarchive, ttg::detail::cereal_buffer_oarchive)
+      CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, SizeTag<T>& t) {
+    ar(t.size);
+  }
+
+  template <class T>
+  inline void CEREAL_SAVE_FUNCTION_NAME(ttg::detail::cereal_buffer_oarchive& ar, const BinaryData<T>& bd) {
+    ar.saveBinary(bd.data, static_cast<std::streamsize>(bd.size));
+  }
+
+  template <class T>
+  inline void CEREAL_LOAD_FUNCTION_NAME(ttg::detail::cereal_buffer_iarchive& ar, BinaryData<T>& bd) {
+    ar.loadBinary(bd.data, static_cast<std::streamsize>(bd.size));
+  }
+
+}  // namespace cereal
+
+CEREAL_REGISTER_ARCHIVE(ttg::detail::cereal_buffer_oarchive)
+CEREAL_REGISTER_ARCHIVE(ttg::detail::cereal_buffer_iarchive)
+CEREAL_SETUP_ARCHIVE_TRAITS(ttg::detail::cereal_buffer_iarchive, ttg::detail::cereal_buffer_oarchive)
+
+#endif  // TTG_SERIALIZATION_BACKENDS_CEREAL_ARCHIVE_H
@@ -5,4 +5,322 @@
 #ifndef TTG_SERIALIZATION_BUFFER_ARCHIVE_H
 #define TTG_SERIALIZATION_BUFFER_ARCHIVE_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ttg/serialization/traits.h"
+#include "ttg/util/meta.h"
+
+// TTG's native binary archives: they (de)serialize directly to/from a flat buffer without streams, type registration,
+// or virtual dispatch. User-defined types opt in by providing a member `serialize(Archive&)` or a freestanding
+// `serialize(Archive&, T&)` that applies `ar & member` to each member; the same function is used for input and
+// output, use ttg::detail::is_output_archive_v<Archive> to tell them apart, if needed. Trivially-copyable data,
+// including contiguous ranges thereof, is copied with memcpy; sizes of containers are encoded as LEB128 varints.
+
+namespace ttg::detail {
+
+  class buffer_oarchive;
+  class buffer_counting_oarchive;
+  class buffer_iarchive;
+
+  template <typename T>
+  inline constexpr bool is_ttg_buffer_archive_v =
+      std::is_same_v<T, buffer_oarchive> || std::is_same_v<T, buffer_counting_oarchive> ||
+      std::is_same_v<T, buffer_iarchive>;
+
+  template <typename T>
+  inline constexpr bool is_archive_v<T, std::enable_if_t<is_ttg_buffer_archive_v<T>>> = true;
+  template <typename T>
+  inline constexpr bool is_input_archive_v<T, std::enable_if_t<std::is_same_v<T, buffer_iarchive>>> = true;
+  template <typename T>
+  inline constexpr bool is_output_archive_v<
+      T, std::enable_if_t<std::is_same_v<T, buffer_oarchive> || std::is_same_v<T, buffer_counting_oarchive>>> = true;
+
+  /*----- is_ttg_{user_,}buffer_serializable_v -----*/
+
+  /// evaluates to true if @p T provides serialization methods for the TTG buffer archives
+  /// @note declared in traits.h
+  template <typename T, typename Enabler>
+  struct is_ttg_user_buffer_serializable : std::false_type {};
+
+  template <typename T>
+  struct is_ttg_user_buffer_serializable<
+      T, std::enable_if_t<(has_member_serialize_v<T, buffer_oarchive> || has_freestanding_serialize_v<T, buffer_oarchive>)&&(
+             has_member_serialize_v<T, buffer_iarchive> || has_freestanding_serialize_v<T, buffer_iarchive>)>>
+      : std::true_type {};
+
+  /// evaluates to true if can serialize @p T to/from buffer using user-provided methods for the TTG buffer archives
+  template <typename T>
+  inline constexpr bool is_ttg_user_buffer_serializable_v =
+      is_ttg_user_buffer_serializable<std::remove_cv_t<T>>::value;
+
+  template <typename T, typename Enabler = void>
+  struct is_ttg_buffer_serializable
+      : std::bool_constant<is_ttg_user_buffer_serializable_v<T> || std::is_trivially_copyable_v<T>> {};
+
+  template <typename T, std::size_t N>
+  struct is_ttg_buffer_serializable<T[N]> : is_ttg_buffer_serializable<T> {};
+  template <typename T, std::size_t N>
+  struct is_ttg_buffer_serializable<std::array<T, N>> : is_ttg_buffer_serializable<T> {};
+  template <typename T, typename A>
+  struct is_ttg_buffer_serializable<std::vector<T, A>> : is_ttg_buffer_serializable<T> {};
+  template <typename T, typename A>
+  struct is_ttg_buffer_serializable<std::list<T, A>> : is_ttg_buffer_serializable<T> {};
+  template <typename C, typename Traits, typename A>
+  struct is_ttg_buffer_serializable<std::basic_string<C, Traits, A>> : std::true_type {};
+  template <typename T1, typename T2>
+  struct is_ttg_buffer_serializable<std::pair<T1, T2>>
+      : std::bool_constant<is_ttg_buffer_serializable<std::remove_cv_t<T1>>::value &&
+                           is_ttg_buffer_serializable<std::remove_cv_t<T2>>::value> {};
+  template <typename... Ts>
+  struct is_ttg_buffer_serializable<std::tuple<Ts...>>
+      : std::bool_constant<(is_ttg_buffer_serializable<std::remove_cv_t<Ts>>::value && ...)> {};
+
+  /// evaluates to true if can serialize @p T to/from buffer using the TTG buffer archives
+  template <typename T>
+  inline constexpr bool is_ttg_buffer_serializable_v = is_ttg_buffer_serializable<std::remove_cv_t<T>>::value;
+
+  /*----- the archives -----*/
+
+  /// applies archive @p ar to @p t , recursing into the standard containers and the user-provided serialize methods
+  template <typename Archive, typename T>
+  void buffer_archive_serialize(Archive &ar, T &t);
+
+  /// CRTP base of the TTG buffer archives, provides the archive operators and the traversal of objects
+  template <typename Derived>
+  class buffer_archive_base {
+   public:
+    template <typename T>
+    Derived &operator&(T &&t) {
+      // output archives must accept const objects, but the user-provided serialize methods take non-const refs
+      buffer_archive_serialize(derived(), const_cast<std::remove_const_t<std::remove_reference_t<T>> &>(t));
+      return derived();
+    }
+
+   protected:
+    Derived &derived() { return static_cast<Derived &>(*this); }
+  };
+
+  /// LEB128 encoding of sizes
+  struct varint {
+    /// @return the number of bytes taken by the encoding of @p value
+    static std::size_t size(std::uint64_t value) {
+      std::size_t n = 1;
+      while (value >= 0x80) {
+        value >>= 7;
+        ++n;
+      }
+      return n;
+    }
+
+    /// encodes @p value into @p buf
+    /// @return the number of bytes written
+    static std::size_t encode(std::uint64_t value, unsigned char *buf) {
+      std::size_t n = 0;
+      while (value >= 0x80) {
+        buf[n++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+      }
+      buf[n++] = static_cast<unsigned char>(value);
+      return n;
+    }
+  };
+
+  /// output archive writing to a flat buffer of fixed capacity
+  class buffer_oarchive : public buffer_archive_base<buffer_oarchive> {
+   public:
+    /// @param[in] buf the buffer
+    /// @param[in] size the size of @p buf , in bytes
+    /// @param[in] pos the position in @p buf at which the first byte will be written
+    buffer_oarchive(void *buf, std::size_t size, std::size_t pos = 0)
+        : buf_(static_cast<unsigned char *>(buf)), size_(size), pos_(pos) {}
+
+    template <typename T>
+    buffer_oarchive &operator<<(const T &t) {
+      return *this & t;
+    }
+
+    /// writes @p n bytes located at @p data
+    void store(const void *data, std::size_t n) {
+      if (n > size_ - pos_) throw std::out_of_range("ttg::detail::buffer_oarchive::store: buffer overflow");
+      std::memcpy(buf_ + pos_, data, n);
+      pos_ += n;
+    }
+
+    /// writes size @p n , as a varint
+    void store_size(std::uint64_t n) {
+      if (varint::size(n) > size_ - pos_)
+        throw std::out_of_range("ttg::detail::buffer_oarchive::store_size: buffer overflow");
+      pos_ += varint::encode(n, buf_ + pos_);
+    }
+
+    /// @return the position in the buffer past the last byte written
+    std::size_t position() const { return pos_; }
+
+   private:
+    unsigned char *buf_;
+    std::size_t size_;
+    std::size_t pos_;
+  };
+
+  /// output archive that only computes the size of the archive
+  class buffer_counting_oarchive : public buffer_archive_base<buffer_counting_oarchive> {
+   public:
+    buffer_counting_oarchive() = default;
+
+    template <typename T>
+    buffer_counting_oarchive &operator<<(const T &t) {
+      return *this & t;
+    }
+
+    void store(const void *, std::size_t n) { size_ += n; }
+    void store_size(std::uint64_t n) { size_ += varint::size(n); }
+
+    /// @return the size of data put into `*this`
+    std::size_t size() const { return size_; }
+
+   private:
+    std::size_t size_ = 0;
+  };
+
+  /// input archive reading from a flat buffer
+  class buffer_iarchive : public buffer_archive_base<buffer_iarchive> {
+   public:
+    /// @param[in] buf the buffer
+    /// @param[in] size the size of @p buf , in bytes
+    /// @param[in] pos the position in @p buf of the first byte to read
+    buffer_iarchive(const void *buf, std::size_t size, std::size_t pos = 0)
+        : buf_(static_cast<const unsigned char *>(buf)), size_(size), pos_(pos) {}
+
+    template <typename T>
+    buffer_iarchive &operator>>(T &t) {
+      return *this & t;
+    }
+
+    /// reads @p n bytes into @p data
+    void load(void *data, std::size_t n) {
+      if (n > size_ - pos_) throw std::out_of_range("ttg::detail::buffer_iarchive::load: buffer underflow");
+      std::memcpy(data, buf_ + pos_, n);
+      pos_ += n;
+    }
+
+    /// reads a size written by buffer_oarchive::store_size()
+    std::uint64_t load_size() {
+      std::uint64_t n = 0;
+      for (int shift = 0; shift < 64; shift += 7) {
+        if (pos_ == size_) break;
+        const auto byte = buf_[pos_++];
+        n |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return n;
+      }
+      throw std::out_of_range("ttg::detail::buffer_iarchive::load_size: malformed size");
+    }
+
+    /// @return the position in the buffer past the last byte read
+    std::size_t position() const { return pos_; }
+
+   private:
+    const unsigned char *buf_;
+    std::size_t size_;
+    std::size_t pos_;
+  };
+
+  /// (de)serializes the raw bytes of @p n trivially-copyable objects located at @p data
+  template <typename Archive, typename T>
+  void buffer_archive_bitcopy(Archive &ar, T *data, std::size_t n) {
+    if constexpr (is_output_archive_v<Archive>)
+      ar.store(data, n * sizeof(T));
+    else
+      ar.load(data, n * sizeof(T));
+  }
+
+  /// (de)serializes a contiguous range, copying the elements at once if they are bit-copyable
+  template <typename Archive, typename T>
+  void buffer_archive_serialize_range(Archive &ar, T *data, std::size_t n) {
+    if constexpr (std::is_trivially_copyable_v<T> && !is_ttg_user_buffer_serializable_v<T>)
+      buffer_archive_bitcopy(ar, data, n);
+    else
+      for (std::size_t i = 0; i != n; ++i) buffer_archive_serialize(ar, data[i]);
+  }
+
+  /// (de)serializes the size of a container
+  template <typename Archive>
+  std::size_t buffer_archive_serialize_size(Archive &ar, std::size_t n) {
+    if constexpr (is_output_archive_v<Archive>) {
+      ar.store_size(n);
+      return n;
+    } else
+      return static_cast<std::size_t>(ar.load_size());
+  }
+
+  template <typename T>
+  inline constexpr bool is_std_vector_v = false;
+  template <typename T, typename A>
+  inline constexpr bool is_std_vector_v<std::vector<T, A>> = true;
+  template <typename T>
+  inline constexpr bool is_std_list_v = false;
+  template <typename T, typename A>
+  inline constexpr bool is_std_list_v<std::list<T, A>> = true;
+  template <typename T>
+  inline constexpr bool is_std_basic_string_v = false;
+  template <typename C, typename Traits, typename A>
+  inline constexpr bool is_std_basic_string_v<std::basic_string<C, Traits, A>> = true;
+  template <typename T>
+  inline constexpr bool is_std_array_v = false;
+  template <typename T, std::size_t N>
+  inline constexpr bool is_std_array_v<std::array<T, N>> = true;
+  template <typename T>
+  inline constexpr bool is_std_pair_or_tuple_v = false;
+  template <typename T1, typename T2>
+  inline constexpr bool is_std_pair_or_tuple_v<std::pair<T1, T2>> = true;
+  template <typename... Ts>
+  inline constexpr bool is_std_pair_or_tuple_v<std::tuple<Ts...>> = true;
+
+  template <typename Archive, typename T>
+  void buffer_archive_serialize(Archive &ar, T &t) {
+    static_assert(is_ttg_buffer_serializable_v<T>,
+                  "ttg::detail::buffer_archive_serialize: T is not serializable by the TTG buffer archives; provide "
+                  "member serialize(Archive&) or freestanding serialize(Archive&, T&)");
+    // user-provided methods take precedence over bitcopy
+    if constexpr (has_member_serialize_v<T, Archive>) {
+      t.serialize(ar);
+    } else if constexpr (has_freestanding_serialize_v<T, Archive>) {
+      serialize(ar, t);
+    } else if constexpr (std::is_array_v<T>) {
+      buffer_archive_serialize_range(ar, &t[0], std::extent_v<T>);
+    } else if constexpr (is_std_array_v<T>) {
+      buffer_archive_serialize_range(ar, t.data(), t.size());
+    } else if constexpr (is_std_vector_v<T> || is_std_basic_string_v<T>) {
+      const auto n = buffer_archive_serialize_size(ar, t.size());
+      if constexpr (!is_output_archive_v<Archive>) t.resize(n);
+      if constexpr (std::is_same_v<T, std::vector<bool, typename T::allocator_type>>) {
+        for (std::size_t i = 0; i != n; ++i) {
+          bool b = t[i];
+          buffer_archive_bitcopy(ar, &b, 1);
+          t[i] = b;
+        }
+      } else
+        buffer_archive_serialize_range(ar, t.data(), n);
+    } else if constexpr (is_std_list_v<T>) {
+      const auto n = buffer_archive_serialize_size(ar, t.size());
+      if constexpr (!is_output_archive_v<Archive>) t.resize(n);
+      for (auto &elem : t) buffer_archive_serialize(ar, elem);
+    } else if constexpr (is_std_pair_or_tuple_v<T>) {
+      std::apply([&ar](auto &...elems) { (buffer_archive_serialize(ar, elems), ...); }, t);
+    } else {
+      buffer_archive_bitcopy(ar, &t, 1);
+    }
+  }
+
+}  // namespace ttg::detail
+
 #endif  // TTG_SERIALIZATION_BUFFER_ARCHIVE_H
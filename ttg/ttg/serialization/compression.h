@@ -0,0 +1,182 @@
+#ifndef TTG_SERIALIZATION_COMPRESSION_H
+#define TTG_SERIALIZATION_COMPRESSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace ttg {
+
+  /// Specialize to (a class derived from) ttg::enable_payload_compression to have default data descriptors compress
+  /// the serialized representation of objects of type @p T (see detail::compressed_data_descriptor)
+  template <typename T, typename Enabler = void>
+  struct payload_compression {
+    static constexpr bool enabled = false;
+  };
+
+  /// Describes how to compress a serialized representation with the built-in byte-shuffle+RLE codec
+  /// @tparam ElementSize the size of the elements that make up most of the payload, e.g. `sizeof(double)`; the
+  ///         bytes of equal significance of consecutive elements are grouped together before compression
+  /// @tparam Threshold serialized representations shorter than this many bytes are not compressed
+  template <std::size_t ElementSize = sizeof(double), std::size_t Threshold = 4096>
+  struct enable_payload_compression {
+    static_assert(ElementSize > 0);
+    static constexpr bool enabled = true;
+    static constexpr std::size_t element_size = ElementSize;
+    static constexpr std::size_t threshold = Threshold;
+  };
+
+  namespace detail {
+
+    /// the number of bytes compressed and produced by the payload compression codec, in this process
+    struct payload_compression_stats {
+      /// the number of compressed payloads
+      std::atomic<std::uint64_t> npayloads = 0;
+      /// their total size before compression
+      std::atomic<std::uint64_t> uncompressed_bytes = 0;
+      /// their total size after compression
+      std::atomic<std::uint64_t> compressed_bytes = 0;
+
+      void record(std::uint64_t uncompressed, std::uint64_t compressed) {
+        npayloads.fetch_add(1, std::memory_order_relaxed);
+        uncompressed_bytes.fetch_add(uncompressed, std::memory_order_relaxed);
+        compressed_bytes.fetch_add(compressed, std::memory_order_relaxed);
+      }
+    };
+
+    /// @return the payload compression statistics of this process
+    inline payload_compression_stats &payload_compression_statistics() {
+      static payload_compression_stats stats;
+      return stats;
+    }
+
+    /// Byte-shuffle + run-length encoding codec
+
+    /// The input is viewed as a sequence of elements of `element_size` bytes (any trailing bytes are left in place),
+    /// and is transposed so that byte 0 of all elements comes first, then byte 1, etc. This groups the (often equal)
+    /// sign/exponent bytes of floating-point data, and turns zero elements into long runs of zero bytes. The shuffled
+    /// bytes are then encoded as a sequence of tokens: a control byte `c < 128` is followed by `c + 1` literal bytes,
+    /// a control byte `c >= 128` is followed by one byte that is repeated `c - 128 + min_run` times.
+    namespace shuffle_rle {
+
+      inline constexpr std::size_t min_run = 3;
+      inline constexpr std::size_t max_run = 127 + min_run;
+      inline constexpr std::size_t max_literals = 128;
+
+      /// @return the maximum size of the encoding of @p size bytes
+      inline constexpr std::size_t compress_bound(std::size_t size) {
+        return size + (size + max_literals - 1) / max_literals;
+      }
+
+      /// transposes @p size bytes of @p src into @p dst so that the bytes of equal significance of consecutive
+      /// elements are contiguous
+      inline void shuffle(const unsigned char *src, std::size_t size, std::size_t element_size, unsigned char *dst) {
+        const std::size_t n = size / element_size;
+        for (std::size_t b = 0; b != element_size; ++b) {
+          unsigned char *plane = dst + b * n;
+          for (std::size_t e = 0; e != n; ++e) plane[e] = src[e * element_size + b];
+        }
+        std::memcpy(dst + n * element_size, src + n * element_size, size - n * element_size);
+      }
+
+      /// the inverse of shuffle()
+      inline void unshuffle(const unsigned char *src, std::size_t size, std::size_t element_size, unsigned char *dst) {
+        const std::size_t n = size / element_size;
+        for (std::size_t b = 0; b != element_size; ++b) {
+          const unsigned char *plane = src + b * n;
+          for (std::size_t e = 0; e != n; ++e) dst[e * element_size + b] = plane[e];
+        }
+        std::memcpy(dst + n * element_size, src + n * element_size, size - n * element_size);
+      }
+
+      /// run-length encodes @p size bytes of @p src into @p dst
+      /// @return the size of the encoding, or `std::numeric_limits<std::size_t>::max()` if it exceeds @p capacity
+      inline std::size_t encode(const unsigned char *src, std::size_t size, unsigned char *dst, std::size_t capacity) {
+        constexpr auto overflow = std::numeric_limits<std::size_t>::max();
+        std::size_t out = 0;
+        std::size_t literal_begin = 0;
+        auto flush_literals = [&](std::size_t end) {
+          while (literal_begin != end) {
+            const std::size_t n = std::min(end - literal_begin, max_literals);
+            if (out + 1 + n > capacity) return false;
+            dst[out++] = static_cast<unsigned char>(n - 1);
+            std::memcpy(dst + out, src + literal_begin, n);
+            out += n;
+            literal_begin += n;
+          }
+          return true;
+        };
+        std::size_t i = 0;
+        while (i != size) {
+          std::size_t run = 1;
+          while (i + run != size && run != max_run && src[i + run] == src[i]) ++run;
+          if (run >= min_run) {
+            if (!flush_literals(i) || out + 2 > capacity) return overflow;
+            dst[out++] = static_cast<unsigned char>(128 + run - min_run);
+            dst[out++] = src[i];
+            i += run;
+            literal_begin = i;
+          } else
+            i += run;
+        }
+        if (!flush_literals(size)) return overflow;
+        return out;
+      }
+
+      /// decodes @p size bytes of @p src into exactly @p dst_size bytes of @p dst
+      /// @throw std::out_of_range if @p src is not the encoding of @p dst_size bytes
+      inline void decode(const unsigned char *src, std::size_t size, unsigned char *dst, std::size_t dst_size) {
+        std::size_t in = 0, out = 0;
+        while (in != size) {
+          const std::size_t c = src[in++];
+          if (c < 128) {
+            const std::size_t n = c + 1;
+            if (in + n > size || out + n > dst_size)
+              throw std::out_of_range("ttg::detail::shuffle_rle::decode: malformed input");
+            std::memcpy(dst + out, src + in, n);
+            in += n;
+            out += n;
+          } else {
+            const std::size_t n = c - 128 + min_run;
+            if (in == size || out + n > dst_size)
+              throw std::out_of_range("ttg::detail::shuffle_rle::decode: malformed input");
+            std::memset(dst + out, src[in++], n);
+            out += n;
+          }
+        }
+        if (out != dst_size) throw std::out_of_range("ttg::detail::shuffle_rle::decode: malformed input");
+      }
+
+      /// compresses @p size bytes of @p src into @p dst
+      /// @return the size of the compressed data, or `std::numeric_limits<std::size_t>::max()` if it exceeds
+      ///         @p capacity
+      inline std::size_t compress(const void *src, std::size_t size, std::size_t element_size, void *dst,
+                                  std::size_t capacity) {
+        thread_local std::vector<unsigned char> shuffled;
+        shuffled.resize(size);
+        shuffle(static_cast<const unsigned char *>(src), size, element_size, shuffled.data());
+        return encode(shuffled.data(), size, static_cast<unsigned char *>(dst), capacity);
+      }
+
+      /// decompresses @p size bytes of @p src , produced by compress(), into @p dst_size bytes of @p dst
+      /// @throw std::out_of_range if @p src is malformed
+      inline void decompress(const void *src, std::size_t size, std::size_t element_size, void *dst,
+                             std::size_t dst_size) {
+        thread_local std::vector<unsigned char> shuffled;
+        shuffled.resize(dst_size);
+        decode(static_cast<const unsigned char *>(src), size, shuffled.data(), dst_size);
+        unshuffle(shuffled.data(), dst_size, element_size, static_cast<unsigned char *>(dst));
+      }
+
+    }  // namespace shuffle_rle
+
+  }  // namespace detail
+
+}  // namespace ttg
+
+#endif  // TTG_SERIALIZATION_COMPRESSION_H
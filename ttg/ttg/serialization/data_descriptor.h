@@ -5,26 +5,117 @@
 
 #ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
 #include <madness/world/buffer_archive.h>
+#include <madness/world/madness_exception.h>
 #endif
 
 #include "ttg/serialization/traits.h"
 
+#include "ttg/serialization/compression.h"
 #include "ttg/serialization/stream.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>  // for std::memcpy
+#include <ios>
+#include <limits>
+#include <stdexcept>
+#include <vector>
 
 #include "ttg/serialization/splitmd_data_descriptor.h"
+// SplitMetadataDescriptor specializations for the standard contiguous containers
+#include "ttg/serialization/std/array.h"
+#include "ttg/serialization/std/vector.h"
+
+namespace ttg {
+
+  /// Specialize to std::true_type if all objects of type @p T , including default-constructed ones, have the same
+  /// serialized size; default_data_descriptor<T> then computes the size once, and the backends do not send it along
+  /// with the objects. This is implied for the trivially-copyable types serialized by bitcopy.
+  template <typename T, typename Enabler = void>
+  struct has_fixed_serialized_size : std::false_type {};
+
+  /// Specialize to std::true_type to have the PaRSEC backend transfer objects of type @p T , serialized with Boost,
+  /// in gather mode: the contiguous chunks of at least detail::gather_min_iovec_size bytes (e.g. the elements of a
+  /// large std::vector member) are transferred by RMA from the sender's object directly into the receiver's object,
+  /// only the rest of the serialized representation is sent with the message.
+  /// This is only valid if such chunks are written from the object's own storage, and if deserialization does not
+  /// depend on their contents, since these are only filled in after the object has been deserialized.
+  template <typename T, typename Enabler = void>
+  struct use_gather_serialization : std::false_type {};
+
+}  // namespace ttg
+
+namespace ttg::detail {
+
+  /// @return the serialized size of @p object computed by @p compute , or, if ttg::has_fixed_serialized_size<T>, the
+  ///         size computed by the first call
+  template <typename T, typename Compute>
+  uint64_t payload_size_of(const void *object, Compute &&compute) {
+    if constexpr (ttg::has_fixed_serialized_size<T>::value) {
+      static const uint64_t size = compute(object);
+      return size;
+    } else
+      return compute(object);
+  }
+
+  /// the value returned by ttg_data_descriptor::pack_payload_once if the object does not fit into the buffer
+  inline constexpr uint64_t pack_payload_overflow = std::numeric_limits<uint64_t>::max();
+
+  /// the size of the smallest chunk that gather-mode serialization transfers separately (see
+  /// ttg::use_gather_serialization)
+  inline constexpr std::size_t gather_min_iovec_size = 4096;
+
+  /// evaluates to true if the backends transfer @p T in gather mode (see ttg::use_gather_serialization)
+  template <typename T>
+  inline constexpr bool use_gather_serialization_v =
+      ttg::use_gather_serialization<T>::value && !ttg::has_split_metadata<T>::value && is_boost_buffer_serializable_v<T>;
+
+  /// evaluates to true if @p T is not bit-copyable, or has user-provided serialization methods, and can be serialized
+  /// to/from buffer by MADNESS, Boost, or Cereal
+  template <typename T>
+  inline constexpr bool is_backend_buffer_serializable_v =
+      (!std::is_trivially_copyable_v<T> && (is_madness_buffer_serializable_v<T> || is_boost_buffer_serializable_v<T> ||
+                                            is_cereal_buffer_serializable_v<T>)) ||
+      is_madness_user_buffer_serializable_v<T> || is_boost_user_buffer_serializable_v<T> ||
+      is_cereal_user_buffer_serializable_v<T>;
+
+  /// evaluates to true if default_data_descriptor<T> serializes @p T with the TTG buffer archives (see
+  /// buffer_archive.h); unless TTG_SERIALIZATION_PREFER_TTG_ARCHIVE is defined these are only used for the types
+  /// that MADNESS, Boost, and Cereal cannot serialize
+  template <typename T>
+  inline constexpr bool use_ttg_buffer_archive_v =
+      !ttg::has_split_metadata<T>::value && is_ttg_buffer_serializable_v<T> &&
+      (!std::is_trivially_copyable_v<T> || is_ttg_user_buffer_serializable_v<T>)
+#ifndef TTG_SERIALIZATION_PREFER_TTG_ARCHIVE
+      && !is_backend_buffer_serializable_v<T>
+#endif
+      ;
+
+}  // namespace ttg::detail
 
 // This provides an efficent API for serializing/deserializing a data type.
 // An object of this type will need to be provided for each serializable type.
 // The default implementation, in serialization.h, works only for primitive/POD data types;
-// backend-specific implementations may be available in backend/serialization.h .
+// backend-specific implementations may be available in backend/serialization.h ; other types are serialized
+// with TTG's own buffer archives (see buffer_archive.h).
 extern "C" struct ttg_data_descriptor {
   const char *name;
   uint64_t (*payload_size)(const void *object);
   uint64_t (*pack_payload)(const void *object, uint64_t chunk_size, uint64_t pos, void *buf);
   void (*unpack_payload)(void *object, uint64_t chunk_size, uint64_t pos, const void *buf);
   void (*print)(const void *object);
+  /// serializes object into buf starting at pos in a single pass, i.e. without calling payload_size first
+  /// @return location in buf after the last byte written, or UINT64_MAX if object needs more than max_size bytes
+  uint64_t (*pack_payload_once)(const void *object, uint64_t max_size, uint64_t pos, void *buf);
+  /// serializes the n objects at objects, objects + stride, ... (stride in bytes) into buf starting at pos; unless
+  /// payload_size_is_const is nonzero the representation of each object is preceded by its size as uint64_t
+  /// @return location in buf after the last byte written, or UINT64_MAX if the objects need more than max_size bytes
+  uint64_t (*pack_n)(const void *objects, uint64_t n, uint64_t stride, uint64_t max_size, uint64_t pos, void *buf);
+  /// deserializes n objects packed by pack_n from at most size bytes of buf starting at pos
+  /// @return location in buf after the last byte read
+  uint64_t (*unpack_n)(void *objects, uint64_t n, uint64_t stride, uint64_t size, uint64_t pos, const void *buf);
+  /// nonzero if all objects, including default-constructed ones, have the same serialized size
+  int payload_size_is_const;
 };
 
 namespace ttg {
@@ -65,6 +156,19 @@ namespace ttg {
       return begin + size;
     }
 
+    /// @brief serializes object to a buffer of limited capacity
+
+    /// @param[in] object pointer to the object to be serialized
+    /// @param[in] max_size the number of bytes available in @p buf past @p begin
+    /// @param[in] begin location in @p buf where the first byte of serialized data will be written
+    /// @param[in,out] buf the data buffer that will contain serialized data
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t begin, void *buf) {
+      if (sizeof(T) > max_size) return detail::pack_payload_overflow;
+      return pack_payload(object, sizeof(T), begin, buf);
+    }
+
     /// @brief deserializes object from a buffer
 
     /// @param[in,out] object pointer to the object to be deserialized
@@ -77,8 +181,9 @@ namespace ttg {
     }
   };
 
-  /// default_data_descriptor for trivially-copyable types
-  /// @tparam T a trivially-copyable type
+  /// default_data_descriptor for types that provide SplitMetadataDescriptor: the metadata is followed by the payload
+  /// described by the iovecs
+  /// @tparam T a type for which ttg::has_split_metadata<T> is true
   template <typename T>
   struct default_data_descriptor<T, std::enable_if_t<ttg::has_split_metadata<T>::value>> {
     static constexpr const bool serialize_size_is_const = false;
@@ -87,10 +192,10 @@ namespace ttg {
     /// @return size of serialized @p object
     static uint64_t payload_size(const void *object) {
       SplitMetadataDescriptor<T> smd;
-      const T *t = reinterpret_cast<T *>(object);
-      auto metadata = smd.get_metadata(t);
+      T *t = const_cast<T *>(reinterpret_cast<const T *>(object));
+      auto metadata = smd.get_metadata(*t);
       size_t size = sizeof(metadata);
-      for (auto &&iovec : smd.get_data(t)) {
+      for (auto &&iovec : smd.get_data(*t)) {
         size += iovec.num_bytes;
       }
 
@@ -106,20 +211,35 @@ namespace ttg {
     /// @return location in @p buf after the last byte written
     static uint64_t pack_payload(const void *object, uint64_t size, uint64_t begin, void *buf) {
       SplitMetadataDescriptor<T> smd;
-      const T *t = reinterpret_cast<T *>(object);
+      T *t = const_cast<T *>(reinterpret_cast<const T *>(object));
 
       unsigned char *char_buf = reinterpret_cast<unsigned char *>(buf);
-      auto metadata = smd.get_metadata(t);
-      std::memcpy(&char_buf[begin], metadata, sizeof(metadata));
+      auto metadata = smd.get_metadata(*t);
+      std::memcpy(&char_buf[begin], &metadata, sizeof(metadata));
       size_t pos = sizeof(metadata);
-      for (auto &&iovec : smd.get_data(t)) {
+      for (auto &&iovec : smd.get_data(*t)) {
         std::memcpy(&char_buf[begin + pos], iovec.data, iovec.num_bytes);
         pos += iovec.num_bytes;
-        assert(pos < size);
+        assert(pos <= size);
       }
       return begin + size;
     }
 
+    /// @brief serializes object to a buffer of limited capacity
+
+    /// @param[in] object pointer to the object to be serialized
+    /// @param[in] max_size the number of bytes available in @p buf past @p begin
+    /// @param[in] begin location in @p buf where the first byte of serialized data will be written
+    /// @param[in,out] buf the data buffer that will contain serialized data
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t begin, void *buf) {
+      // computing the size only requires the metadata and the sizes of the iovecs
+      const auto size = payload_size(object);
+      if (size > max_size) return detail::pack_payload_overflow;
+      return pack_payload(object, size, begin, buf);
+    }
+
     /// @brief deserializes object from a buffer
 
     /// @param[in,out] object pointer to the object to be deserialized
@@ -130,20 +250,70 @@ namespace ttg {
       SplitMetadataDescriptor<T> smd;
       T *t = reinterpret_cast<T *>(object);
 
-      using metadata_t = decltype(smd.get_metadata(t));
+      using metadata_t = decltype(smd.get_metadata(*t));
       const unsigned char *char_buf = reinterpret_cast<const unsigned char *>(buf);
-      const metadata_t *metadata = reinterpret_cast<const metadata_t *>(char_buf + begin);
-      T t_created = smd.create_from_metadata();
+      // the metadata is not necessarily aligned in buf
+      metadata_t metadata;
+      std::memcpy(&metadata, char_buf + begin, sizeof(metadata));
+      *t = smd.create_from_metadata(metadata);
       size_t pos = sizeof(metadata);
-      *t = t_created;
-      for (auto &&iovec : smd.get_data(t)) {
+      for (auto &&iovec : smd.get_data(*t)) {
         std::memcpy(iovec.data, &char_buf[begin + pos], iovec.num_bytes);
         pos += iovec.num_bytes;
-        assert(pos < size);
+        assert(pos <= size);
       }
     }
   };
 
+  /// The default implementation for data types that are not directly copyable, or have user-provided serialization
+  /// methods, and are serialized with the TTG buffer archives (see detail::use_ttg_buffer_archive_v)
+  template <typename T>
+  struct default_data_descriptor<T, std::enable_if_t<detail::use_ttg_buffer_archive_v<T>>> {
+    static constexpr const bool serialize_size_is_const = has_fixed_serialized_size<T>::value;
+
+    static uint64_t payload_size(const void *object) {
+      return detail::payload_size_of<T>(object, [](const void *object) {
+        detail::buffer_counting_oarchive oa;
+        oa << (*(const T *)object);
+        return static_cast<uint64_t>(oa.size());
+      });
+    }
+
+    /// object --- obj to be serialized
+    /// chunk_size --- inputs max amount of data to output
+    /// pos --- position in the input buffer to resume serialization
+    /// buf[pos] --- place for output
+    /// @return location in @p buf after the last byte written
+    static uint64_t pack_payload(const void *object, uint64_t chunk_size, uint64_t pos, void *buf) {
+      detail::buffer_oarchive oa(buf, pos + chunk_size, pos);
+      oa << (*(const T *)object);
+      return static_cast<uint64_t>(oa.position());
+    }
+
+    /// object --- obj to be serialized
+    /// max_size --- the number of bytes available in buf past pos
+    /// pos --- position in the input buffer to resume serialization
+    /// buf[pos] --- place for output
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t pos, void *buf) {
+      try {
+        return pack_payload(object, max_size, pos, buf);
+      } catch (const std::out_of_range &) {
+        return detail::pack_payload_overflow;
+      }
+    }
+
+    /// object --- obj to be deserialized
+    /// chunk_size --- amount of data for input
+    /// pos --- position in the input buffer to resume deserialization
+    /// object -- pointer to the object to fill up
+    static void unpack_payload(void *object, uint64_t chunk_size, uint64_t pos, const void *buf) {
+      detail::buffer_iarchive ia(buf, pos + chunk_size, pos);
+      ia >> (*(T *)object);
+    }
+  };
+
 }  // namespace ttg
 
 #if defined(TTG_SERIALIZATION_SUPPORTS_MADNESS)
@@ -155,13 +325,16 @@ namespace ttg {
   template <typename T>
   struct default_data_descriptor<
       T, std::enable_if_t<((!std::is_trivially_copyable_v<T> && detail::is_madness_buffer_serializable_v<T>) ||
-                           detail::is_madness_user_buffer_serializable_v<T>)&&!ttg::has_split_metadata<T>::value>> {
-    static constexpr const bool serialize_size_is_const = false;
+                           detail::is_madness_user_buffer_serializable_v<T>)&&!ttg::has_split_metadata<T>::value &&
+                          !detail::use_ttg_buffer_archive_v<T>>> {
+    static constexpr const bool serialize_size_is_const = has_fixed_serialized_size<T>::value;
 
     static uint64_t payload_size(const void *object) {
-      madness::archive::BufferOutputArchive ar;
-      ar &(*(T *)object);
-      return static_cast<uint64_t>(ar.size());
+      return detail::payload_size_of<T>(object, [](const void *object) {
+        madness::archive::BufferOutputArchive ar;
+        ar &(*(T *)object);
+        return static_cast<uint64_t>(ar.size());
+      });
     }
 
     /// object --- obj to be serialized
@@ -175,6 +348,23 @@ namespace ttg {
       return pos + chunk_size;
     }
 
+    /// object --- obj to be serialized
+    /// max_size --- the number of bytes available in buf past pos
+    /// pos --- position in the input buffer to resume serialization
+    /// buf[pos] --- place for output
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t pos, void *_buf) {
+      unsigned char *buf = reinterpret_cast<unsigned char *>(_buf);
+      try {
+        madness::archive::BufferOutputArchive ar(&buf[pos], max_size);
+        ar &(*(T *)object);
+        return pos + static_cast<uint64_t>(ar.size());
+      } catch (const madness::MadnessException &) {  // thrown by BufferOutputArchive on overflow
+        return detail::pack_payload_overflow;
+      }
+    }
+
     /// object --- obj to be deserialized
     /// chunk_size --- amount of data for input
     /// pos --- position in the input buffer to resume deserialization
@@ -200,16 +390,19 @@ namespace ttg {
   /// do not support MADNESS serialization, and support Boost serialization
   template <typename T>
   struct default_data_descriptor<
-      T, std::enable_if_t<(!std::is_trivially_copyable_v<T> && !detail::is_madness_buffer_serializable_v<T> &&
-                           detail::is_boost_buffer_serializable_v<T>) ||
-                          (!detail::is_madness_user_buffer_serializable_v<T> &&
-                           detail::is_boost_user_buffer_serializable_v<T>)>> {
-    static constexpr const bool serialize_size_is_const = false;
+      T, std::enable_if_t<((!std::is_trivially_copyable_v<T> && !detail::is_madness_buffer_serializable_v<T> &&
+                            detail::is_boost_buffer_serializable_v<T>) ||
+                           (!detail::is_madness_user_buffer_serializable_v<T> &&
+                            detail::is_boost_user_buffer_serializable_v<T>)) &&
+                          !ttg::has_split_metadata<T>::value && !detail::use_ttg_buffer_archive_v<T>>> {
+    static constexpr const bool serialize_size_is_const = has_fixed_serialized_size<T>::value;
 
     static uint64_t payload_size(const void *object) {
-      ttg::detail::boost_counting_oarchive oa;
-      oa << (*(T *)object);
-      return oa.streambuf().size();
+      return detail::payload_size_of<T>(object, [](const void *object) {
+        ttg::detail::boost_counting_oarchive oa;
+        oa << (*(T *)object);
+        return static_cast<uint64_t>(oa.streambuf().size());
+      });
     }
 
     /// object --- obj to be serialized
@@ -222,6 +415,24 @@ namespace ttg {
       return pos + chunk_size;
     }
 
+    /// object --- obj to be serialized
+    /// max_size --- the number of bytes available in buf past pos
+    /// pos --- position in the input buffer to resume serialization
+    /// buf[pos] --- place for output
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t pos, void *_buf) {
+      try {
+        auto oa = ttg::detail::make_boost_buffer_oarchive(_buf, pos + max_size, pos);
+        oa << (*(T *)object);
+        return pos + static_cast<uint64_t>(oa.stream().tellp());
+      } catch (const boost::archive::archive_exception &) {
+        return detail::pack_payload_overflow;
+      } catch (const std::ios_base::failure &) {  // thrown by the array sink on overflow
+        return detail::pack_payload_overflow;
+      }
+    }
+
     /// object --- obj to be deserialized
     /// chunk_size --- amount of data for input
     /// pos --- position in the input buffer to resume deserialization
@@ -232,44 +443,108 @@ namespace ttg {
     }
   };
 
+  namespace detail {
+
+    /// serializes @p object in gather mode (see ttg::use_gather_serialization)
+
+    /// @param[in] object the object to be serialized
+    /// @param[in] capacity the size of @p header , in bytes
+    /// @param[out] header the buffer that will contain the serialized data other than the chunks referred by @p iovecs
+    /// @param[out] iovecs the chunks of @p object to be transferred separately, in order
+    /// @return the number of bytes written to @p header , or detail::pack_payload_overflow if they do not fit
+    template <typename T>
+    uint64_t gather_payload(const T &object, uint64_t capacity, void *header, std::vector<ttg::iovec> &iovecs) {
+      try {
+        boost_gather_oarchive oa(gather_ostreambuf(header, capacity, gather_min_iovec_size));
+        oa << object;
+        iovecs = oa.stream().iovecs();
+        return oa.stream().header_size();
+      } catch (const boost::archive::archive_exception &) {
+        return pack_payload_overflow;
+      }
+    }
+
+    /// deserializes @p object from the header produced by gather_payload
+
+    /// @param[in,out] object the object to be deserialized
+    /// @param[in] size the size of @p header , in bytes
+    /// @param[in] header the header produced by gather_payload
+    /// @return the destinations in @p object of the chunks that were transferred separately, in order; these need to
+    ///         be filled before @p object can be used
+    template <typename T>
+    std::vector<ttg::iovec> scatter_payload(T &object, uint64_t size, const void *header) {
+      boost_scatter_iarchive ia(scatter_istreambuf(header, size, gather_min_iovec_size));
+      ia >> object;
+      assert(ia.stream().header_size() == size);
+      return ia.stream().iovecs();
+    }
+
+  }  // namespace detail
+
 }  // namespace ttg
 
 #endif  // has Boost serialization
 
 #if defined(TTG_SERIALIZATION_SUPPORTS_CEREAL)
 
+#include "ttg/serialization/backends/cereal/archive.h"
+
 namespace ttg {
 
   /// The default implementation for non-POD data types that are not directly copyable
   /// do not support MADNESS or Boost serialization, and support Cereal serialization
   template <typename T>
   struct default_data_descriptor<
-      T, std::enable_if_t<(!std::is_trivially_copyable_v<T> && !detail::is_madness_buffer_serializable_v<T> &&
-                           !detail::is_boost_buffer_serializable_v<T> && detail::is_cereal_buffer_serializable_v<T>) ||
-                          (!detail::is_madness_user_buffer_serializable_v<T> &&
-                           !detail::is_boost_user_buffer_serializable_v<T> &&
-                           detail::is_cereal_user_buffer_serializable_v<T>)>> {
-    static constexpr const bool serialize_size_is_const = false;
+      T, std::enable_if_t<((!std::is_trivially_copyable_v<T> && !detail::is_madness_buffer_serializable_v<T> &&
+                            !detail::is_boost_buffer_serializable_v<T> && detail::is_cereal_buffer_serializable_v<T>) ||
+                           (!detail::is_madness_user_buffer_serializable_v<T> &&
+                            !detail::is_boost_user_buffer_serializable_v<T> &&
+                            detail::is_cereal_user_buffer_serializable_v<T>)) &&
+                          !ttg::has_split_metadata<T>::value && !detail::use_ttg_buffer_archive_v<T>>> {
+    static constexpr const bool serialize_size_is_const = has_fixed_serialized_size<T>::value;
 
     static uint64_t payload_size(const void *object) {
-      ttg::detail::counting_streambuf sbuf;
-      std::ostream os(&sbuf);
-      cereal::BinaryOutputArchive oa(os);
-      oa << (*(T *)object);
-      return sbuf.size();
+      return detail::payload_size_of<T>(object, [](const void *object) {
+        ttg::detail::cereal_buffer_oarchive oa;  // only counts
+        oa << (*(T *)object);
+        return static_cast<uint64_t>(oa.pos());
+      });
     }
 
     /// object --- obj to be serialized
     /// chunk_size --- inputs max amount of data to output, and on output returns amount actually output
     /// pos --- position in the input buffer to resume serialization
     /// buf[pos] --- place for output
-    static uint64_t pack_payload(const void *object, uint64_t chunk_size, uint64_t pos, void *_buf) { abort(); }
+    static uint64_t pack_payload(const void *object, uint64_t chunk_size, uint64_t pos, void *_buf) {
+      ttg::detail::cereal_buffer_oarchive oa(_buf, pos + chunk_size, pos);
+      oa << (*(T *)object);
+      return pos + chunk_size;
+    }
+
+    /// object --- obj to be serialized
+    /// max_size --- the number of bytes available in buf past pos
+    /// pos --- position in the input buffer to resume serialization
+    /// buf[pos] --- place for output
+    /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if @p object does
+    ///         not fit
+    static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t pos, void *_buf) {
+      try {
+        ttg::detail::cereal_buffer_oarchive oa(_buf, pos + max_size, pos);
+        oa << (*(T *)object);
+        return static_cast<uint64_t>(oa.pos());
+      } catch (const cereal::Exception &) {
+        return detail::pack_payload_overflow;
+      }
+    }
 
     /// object --- obj to be deserialized
     /// chunk_size --- amount of data for input
     /// pos --- position in the input buffer to resume deserialization
     /// object -- pointer to the object to fill up
-    static void unpack_payload(void *object, uint64_t chunk_size, uint64_t pos, const void *_buf) { abort(); }
+    static void unpack_payload(void *object, uint64_t chunk_size, uint64_t pos, const void *_buf) {
+      ttg::detail::cereal_buffer_iarchive ia(_buf, pos + chunk_size, pos);
+      ia >> (*(T *)object);
+    }
   };
 
 }  // namespace ttg
@@ -278,16 +553,262 @@ namespace ttg {
 
 namespace ttg {
 
+  namespace detail {
+
+    /// Compresses the payload produced by default_data_descriptor<T> (see ttg::payload_compression)
+
+    /// The compressed payload starts with a byte that identifies the codec; `stored` payloads follow as is,
+    /// `shuffle_rle` payloads are preceded by their uncompressed size. Payloads shorter than the threshold, or
+    /// that do not become shorter by compression, are stored.
+    template <typename T>
+    struct compressed_data_descriptor {
+      using base_type = default_data_descriptor<T>;
+      using compression = ttg::payload_compression<T>;
+      static_assert(compression::enabled);
+
+      enum codec : unsigned char { stored = 0, shuffle_rle = 1 };
+      static constexpr const uint64_t shuffle_rle_header_size = 1 + sizeof(uint64_t);
+
+      static constexpr const bool serialize_size_is_const = false;
+
+      /// compresses @p object into a thread-local buffer, which the subsequent pack_payload() of @p object by the
+      /// same thread copies instead of compressing again; @p object must not be modified in between
+      static uint64_t payload_size(const void *object) {
+        auto &c = cache();
+        const auto &raw = serialize(object);
+        c.packed.resize(1 + raw.size());
+        c.packed.resize(pack(raw, c.packed.size(), 0, c.packed.data()));
+        c.object = object;
+        c.raw_size = raw.size();
+        return c.packed.size();
+      }
+
+      static uint64_t pack_payload(const void *object, uint64_t size, uint64_t pos, void *buf) {
+        auto &c = cache();
+        if (c.object == object && c.packed.size() == size) {
+          c.object = nullptr;
+          std::memcpy(static_cast<unsigned char *>(buf) + pos, c.packed.data(), size);
+          record(c.raw_size, size);
+          return pos + size;
+        }
+        const auto &raw = serialize(object);
+        [[maybe_unused]] const auto end = pack(raw, size, pos, buf);
+        assert(end == pos + size);
+        record(raw.size(), size);
+        return pos + size;
+      }
+
+      static uint64_t pack_payload_once(const void *object, uint64_t max_size, uint64_t pos, void *buf) {
+        const auto &raw = serialize(object);
+        const auto end = pack(raw, max_size, pos, buf);
+        if (end != pack_payload_overflow) record(raw.size(), end - pos);
+        return end;
+      }
+
+      static void unpack_payload(void *object, uint64_t size, uint64_t pos, const void *buf) {
+        const unsigned char *src = static_cast<const unsigned char *>(buf) + pos;
+        if (size == 0) throw std::out_of_range("ttg::detail::compressed_data_descriptor: empty payload");
+        switch (src[0]) {
+          case stored:
+            base_type::unpack_payload(object, size - 1, pos + 1, buf);
+            return;
+          case shuffle_rle: {
+            if (size < shuffle_rle_header_size)
+              throw std::out_of_range("ttg::detail::compressed_data_descriptor: truncated payload");
+            uint64_t raw_size;
+            std::memcpy(&raw_size, src + 1, sizeof(raw_size));
+            thread_local std::vector<unsigned char> raw;
+            raw.resize(raw_size);
+            detail::shuffle_rle::decompress(src + shuffle_rle_header_size, size - shuffle_rle_header_size,
+                                            compression::element_size, raw.data(), raw_size);
+            base_type::unpack_payload(object, raw_size, 0, raw.data());
+            return;
+          }
+          default:
+            throw std::out_of_range("ttg::detail::compressed_data_descriptor: unknown codec");
+        }
+      }
+
+     private:
+      /// the payload compressed by the last payload_size() of this thread
+      struct packed_payload {
+        const void *object = nullptr;  // null once copied by pack_payload()
+        uint64_t raw_size = 0;
+        std::vector<unsigned char> packed;
+      };
+
+      static packed_payload &cache() {
+        thread_local packed_payload c;
+        return c;
+      }
+
+      /// records the compression of a payload of @p raw_size bytes into @p size bytes, unless it is below the threshold
+      static void record(uint64_t raw_size, uint64_t size) {
+        if (raw_size >= compression::threshold) payload_compression_statistics().record(raw_size, size);
+      }
+
+      /// @return the uncompressed payload of @p object
+      static const std::vector<unsigned char> &serialize(const void *object) {
+        thread_local std::vector<unsigned char> raw;
+        raw.resize(std::max<std::size_t>(raw.capacity(), 64));
+        while (true) {
+          const auto end = base_type::pack_payload_once(object, raw.size(), 0, raw.data());
+          if (end != pack_payload_overflow) {
+            raw.resize(end);
+            return raw;
+          }
+          raw.resize(2 * raw.size());
+        }
+      }
+
+      /// writes the compressed form of @p raw to @p buf
+      /// @return location in @p buf after the last byte written, or detail::pack_payload_overflow if it does not fit
+      ///         into @p max_size bytes
+      static uint64_t pack(const std::vector<unsigned char> &raw, uint64_t max_size, uint64_t pos, void *buf) {
+        unsigned char *dst = static_cast<unsigned char *>(buf) + pos;
+        const uint64_t raw_size = raw.size();
+        if (raw_size >= compression::threshold && raw_size > shuffle_rle_header_size &&
+            max_size > shuffle_rle_header_size) {
+          // only compress if that saves space
+          const auto capacity = std::min(max_size, raw_size) - shuffle_rle_header_size;
+          const auto size = detail::shuffle_rle::compress(raw.data(), raw_size, compression::element_size,
+                                                          dst + shuffle_rle_header_size, capacity);
+          if (size != std::numeric_limits<std::size_t>::max()) {
+            dst[0] = shuffle_rle;
+            std::memcpy(dst + 1, &raw_size, sizeof(raw_size));
+            return pos + shuffle_rle_header_size + size;
+          }
+        }
+        if (1 + raw_size > max_size) return pack_payload_overflow;
+        dst[0] = stored;
+        std::memcpy(dst + 1, raw.data(), raw_size);
+        return pos + 1 + raw_size;
+      }
+    };
+
+    /// the data descriptor used for @p T : default_data_descriptor<T>, or compressed_data_descriptor<T> if
+    /// ttg::payload_compression<T> is enabled
+    template <typename T>
+    using data_descriptor_t = std::conditional_t<ttg::payload_compression<T>::enabled, compressed_data_descriptor<T>,
+                                                 default_data_descriptor<T>>;
+
+    /// evaluates to true if all objects of type @p T , including default-constructed ones, have the same serialized
+    /// size, so that the size need not be sent along with the objects
+    template <typename T>
+    inline constexpr bool payload_size_is_const_v = data_descriptor_t<T>::serialize_size_is_const;
+
+    /// evaluates to true if data_descriptor_t<T> serializes @p T by copying its bytes
+    template <typename T>
+    inline constexpr bool is_bitcopy_serialized_v =
+        is_bitcopyable_v<T> && !ttg::has_split_metadata<T>::value && !ttg::payload_compression<T>::enabled;
+
+    /// serializes @p n objects of type @p T , @p stride bytes apart, with data_descriptor_t<T> (see
+    /// ttg_data_descriptor::pack_n); densely stored bit-copyable objects are copied with a single `memcpy`
+    template <typename T>
+    uint64_t pack_n(const void *objects, uint64_t n, uint64_t stride, uint64_t max_size, uint64_t pos, void *buf) {
+      using descriptor_t = data_descriptor_t<T>;
+      unsigned char *char_buf = static_cast<unsigned char *>(buf);
+      if constexpr (is_bitcopy_serialized_v<T>) {
+        if (stride == sizeof(T)) {
+          if (n * sizeof(T) > max_size) return pack_payload_overflow;
+          std::memcpy(char_buf + pos, objects, n * sizeof(T));
+          return pos + n * sizeof(T);
+        }
+      }
+      const uint64_t end = pos + max_size;
+      for (uint64_t k = 0; k != n; ++k) {
+        const void *object = static_cast<const unsigned char *>(objects) + k * stride;
+        if constexpr (descriptor_t::serialize_size_is_const) {
+          const uint64_t size = descriptor_t::payload_size(object);
+          if (size > end - pos) return pack_payload_overflow;
+          pos = descriptor_t::pack_payload(object, size, pos, buf);
+        } else {
+          // serialize in a single pass, then back-patch the size
+          const uint64_t payload_pos = pos + sizeof(uint64_t);
+          if (payload_pos > end) return pack_payload_overflow;
+          const uint64_t payload_end = descriptor_t::pack_payload_once(object, end - payload_pos, payload_pos, buf);
+          if (payload_end == pack_payload_overflow) return pack_payload_overflow;
+          const uint64_t payload_size = payload_end - payload_pos;
+          std::memcpy(char_buf + pos, &payload_size, sizeof(uint64_t));
+          pos = payload_end;
+        }
+      }
+      return pos;
+    }
+
+    /// deserializes @p n objects of type @p T , @p stride bytes apart, packed by pack_n<T>
+    /// @throw std::out_of_range if @p buf holds fewer than @p size bytes of serialized objects
+    template <typename T>
+    uint64_t unpack_n(void *objects, uint64_t n, uint64_t stride, uint64_t size, uint64_t pos, const void *buf) {
+      using descriptor_t = data_descriptor_t<T>;
+      const unsigned char *char_buf = static_cast<const unsigned char *>(buf);
+      if constexpr (is_bitcopy_serialized_v<T>) {
+        if (stride == sizeof(T)) {
+          if (n * sizeof(T) > size) throw std::out_of_range("ttg::detail::unpack_n: buffer underflow");
+          std::memcpy(objects, char_buf + pos, n * sizeof(T));
+          return pos + n * sizeof(T);
+        }
+      }
+      const uint64_t end = pos + size;
+      for (uint64_t k = 0; k != n; ++k) {
+        void *object = static_cast<unsigned char *>(objects) + k * stride;
+        uint64_t payload_size;
+        if constexpr (descriptor_t::serialize_size_is_const) {
+          payload_size = descriptor_t::payload_size(object);
+        } else {
+          if (sizeof(uint64_t) > end - pos) throw std::out_of_range("ttg::detail::unpack_n: buffer underflow");
+          std::memcpy(&payload_size, char_buf + pos, sizeof(uint64_t));
+          pos += sizeof(uint64_t);
+        }
+        if (payload_size > end - pos) throw std::out_of_range("ttg::detail::unpack_n: buffer underflow");
+        descriptor_t::unpack_payload(object, payload_size, pos, buf);
+        pos += payload_size;
+      }
+      return pos;
+    }
+
+  }  // namespace detail
+
   // Returns a pointer to a constant static instance initialized
   // once at run time.
   template <typename T>
   const ttg_data_descriptor *get_data_descriptor() {
-    static const ttg_data_descriptor d = {
-        typeid(T).name(), &default_data_descriptor<T>::payload_size, &default_data_descriptor<T>::pack_payload,
-        &default_data_descriptor<T>::unpack_payload, &detail::printer_helper<T>::print};
+    using descriptor_t = detail::data_descriptor_t<T>;
+    static const ttg_data_descriptor d = {typeid(T).name(),
+                                          &descriptor_t::payload_size,
+                                          &descriptor_t::pack_payload,
+                                          &descriptor_t::unpack_payload,
+                                          &detail::printer_helper<T>::print,
+                                          &descriptor_t::pack_payload_once,
+                                          &detail::pack_n<T>,
+                                          &detail::unpack_n<T>,
+                                          descriptor_t::serialize_size_is_const};
     return &d;
   }
 
+  namespace detail {
+
+    /// appends the serialized representation of @p object to @p buf , growing it as needed
+
+    /// Unlike payload_size() followed by pack_payload() this traverses @p object once, unless the spare capacity of
+    /// @p buf is too small, in which case its capacity is doubled and serialization is repeated.
+    /// @return the size of the serialized representation of @p object
+    template <typename T>
+    uint64_t pack_payload_growable(const T &object, std::vector<unsigned char> &buf) {
+      const auto pos = buf.size();
+      buf.resize(std::max<std::size_t>(buf.capacity(), pos + 64));
+      while (true) {
+        const auto end = data_descriptor_t<T>::pack_payload_once(&object, buf.size() - pos, pos, buf.data());
+        if (end != pack_payload_overflow) {
+          buf.resize(end);
+          return end - pos;
+        }
+        buf.resize(2 * buf.size());
+      }
+    }
+
+  }  // namespace detail
+
 }  // namespace ttg
 
 #endif  // TTG_SERIALIZATION_DATA_DESCRIPTOR_H
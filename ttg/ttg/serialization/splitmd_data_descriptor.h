@@ -1,6 +1,8 @@
 #ifndef TTG_SERIALIZATION_SPLITMD_DATA_DESCRIPTOR_H
 #define TTG_SERIALIZATION_SPLITMD_DATA_DESCRIPTOR_H
 
+#include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include "ttg/util/meta.h"
 
@@ -40,8 +42,11 @@ namespace ttg {
    * which returns a collection of \sa ttg::iovec instances
    * describing the payload data to be transferred from the source to the
    * target object.
+   *
+   * Descriptors for std::vector and std::array of trivially-copyable elements are provided
+   * by ttg/serialization/std/vector.h and ttg/serialization/std/array.h .
    */
-  template <typename T>
+  template <typename T, typename Enabler = void>
   struct SplitMetadataDescriptor;
 
   /* Trait signalling whether metadata and data payload can be transfered separately */
@@ -53,6 +58,78 @@ namespace ttg {
       T, ttg::meta::void_t<decltype(std::declval<SplitMetadataDescriptor<T>>().get_metadata(std::declval<T>()))>>
       : std::true_type {};
 
+  namespace detail {
+
+    /// a sequence of at most one ttg::iovec
+    class iovec_list_1 {
+     public:
+      iovec_list_1() = default;
+      explicit iovec_list_1(iovec iov) : iov_(iov), size_(1) {}
+
+      const iovec* begin() const { return &iov_; }
+      const iovec* end() const { return &iov_ + size_; }
+
+     private:
+      iovec iov_ = {0, nullptr};
+      std::size_t size_ = 0;
+    };
+
+    /// Implements SplitMetadataDescriptor for a contiguous container of trivially-copyable elements.
+
+    /// The metadata is the number of elements and the payload is the element buffer, described by a single iovec.
+    /// If the elements occupy at most @p InlineSize bytes they are instead copied into the metadata, so that small
+    /// containers travel with the message rather than by a separate RMA transfer.
+    /// @tparam Container std::vector or std::array
+    /// @tparam InlineSize the capacity of the metadata for the elements, in bytes
+    template <typename Container, std::size_t InlineSize>
+    class contiguous_splitmd_descriptor {
+      using value_type = typename Container::value_type;
+
+      struct size_metadata {
+        std::size_t size;
+      };
+      struct inline_metadata {
+        std::size_t size;
+        unsigned char data[InlineSize];
+      };
+
+      static bool is_inline(std::size_t size) { return InlineSize != 0 && size * sizeof(value_type) <= InlineSize; }
+
+     public:
+      using metadata_t = std::conditional_t<InlineSize == 0, size_metadata, inline_metadata>;
+
+      metadata_t get_metadata(const Container& c) {
+        metadata_t metadata{};
+        metadata.size = c.size();
+        if constexpr (InlineSize != 0) {
+          if (metadata.size != 0 && is_inline(metadata.size))
+            std::memcpy(metadata.data, c.data(), metadata.size * sizeof(value_type));
+        }
+        return metadata;
+      }
+
+      Container create_from_metadata(const metadata_t& metadata) {
+        Container c = [&metadata]() {
+          if constexpr (std::is_constructible_v<Container, std::size_t>)
+            return Container(metadata.size);
+          else
+            return Container{};
+        }();
+        if constexpr (InlineSize != 0) {
+          if (metadata.size != 0 && is_inline(metadata.size))
+            std::memcpy(c.data(), metadata.data, metadata.size * sizeof(value_type));
+        }
+        return c;
+      }
+
+      iovec_list_1 get_data(Container& c) {
+        if (c.size() == 0 || is_inline(c.size())) return {};
+        return iovec_list_1(iovec{c.size() * sizeof(value_type), c.data()});
+      }
+    };
+
+  }  // namespace detail
+
 }  // namespace ttg
 
 #endif  // TTG_SERIALIZATION_SPLITMD_DATA_DESCRIPTOR_H
@@ -5,8 +5,21 @@
 #ifndef TTG_SERIALIZATION_STD_ARRAY_H
 #define TTG_SERIALIZATION_STD_ARRAY_H
 
+#include "ttg/serialization/splitmd_data_descriptor.h"
 #include "ttg/serialization/traits.h"
 
+#include <array>
+
+namespace ttg {
+
+  /// std::array of bit-copyable elements that does not fit into a message comfortably is transferred by its element
+  /// buffer (see detail::contiguous_splitmd_descriptor); smaller arrays are copied into the message as before
+  template <typename T, std::size_t N>
+  struct SplitMetadataDescriptor<std::array<T, N>, std::enable_if_t<detail::is_bitcopyable_v<T> && (N * sizeof(T) > 64)>>
+      : detail::contiguous_splitmd_descriptor<std::array<T, N>, 0> {};
+
+}  // namespace ttg
+
 #ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
 // MADNESS supports std::array serialization by default
 #endif
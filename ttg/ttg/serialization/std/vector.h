@@ -5,9 +5,23 @@
 #ifndef TTG_SERIALIZATION_STD_VECTOR_H
 #define TTG_SERIALIZATION_STD_VECTOR_H
 
+#include "ttg/serialization/splitmd_data_descriptor.h"
 #include "ttg/serialization/std/allocator.h"
 #include "ttg/serialization/traits.h"
 
+#include <vector>
+
+namespace ttg {
+
+  /// std::vector of bit-copyable elements is transferred as its size plus the element buffer, small vectors are
+  /// transferred with the metadata (see detail::contiguous_splitmd_descriptor)
+  template <typename T, typename A>
+  struct SplitMetadataDescriptor<std::vector<T, A>,
+                                 std::enable_if_t<detail::is_bitcopyable_v<T> && !std::is_same_v<T, bool>>>
+      : detail::contiguous_splitmd_descriptor<std::vector<T, A>, 64> {};
+
+}  // namespace ttg
+
 #ifdef TTG_SERIALIZATION_SUPPORTS_MADNESS
 // MADNESS supports std::vector serialization by default
 #endif
@@ -5,7 +5,12 @@
 #ifndef TTG_SERIALIZATION_STREAM_H
 #define TTG_SERIALIZATION_STREAM_H
 
+#include <algorithm>
+#include <cstring>
 #include <streambuf>
+#include <vector>
+
+#include "ttg/serialization/splitmd_data_descriptor.h"
 
 namespace ttg::detail {
 
@@ -66,6 +71,81 @@ namespace ttg::detail {
     const std::vector<std::pair<const void*, std::size_t>>& iovec_;
   };
 
+  /// streambuf for gather-mode serialization: writes shorter than a threshold are copied into a header buffer,
+  /// longer writes are recorded as iovecs that refer to the written data in place
+
+  /// The iovecs are only valid while the serialized object is alive and unmodified, hence this can only be used for
+  /// objects whose long writes come from their own storage (e.g. the contiguous arrays of std::vector).
+  /// Writes that do not fit into the header buffer fail, i.e. `sputn` returns fewer characters than requested.
+  class gather_ostreambuf : public std::streambuf {
+   public:
+    /// @param[in] header the buffer for the short writes
+    /// @param[in] capacity the size of @p header , in bytes
+    /// @param[in] threshold writes of at least this many bytes are recorded as iovecs
+    gather_ostreambuf(void* header, std::size_t capacity, std::size_t threshold) : threshold_(threshold) {
+      char* begin = static_cast<char*>(header);
+      this->setp(begin, begin + capacity);
+    }
+
+    /// @return the number of bytes written to the header buffer
+    std::size_t header_size() const { return this->pptr() - this->pbase(); }
+    /// @return the iovecs referring to the long writes, in the order of writing
+    const std::vector<ttg::iovec>& iovecs() const { return iovecs_; }
+
+   protected:
+    std::streamsize xsputn(const char_type* s, std::streamsize n) override {
+      if (static_cast<std::size_t>(n) >= threshold_) {
+        iovecs_.push_back(ttg::iovec{static_cast<std::size_t>(n), const_cast<char_type*>(s)});
+        return n;
+      }
+      if (n > this->epptr() - this->pptr()) return 0;
+      std::memcpy(this->pptr(), s, n);
+      this->pbump(static_cast<int>(n));
+      return n;
+    }
+
+   private:
+    std::size_t threshold_;
+    std::vector<ttg::iovec> iovecs_ = {};
+  };
+
+  /// streambuf for gather-mode deserialization, the counterpart of gather_ostreambuf: reads shorter than a threshold
+  /// are served from the header buffer, longer reads are recorded as iovecs referring to their destination, to be
+  /// filled later (e.g. by RMA)
+
+  /// Reads past the end of the header fail, i.e. `sgetn` returns fewer characters than requested.
+  class scatter_istreambuf : public std::streambuf {
+   public:
+    /// @param[in] header the header produced by gather_ostreambuf
+    /// @param[in] size the size of @p header , in bytes
+    /// @param[in] threshold must match the threshold used by gather_ostreambuf
+    scatter_istreambuf(const void* header, std::size_t size, std::size_t threshold) : threshold_(threshold) {
+      char* begin = const_cast<char*>(static_cast<const char*>(header));
+      this->setg(begin, begin, begin + size);
+    }
+
+    /// @return the number of bytes read from the header buffer
+    std::size_t header_size() const { return this->gptr() - this->eback(); }
+    /// @return the iovecs referring to the destinations of the long reads, in the order of reading
+    const std::vector<ttg::iovec>& iovecs() const { return iovecs_; }
+
+   protected:
+    std::streamsize xsgetn(char_type* s, std::streamsize n) override {
+      if (static_cast<std::size_t>(n) >= threshold_) {
+        iovecs_.push_back(ttg::iovec{static_cast<std::size_t>(n), s});
+        return n;
+      }
+      const std::streamsize count = std::min(n, static_cast<std::streamsize>(this->egptr() - this->gptr()));
+      std::memcpy(s, this->gptr(), count);
+      this->gbump(static_cast<int>(count));
+      return count;
+    }
+
+   private:
+    std::size_t threshold_;
+    std::vector<ttg::iovec> iovecs_ = {};
+  };
+
 }  // namespace ttg::detail
 
 #endif  // TTG_SERIALIZATION_STREAM_H
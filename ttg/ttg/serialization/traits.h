@@ -141,7 +141,7 @@ namespace ttg::detail {
   template <typename T, typename Enabler = void>
   inline constexpr bool is_archive_v = false;
 
-  template <typename T, typename Enabler>
+  template <typename T, typename Enabler = void>
   inline constexpr bool is_input_archive_v = false;
 
   template <typename T, typename Enabler = void>
@@ -170,6 +170,10 @@ namespace ttg::detail {
 #include "ttg/serialization/backends.h"
 
 namespace ttg::detail {
+  /// evaluates to true if `T` provides serialization methods for the TTG buffer archives, defined in buffer_archive.h
+  template <typename T, typename Enabler = void>
+  struct is_ttg_user_buffer_serializable;
+
   /// is_user_buffer_serializable<T> evaluates to true if `T` can be serialized to a buffer using user-provided methods
   template <typename T, typename Enabler = void>
   struct is_user_buffer_serializable : std::false_type {};
@@ -180,11 +184,18 @@ namespace ttg::detail {
   template <typename T>
   struct is_user_buffer_serializable<
       T, std::enable_if_t<is_madness_user_buffer_serializable_v<T> || is_boost_user_buffer_serializable_v<T> ||
-                          is_cereal_user_buffer_serializable_v<T>>> : std::true_type {};
+                          is_cereal_user_buffer_serializable_v<T> ||
+                          is_ttg_user_buffer_serializable<std::remove_cv_t<T>>::value>> : std::true_type {};
 
   template <typename T>
   inline constexpr bool is_user_buffer_serializable_v = is_user_buffer_serializable<T>::value;
 
+  /// evaluates to true if `T` is serialized by copying its bytes
+  template <typename T>
+  inline constexpr bool is_bitcopyable_v = std::is_trivially_copyable_v<T> && !is_user_buffer_serializable_v<T>;
+
 }  // namespace ttg::detail
 
+#include "ttg/serialization/buffer_archive.h"
+
 #endif  // TTG_SERIALIZATION_TRAITS_H
@@ -1,13 +1,19 @@
 #ifndef TTG_TERMINALS_H
 #define TTG_TERMINALS_H
 
+#include <algorithm>
 #include <exception>
+#include <functional>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "ttg/base/terminal.h"
+#include "ttg/base/tt.h"
 #include "ttg/fwd.h"
 #include "ttg/util/demangle.h"
+#include "ttg/util/hash.h"
+#include "ttg/util/key_range.h"
 #include "ttg/util/meta.h"
 #include "ttg/util/trace.h"
 #include "ttg/world.h"
@@ -16,8 +22,34 @@
 namespace ttg {
   namespace detail {
 
+    /// the type of `a == b` for objects of type \c T , used to detect equality-comparable types
+    template <typename T>
+    using equal_to_t = decltype(std::declval<const T &>() == std::declval<const T &>());
+
+    /// true if the container index \c T can be hashed by std::hash, or by ttg::hash without a user-provided
+    /// specialization (detecting the latter would trip the static_assert of the primary ttg::hash template)
+    template <typename T>
+    constexpr bool is_index_hashable_v = std::is_default_constructible_v<std::hash<T>> || std::is_integral_v<T> ||
+                                         meta::has_member_function_hash_v<T> ||
+                                         std::has_unique_object_representations_v<T>;
+
+    /// hashes container index \p index , see is_index_hashable_v
+    template <typename T>
+    std::size_t hash_index(const T &index) {
+      if constexpr (std::is_default_constructible_v<std::hash<T>>)
+        return std::hash<T>{}(index);
+      else
+        return ttg::hash<T>{}(index);
+    }
+
     /* Wraps any key,value data structure.
      * Elements of the data structure can be accessed using get method, which calls the at method of the Container.
+     * The optional prefetch hint returns the keys whose elements are likely to be pulled soon after the element
+     * for the given key; backends may fetch them along with the requested element.
+     * element_hash and same_element identify the element that the mapper maps a key to, so that backends can
+     * fetch an element once for all keys that map to it; they are unset if the index returned by the mapper is not
+     * hashable (see is_index_hashable_v) or not equality-comparable, then each key is assumed to map to a distinct
+     * element.
      * keyT - taskID
      * valueT - Value type of the Container
     */
@@ -25,6 +57,9 @@ namespace ttg {
     struct ContainerWrapper {
       std::function<valueT (keyT const& key)> get = nullptr;
       std::function<size_t (keyT const& key)> owner = nullptr;
+      std::function<std::vector<keyT> (keyT const& key)> prefetch = nullptr;
+      std::function<std::size_t (keyT const& key)> element_hash = nullptr;
+      std::function<bool (keyT const& a, keyT const& b)> same_element = nullptr;
 
       ContainerWrapper() = default;
       ContainerWrapper(const ContainerWrapper &) = default;
@@ -35,7 +70,7 @@ namespace ttg {
                                                           ContainerWrapper>{}, bool> = true>
         //Store a pointer to the user's container in std::any, no copies
         ContainerWrapper(T &t, mapperT &&mapper,
-                         keymapT &&keymap) : get([&t, mapper = std::forward<mapperT>(mapper)](keyT const &key) {
+                         keymapT &&keymap) : get([&t, mapper](keyT const &key) {
                                                    if constexpr (!std::is_class_v<T> && std::is_invocable_v<T, keyT>) {
                                                       auto k = mapper(key);
                                                       return t(k); //Call the user-defined lambda function.
@@ -47,12 +82,25 @@ namespace ttg {
                                                       return t.at(k);
                                                     }
                                                 }),
-                                             owner([&t, mapper = std::forward<mapperT>(mapper),
+                                             owner([&t, mapper,
                                                     keymap = std::forward<keymapT>(keymap)](keyT const &key) {
                                                     auto idx = mapper(key); //Mapper to map task ID to index of the data structure.
                                                     return keymap(idx);
                                                   })
-        {}
+        {
+          using indexT = std::decay_t<decltype(mapper(std::declval<keyT const &>()))>;
+          if constexpr (is_index_hashable_v<indexT> && meta::is_detected_v<equal_to_t, indexT>) {
+            element_hash = [mapper](keyT const &key) { return hash_index(mapper(key)); };
+            same_element = [mapper](keyT const &a, keyT const &b) { return mapper(a) == mapper(b); };
+          }
+        }
+
+      template<typename T, typename mapperT, typename keymapT, typename prefetchT,
+               std::enable_if_t<!std::is_same<std::decay_t<T>, ContainerWrapper>{}, bool> = true>
+        ContainerWrapper(T &t, mapperT &&mapper, keymapT &&keymap, prefetchT &&prefetch)
+        : ContainerWrapper(t, std::forward<mapperT>(mapper), std::forward<keymapT>(keymap)) {
+        this->prefetch = std::forward<prefetchT>(prefetch);
+      }
     };
 
     template <typename valueT> struct ContainerWrapper<void, valueT> {
@@ -86,6 +134,7 @@ namespace ttg {
                   "InTerminalBase<keyT,valueT> assumes keyT is a non-decayable type");
     using setsize_callback_type = meta::detail::setsize_callback_t<keyT>;
     using finalize_callback_type = meta::detail::finalize_callback_t<keyT>;
+    using keymap_callback_type = meta::detail::keymap_t<keyT>;
     static constexpr bool is_an_input_terminal = true;
 
    protected:
@@ -93,6 +142,7 @@ namespace ttg {
 
     setsize_callback_type setsize_callback;
     finalize_callback_type finalize_callback;
+    keymap_callback_type keymap_callback;
 
     void set_callback(const setsize_callback_type &setsize_callback = setsize_callback_type{},
                       const finalize_callback_type &finalize_callback = finalize_callback_type{}) {
@@ -108,6 +158,21 @@ namespace ttg {
     InTerminalBase &operator=(const InTerminalBase &&other) = delete;
 
    public:
+    /// Define the callback used to query the rank owning the task with a given key, i.e. the keymap of the TT
+    /// that this terminal belongs to; lets senders group the keys of a broadcast by owner
+    void set_keymap_callback(const keymap_callback_type &keymap_callback) { this->keymap_callback = keymap_callback; }
+
+    /// @return true if the owner of a task can be queried with owner()
+    bool has_owner() const { return static_cast<bool>(keymap_callback); }
+
+    /// @return the rank that owns the task with \p key
+    /// \pre `has_owner()==true`
+    template <typename Key = keyT>
+    std::enable_if_t<!meta::is_void_v<Key>, int> owner(const Key &key) const {
+      assert(keymap_callback);
+      return keymap_callback(key);
+    }
+
     template <typename Key = keyT>
     std::enable_if_t<!meta::is_void_v<Key>, void> set_size(const Key &key, std::size_t size) {
       if (!setsize_callback) throw std::runtime_error("set_size callback not initialized");
@@ -153,6 +218,10 @@ namespace ttg {
     using send_callback_type = meta::detail::send_callback_t<keyT, std::decay_t<valueT>>;
     using move_callback_type = meta::detail::move_callback_t<keyT, std::decay_t<valueT>>;
     using broadcast_callback_type = meta::detail::broadcast_callback_t<keyT, std::decay_t<valueT>>;
+    using move_broadcast_callback_type = meta::detail::move_broadcast_callback_t<keyT, std::decay_t<valueT>>;
+    using strided_broadcast_callback_type = meta::detail::strided_broadcast_callback_t<keyT, std::decay_t<valueT>>;
+    using static_send_callback_type = meta::detail::static_send_callback_t<keyT, std::decay_t<valueT>>;
+    using static_move_callback_type = meta::detail::static_move_callback_t<keyT, std::decay_t<valueT>>;
     using setsize_callback_type = typename base_type::setsize_callback_type;
     using finalize_callback_type = typename base_type::finalize_callback_type;
     static constexpr bool is_an_input_terminal = true;
@@ -162,6 +231,14 @@ namespace ttg {
     send_callback_type send_callback;
     move_callback_type move_callback;
     broadcast_callback_type broadcast_callback;
+    move_broadcast_callback_type move_broadcast_callback;
+    strided_broadcast_callback_type strided_broadcast_callback;
+    void *static_callback_target = nullptr;
+    static_send_callback_type static_send_callback = nullptr;
+    static_move_callback_type static_move_callback = nullptr;
+
+    template <typename, typename>
+    friend class Out;
 
     // No moving, copying, assigning permitted
     In(In &&other) = delete;
@@ -186,16 +263,38 @@ namespace ttg {
     ///     will continue adding data onto this terminal
     /// \param[in] setsize_callback: if the terminal is a reduce terminal, announces how many items will be set
     ///     unto this terminal for reduction
+    /// \param[in] move_bcast_callback: when this terminal receives a list of task identifiers to broadcast a rvalue
+    ///     reference to; the backend may move the value into one of the tasks
     void set_callback(const send_callback_type &send_callback, const move_callback_type &move_callback,
                       const broadcast_callback_type &bcast_callback = broadcast_callback_type{},
                       const setsize_callback_type &setsize_callback = setsize_callback_type{},
-                      const finalize_callback_type &finalize_callback = finalize_callback_type{}) {
+                      const finalize_callback_type &finalize_callback = finalize_callback_type{},
+                      const move_broadcast_callback_type &move_bcast_callback = move_broadcast_callback_type{}) {
       this->send_callback = send_callback;
       this->move_callback = move_callback;
       this->broadcast_callback = bcast_callback;
+      this->move_broadcast_callback = move_bcast_callback;
       base_type::set_callback(setsize_callback, finalize_callback);
     }
 
+    /// Define the callback that receives the broadcasts to a ttg::strided_range as a {start, stride, count} triple,
+    /// so that the backend need not materialize the keys; only used for integral keys
+    void set_strided_broadcast_callback(const strided_broadcast_callback_type &strided_bcast_callback) {
+      this->strided_broadcast_callback = strided_bcast_callback;
+    }
+
+    /// Define the raw entry points used by the output terminals connected to this Input Terminal
+    /// when static dispatch is on (see TTBase::set_static_dispatch)
+    /// \param[in] target: the object passed as the first argument to the callbacks, typically the backend TT
+    /// \param[in] send_callback: when an object must be copied inside this terminal
+    /// \param[in] move_callback: when a rvalue reference is std::move onto this terminal
+    void set_static_callback(void *target, static_send_callback_type send_callback,
+                             static_move_callback_type move_callback) {
+      this->static_callback_target = target;
+      this->static_send_callback = send_callback;
+      this->static_move_callback = move_callback;
+    }
+
     template <typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_none_void_v<Key, Value>, void> send(const Key &key, const Value &value) {
       if (!send_callback) throw std::runtime_error("send callback not initialized");
@@ -233,18 +332,38 @@ namespace ttg {
       send_callback();
     }
 
-    // An optimized implementation will need a separate callback for broadcast
-    // with a specific value for rangeT
+   private:
+    /// invokes \p f with a contiguous span of the keys in \p keylist; lazy ranges (e.g. ttg::generated_range) are
+    /// materialized, since the backends group the keys by owner, a \p keylist that is not iterable is treated as a
+    /// single key
+    template <typename rangeT, typename F>
+    static void with_keylist_span(const rangeT &keylist, F &&f) {
+      if constexpr (ttg::meta::is_contiguous_range_v<const rangeT>) {
+        f(ttg::span<const keyT>(std::data(keylist), std::size(keylist)));
+      } else if constexpr (ttg::meta::is_iterable_v<rangeT>) {
+        const std::vector<keyT> keys(std::begin(keylist), std::end(keylist));
+        f(ttg::span<const keyT>(keys.data(), keys.size()));
+      } else {
+        f(ttg::span<const keyT>(&keylist, 1));
+      }
+    }
+
+   public:
+    /// broadcasts \p value to the tasks in \p keylist, which can be a contiguous container, a lazy range
+    /// (e.g. ttg::generated_range), or a single key; if the backend does not provide a broadcast callback
+    /// the keys are consumed one at a time, without materializing the key list. A ttg::strided_range is never
+    /// materialized if the backend provides a strided broadcast callback.
     template <typename rangeT, typename Value>
     std::enable_if_t<!meta::is_void_v<Value>, void> broadcast(const rangeT &keylist, const Value &value) {
-      if (broadcast_callback) {
-        if constexpr (ttg::meta::is_iterable_v<rangeT>) {
-          broadcast_callback(ttg::span(&(*std::begin(keylist)), std::distance(std::begin(keylist), std::end(keylist))),
-                             value);
-        } else {
-          /* got something we cannot iterate over (single element?) so put one element in the span */
-          broadcast_callback(ttg::span<const keyT>(&keylist, 1), value);
+      if constexpr (ttg::is_strided_range_v<rangeT>) {
+        if (strided_broadcast_callback) {
+          const auto &gen = keylist.generator();
+          strided_broadcast_callback(gen.start, gen.stride, keylist.size(), value);
+          return;
         }
+      }
+      if (broadcast_callback) {
+        with_keylist_span(keylist, [&](const ttg::span<const keyT> &keys) { broadcast_callback(keys, value); });
       } else {
         if constexpr (ttg::meta::is_iterable_v<rangeT>) {
           for (auto &&key : keylist) send(key, value);
@@ -255,23 +374,36 @@ namespace ttg {
       }
     }
 
+    /// broadcasts a rvalue: the value is moved into (at most) one of the tasks, the others receive copies
     template <typename rangeT, typename Value>
-    std::enable_if_t<!meta::is_void_v<Value>, void> broadcast(const rangeT &keylist, Value &&value) {
-      const Value &v = value;
-      if (broadcast_callback) {
-        if constexpr (ttg::meta::is_iterable_v<rangeT>) {
-          broadcast_callback(
-              ttg::span<const keyT>(&(*std::begin(keylist)), std::distance(std::begin(keylist), std::end(keylist))), v);
-        } else {
-          /* got something we cannot iterate over (single element?) so put one element in the span */
-          broadcast_callback(ttg::span<const keyT>(&keylist, 1), v);
-        }
+    std::enable_if_t<!meta::is_void_v<Value> && std::is_same_v<Value, std::remove_reference_t<Value>>, void> broadcast(
+        const rangeT &keylist, Value &&value) {
+      if constexpr (std::is_const_v<valueT>) {
+        /* read-only terminal, nothing to move into */
+        broadcast(keylist, static_cast<const Value &>(value));
+      } else if (ttg::is_strided_range_v<rangeT> && strided_broadcast_callback) {
+        /* keys sent as a strided range, the backend copies the value */
+        broadcast(keylist, static_cast<const Value &>(value));
+      } else if (move_broadcast_callback) {
+        with_keylist_span(keylist, [&](const ttg::span<const keyT> &keys) {
+          move_broadcast_callback(keys, std::forward<Value>(value));
+        });
+      } else if (broadcast_callback) {
+        broadcast(keylist, static_cast<const Value &>(value));
       } else {
         if constexpr (ttg::meta::is_iterable_v<rangeT>) {
-          for (auto &&key : keylist) send(key, v);
+          /* send copies to all but the last key, move into the last */
+          const auto end = std::end(keylist);
+          for (auto it = std::begin(keylist); it != end;) {
+            const auto &key = *it;
+            if (++it == end)
+              send(key, std::forward<Value>(value));
+            else
+              send(key, static_cast<const Value &>(value));
+          }
         } else {
-          /* got something we cannot iterate over (single element?) so put one element in the span */
-          broadcast_callback(ttg::span<const keyT>(&keylist, 1), v);
+          /* single element */
+          send(keylist, std::forward<Value>(value));
         }
       }
     }
@@ -279,19 +411,13 @@ namespace ttg {
     template <typename rangeT, typename Value = valueT>
     std::enable_if_t<meta::is_void_v<Value>, void> broadcast(const rangeT &keylist) {
       if (broadcast_callback) {
-        if constexpr (ttg::meta::is_iterable_v<rangeT>) {
-          broadcast_callback(
-              ttg::span<const keyT>(&(*std::begin(keylist)), std::distance(std::begin(keylist), std::end(keylist))));
-        } else {
-          /* got something we cannot iterate over (single element?) so put one element in the span */
-          broadcast_callback(ttg::span<const keyT>(&keylist, 1));
-        }
+        with_keylist_span(keylist, [&](const ttg::span<const keyT> &keys) { broadcast_callback(keys); });
       } else {
         if constexpr (ttg::meta::is_iterable_v<rangeT>) {
           for (auto &&key : keylist) sendk(key);
         } else {
-          /* got something we cannot iterate over (single element?) so put one element in the span */
-          broadcast_callback(ttg::span<const keyT>(&keylist, 1));
+          /* single element */
+          sendk(keylist);
         }
       }
     }
@@ -394,6 +520,22 @@ namespace ttg {
     static constexpr bool is_an_output_terminal = true;
 
    private:
+    using static_send_callback_type = meta::detail::static_send_callback_t<keyT, valueT>;
+    using static_move_callback_type = meta::detail::static_move_callback_t<keyT, valueT>;
+
+    /// a successor bound for static dispatch
+    struct static_successor {
+      void *target;
+      static_send_callback_type send;
+      static_move_callback_type move;
+    };
+
+    /// successors bound for static dispatch, in the order of successors(), except that the first Consume
+    /// successor (if any) is last so that an rvalue can be moved into it after all copies have been sent
+    std::vector<static_successor> static_successors;
+    bool static_dispatch = false;          //< true if static_successors is valid
+    bool static_move_successor = false;    //< true if the last element of static_successors takes rvalues
+
     // No moving, copying, assigning permitted
     Out(Out &&other) = delete;
     Out(const Out &other) = delete;
@@ -423,14 +565,55 @@ namespace ttg {
       trace(rank(), ": connected Out<> ", this->get_name(), "(ptr=", this, ") to In<> ", in->get_name(), "(ptr=", in,
             ")");
 #endif
+      // connections changed, fall back to dynamic dispatch until made executable again
+      static_dispatch = false;
+      static_successors.clear();
       this->connect_base(in);
       //If I am a pull terminal, add me as (in)'s predecessor
       if (this->is_pull_terminal)
         in->connect_pull(this);
     }
 
+    /// binds the successors for static dispatch if TTBase::is_static_dispatch() is true; if any successor did not
+    /// provide static entry points (see In::set_static_callback) sends keep using dynamic dispatch
+    void make_executable() override {
+      static_dispatch = false;
+      static_move_successor = false;
+      static_successors.clear();
+      if (!TTBase::is_static_dispatch()) return;
+      std::vector<static_successor> successors;
+      successors.reserve(this->nsuccessors() + 1);
+      for (auto &&successor : this->successors()) {
+        if (successor->get_type() == TerminalBase::Type::Read) {
+          auto *in = static_cast<In<keyT, std::add_const_t<valueT>> *>(successor);
+          if (nullptr == in->static_send_callback) return;
+          successors.push_back({in->static_callback_target, in->static_send_callback, nullptr});
+        } else if (successor->get_type() == TerminalBase::Type::Consume) {
+          auto *in = static_cast<In<keyT, valueT> *>(successor);
+          if (nullptr == in->static_send_callback || nullptr == in->static_move_callback) return;
+          successors.push_back({in->static_callback_target, in->static_send_callback, in->static_move_callback});
+        } else {
+          throw std::logic_error("Out<>: invalid successor type");
+        }
+      }
+      // rotate the first Consume successor to the back
+      auto it = std::find_if(successors.begin(), successors.end(), [](const auto &s) { return nullptr != s.move; });
+      if (it != successors.end()) {
+        auto move_successor = *it;
+        successors.erase(it);
+        successors.push_back(move_successor);
+        static_move_successor = true;
+      }
+      static_successors = std::move(successors);
+      static_dispatch = true;
+    }
+
     template<typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_none_void_v<Key,Value>,void> send(const Key &key, const Value &value) {
+      if (static_dispatch) {
+        for (auto &&s : static_successors) s.send(s.target, key, value);
+        return;
+      }
       for (auto && successor : this->successors()) {
         assert(successor->get_type() != TerminalBase::Type::Write);
         if (successor->get_type() == TerminalBase::Type::Read) {
@@ -443,6 +626,10 @@ namespace ttg {
 
     template <typename Key = keyT, typename Value = valueT>
     std::enable_if_t<!meta::is_void_v<Key> && meta::is_void_v<Value>, void> sendk(const Key &key) {
+      if (static_dispatch) {
+        for (auto &&s : static_successors) s.send(s.target, key);
+        return;
+      }
       for (auto &&successor : this->successors()) {
         assert(successor->get_type() != TerminalBase::Type::Write);
         if (successor->get_type() == TerminalBase::Type::Read) {
@@ -455,6 +642,10 @@ namespace ttg {
 
     template <typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_void_v<Key> && !meta::is_void_v<Value>, void> sendv(const Value &value) {
+      if (static_dispatch) {
+        for (auto &&s : static_successors) s.send(s.target, value);
+        return;
+      }
       for (auto &&successor : this->successors()) {
         assert(successor->get_type() != TerminalBase::Type::Write);
         if (successor->get_type() == TerminalBase::Type::Read) {
@@ -468,6 +659,10 @@ namespace ttg {
     template <typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_all_void_v<Key, Value>, void> send() {
       trace(rank(), ": in ", this->get_name(), "(ptr=", this, ") Out<>::send: #successors=", this->successors().size());
+      if (static_dispatch) {
+        for (auto &&s : static_successors) s.send(s.target);
+        return;
+      }
       for (auto &&successor : this->successors()) {
         assert(successor->get_type() != TerminalBase::Type::Write);
         if (successor->get_type() == TerminalBase::Type::Read) {
@@ -485,6 +680,15 @@ namespace ttg {
     template <typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_none_void_v<Key, Value> && std::is_same_v<Value, std::remove_reference_t<Value>>, void>
     send(const Key &key, Value &&value) {
+      if (static_dispatch) {
+        const std::size_t ncopies = static_successors.size() - (static_move_successor ? 1 : 0);
+        for (std::size_t i = 0; i != ncopies; ++i) static_successors[i].send(static_successors[i].target, key, value);
+        if (static_move_successor) {
+          const auto &s = static_successors.back();
+          s.move(s.target, key, std::forward<Value>(value));
+        }
+        return;
+      }
       const std::size_t N = this->nsuccessors();
       TerminalBase *move_successor = nullptr;
       // send copies to every terminal except the one we will move the results to
@@ -509,7 +713,7 @@ namespace ttg {
     // with a specific value for rangeT
     template <typename rangeT, typename Key = keyT, typename Value = valueT>
     std::enable_if_t<meta::is_none_void_v<Key, Value>, void> broadcast(const rangeT &keylist,
-                                                                       const Value &value) {  // NO MOVE YET
+                                                                       const Value &value) {
       for (auto &&successor : this->successors()) {
         assert(successor->get_type() != TerminalBase::Type::Write);
         if (successor->get_type() == TerminalBase::Type::Read) {
@@ -520,6 +724,29 @@ namespace ttg {
       }
     }
 
+    /// broadcasts a rvalue: Read successors and all but one Consume successor receive the value by const reference,
+    /// the first Consume successor receives it last, as an rvalue
+    template <typename rangeT, typename Key = keyT, typename Value = valueT>
+    std::enable_if_t<meta::is_none_void_v<Key, Value> && std::is_same_v<Value, std::remove_reference_t<Value>>, void>
+    broadcast(const rangeT &keylist, Value &&value) {
+      TerminalBase *move_successor = nullptr;
+      for (auto &&successor : this->successors()) {
+        assert(successor->get_type() != TerminalBase::Type::Write);
+        if (successor->get_type() == TerminalBase::Type::Read) {
+          static_cast<In<keyT, std::add_const_t<valueT>> *>(successor)->broadcast(keylist, value);
+        } else if (successor->get_type() == TerminalBase::Type::Consume) {
+          if (nullptr == move_successor) {
+            move_successor = successor;
+          } else {
+            static_cast<In<keyT, valueT> *>(successor)->broadcast(keylist, static_cast<const Value &>(value));
+          }
+        }
+      }
+      if (nullptr != move_successor) {
+        static_cast<In<keyT, valueT> *>(move_successor)->broadcast(keylist, std::forward<Value>(value));
+      }
+    }
+
     template <typename rangeT, typename Key = keyT>
     std::enable_if_t<meta::is_none_void_v<Key> && meta::is_void_v<valueT>, void> broadcast(const rangeT &keylist) {
       for (auto &&successor : this->successors()) {
@@ -62,7 +62,7 @@ namespace ttg {
               std::cout << "ttg::Traverse: got a null predecessor!\n";
               status = false;
             } else {
-              status = status && traverse(predecessor->get_tt());
+              status = traverse(predecessor->get_tt()) && status;
             }
           }
         }
@@ -91,7 +91,7 @@ namespace ttg {
                 std::cout << "ttg::Traverse: got a null successor!\n";
                 status = false;
               } else {
-                status = status && traverse(successor->get_tt());
+                status = traverse(successor->get_tt()) && status;
               }
             }
           }
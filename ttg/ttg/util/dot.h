@@ -4,6 +4,8 @@
 #include <sstream>
 #include <map>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "ttg/base/terminal.h"
 #include "ttg/traverse.h"
@@ -14,6 +16,7 @@ namespace ttg {
     std::stringstream edges;
     std::map<const TTBase*, std::stringstream> tt_nodes;
     std::multimap<const TTBase *, const TTBase *> ttg_hierarchy;
+    std::multimap<const TTBase *, const TTBase *> fused_tts;  // root -> TTs in its node (including the root)
     int cluster_cnt;
     bool disable_type;
 
@@ -55,87 +58,125 @@ namespace ttg {
       }
     }
 
-    void ttfunc(TTBase *tt) {
-      std::string ttnm = nodename(tt);
-      bool is_ttg = true;
+    // The TT whose node represents \p tt: TTs fused into their producers (see TTBase::get_fused_producer()) are
+    // drawn as part of the node of the first TT of their chain
+    const TTBase *root(const TTBase *tt) {
+      while (tt->get_fused_producer() != nullptr) tt = tt->get_fused_producer();
+      return tt;
+    }
+
+    // The name of the port of the output terminal \p out in the node of its TT
+    std::string outport(const TerminalBase *out) {
+      std::stringstream s;
+      const TTBase *tt = out->get_tt();
+      if (root(tt) != tt) s << "t" << tt->get_instance_id();
+      s << "out" << out->get_index();
+      return s.str();
+    }
+
+    // True if \p out feeds a TT fused into the TT of \p out, i.e. its edge is hidden inside a node
+    static bool is_fused_edge(const TerminalBase *out) {
+      for (auto successor : out->get_connections()) {
+        if (successor && successor->get_tt()->get_fused_producer() == out->get_tt()) return true;
+      }
+      return false;
+    }
 
+    void ttfunc(TTBase *tt) {
       const TTBase *ttc = reinterpret_cast<const TTBase*>(tt);
-      build_ttg_hierarchy(ttc);
       if(!tt->is_ttg()) {
-        std::stringstream ttss;
-        
-        ttss << "        " << ttnm << " [shape=record,style=filled,fillcolor=gray90,label=\"{";
-
-        size_t count = 0;
-        if (tt->get_inputs().size() > 0) ttss << "{";
-        for (auto in : tt->get_inputs()) {
-          if (in) {
-            if (count != in->get_index()) throw "ttg::Dot: lost count of ins";
-            if (disable_type) {
-              ttss << " <in" << count << ">"
-                   << " " << escape(in->get_key_type_str()) << " " << escape(in->get_name());
-            } else {
-              ttss << " <in" << count << ">"
-                   << " " << escape("<" + in->get_key_type_str() + "," + in->get_value_type_str() + ">") << " "
-                   << escape(in->get_name());
-           }
-          } else {
-            ttss << " <in" << count << ">"
-                 << " unknown ";
-          }
-          count++;
-          if (count < tt->get_inputs().size()) ttss << " |";
+        if (root(ttc) == ttc) {
+          build_ttg_hierarchy(ttc);
+          tt_nodes.insert({ttc, std::stringstream{}});
         }
-        if (tt->get_inputs().size() > 0) ttss << "} |";
-
-        ttss << tt->get_name() << " ";
-
-        if (tt->get_outputs().size() > 0) ttss << " | {";
+        fused_tts.insert({root(ttc), tt});
+      } else {
+        build_ttg_hierarchy(ttc);
+        std::cout << nodename(tt) << " is a TTG" << std::endl;
+      }
 
-        count = 0;
-        for (auto out : tt->get_outputs()) {
-          if (out) {
-            if (count != out->get_index()) throw "ttg::Dot: lost count of outs";
-            if (disable_type) {
-              ttss << " <out" << count << ">"
-                   << " " << escape(out->get_key_type_str()) << " " << out->get_name();
-            } else {
-              ttss << " <out" << count << ">"
-                   << " " << escape("<" + out->get_key_type_str() + "," + out->get_value_type_str() + ">") << " "
-                   << out->get_name();
+      for (auto out : tt->get_outputs()) {
+        if (out && !is_fused_edge(out)) {
+          for (auto successor : out->get_connections()) {
+            if (successor) {
+              edges << nodename(root(ttc)) << ":" << outport(out) << ":s -> " << nodename(root(successor->get_tt()))
+                    << ":in" << successor->get_index() << ":n;\n";
             }
-          } else {
-            ttss << " <out" << count << ">"
-                 << " unknown ";
           }
-          count++;
-          if (count < tt->get_outputs().size()) ttss << " |";
         }
+      }
+    }
 
-        if (tt->get_outputs().size() > 0) ttss << "}";
+    // Renders the node of \p tt, which includes the TTs fused into \p tt
+    void render_node(const TTBase *tt, std::stringstream &ttss) {
+      std::string ttnm = nodename(tt);
+      auto fused = fused_tts.equal_range(tt);
 
-        ttss << " } \"];\n";
+      ttss << "        " << ttnm << " [shape=record,style=filled,fillcolor=gray90,label=\"{";
 
-        auto search = tt_nodes.find(ttc);
-        if( tt_nodes.end() == search ) {
-          tt_nodes.insert( {ttc, std::move(ttss)} );
+      size_t count = 0;
+      if (tt->get_inputs().size() > 0) ttss << "{";
+      for (auto in : tt->get_inputs()) {
+        if (in) {
+          if (count != in->get_index()) throw "ttg::Dot: lost count of ins";
+          if (disable_type) {
+            ttss << " <in" << count << ">"
+                 << " " << escape(in->get_key_type_str()) << " " << escape(in->get_name());
+          } else {
+            ttss << " <in" << count << ">"
+                 << " " << escape("<" + in->get_key_type_str() + "," + in->get_value_type_str() + ">") << " "
+                 << escape(in->get_name());
+         }
         } else {
-          search->second << ttss.str();
+          ttss << " <in" << count << ">"
+               << " unknown ";
         }
-      } else {
-        std::cout << ttnm << " is a TTG" << std::endl;
+        count++;
+        if (count < tt->get_inputs().size()) ttss << " |";
       }
+      if (tt->get_inputs().size() > 0) ttss << "} |";
 
-      for (auto out : tt->get_outputs()) {
+      ttss << tt->get_name() << " ";
+      for (auto member = fused.first; member != fused.second; ++member) {
+        if (member->second != tt) ttss << "+ " << member->second->get_name() << " ";
+      }
+
+      // outputs of all TTs in the node, except those feeding the fused TTs
+      std::vector<std::tuple<const TTBase *, const TerminalBase *, size_t>> outs;
+      for (auto member = fused.first; member != fused.second; ++member) {
+        count = 0;
+        for (auto out : member->second->get_outputs()) {
+          if (out && count != out->get_index()) throw "ttg::Dot: lost count of outs";
+          if (!out || !is_fused_edge(out)) outs.emplace_back(member->second, out, count);
+          count++;
+        }
+      }
+
+      if (outs.size() > 0) ttss << " | {";
+
+      count = 0;
+      for (auto [member, out, index] : outs) {
         if (out) {
-          for (auto successor : out->get_connections()) {
-            if (successor) {
-              edges << ttnm << ":out" << out->get_index() << ":s -> " << nodename(successor->get_tt()) << ":in"
-                    << successor->get_index() << ":n;\n";
-            }
+          if (disable_type) {
+            ttss << " <" << outport(out) << ">"
+                 << " " << escape(out->get_key_type_str()) << " " << out->get_name();
+          } else {
+            ttss << " <" << outport(out) << ">"
+                 << " " << escape("<" + out->get_key_type_str() + "," + out->get_value_type_str() + ">") << " "
+                 << out->get_name();
           }
+        } else {
+          ttss << " <" << (root(member) != member ? "t" + std::to_string(member->get_instance_id()) : std::string{})
+               << "out" << index << ">"
+               << " unknown ";
         }
+        count++;
+        if (count < outs.size()) ttss << " |";
       }
+
+      if (outs.size() > 0) ttss << "}";
+
+      ttss << " } \"];\n";
     }
 
     void infunc(TerminalBase *in) {}
@@ -181,11 +222,13 @@ namespace ttg {
 
       tt_nodes.clear();
       ttg_hierarchy.clear();
+      fused_tts.clear();
 
       buf << "digraph G {\n";
       buf << "        ranksep=1.5;\n";
       bool t = true;
       t &= (traverse(std::forward<TTBasePtrs>(ops)) && ... );
+      for (auto &[tt, ttss] : tt_nodes) render_node(tt, ttss);
 
       cluster_cnt = 0;
       tree_down(0, nullptr, buf);
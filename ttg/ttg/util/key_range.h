@@ -0,0 +1,155 @@
+#ifndef TTG_UTIL_KEY_RANGE_H
+#define TTG_UTIL_KEY_RANGE_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace ttg {
+
+  /// A lazy random-access range of \c count keys produced on the fly as \c gen(0), \c gen(1), ..., \c gen(count-1).
+  /// Can be passed to ttg::broadcast in place of a materialized key list.
+  /// \tparam Generator a callable mapping an index in `[0,count)` to a key
+  template <typename Generator>
+  class generated_range {
+   public:
+    using generator_type = Generator;
+    using value_type = std::decay_t<std::invoke_result_t<const Generator &, std::size_t>>;
+    using size_type = std::size_t;
+
+    class iterator {
+     public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = typename generated_range::value_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = value_type;
+
+      iterator() = default;
+      iterator(const generated_range *range, std::size_t idx) : range_(range), idx_(idx) {}
+
+      value_type operator*() const { return (*range_)[idx_]; }
+      value_type operator[](difference_type n) const { return (*range_)[idx_ + n]; }
+
+      iterator &operator++() {
+        ++idx_;
+        return *this;
+      }
+      iterator operator++(int) {
+        auto result = *this;
+        ++idx_;
+        return result;
+      }
+      iterator &operator--() {
+        --idx_;
+        return *this;
+      }
+      iterator operator--(int) {
+        auto result = *this;
+        --idx_;
+        return result;
+      }
+      iterator &operator+=(difference_type n) {
+        idx_ += n;
+        return *this;
+      }
+      iterator &operator-=(difference_type n) {
+        idx_ -= n;
+        return *this;
+      }
+      friend iterator operator+(iterator it, difference_type n) { return it += n; }
+      friend iterator operator+(difference_type n, iterator it) { return it += n; }
+      friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+      friend difference_type operator-(const iterator &a, const iterator &b) {
+        return static_cast<difference_type>(a.idx_) - static_cast<difference_type>(b.idx_);
+      }
+
+      friend bool operator==(const iterator &a, const iterator &b) { return a.idx_ == b.idx_; }
+      friend bool operator!=(const iterator &a, const iterator &b) { return a.idx_ != b.idx_; }
+      friend bool operator<(const iterator &a, const iterator &b) { return a.idx_ < b.idx_; }
+      friend bool operator>(const iterator &a, const iterator &b) { return a.idx_ > b.idx_; }
+      friend bool operator<=(const iterator &a, const iterator &b) { return a.idx_ <= b.idx_; }
+      friend bool operator>=(const iterator &a, const iterator &b) { return a.idx_ >= b.idx_; }
+
+     private:
+      const generated_range *range_ = nullptr;
+      std::size_t idx_ = 0;
+    };
+    using const_iterator = iterator;
+
+    generated_range(std::size_t count, Generator gen) : count_(count), gen_(std::move(gen)) {}
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, count_); }
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// @return the \p idx -th key
+    value_type operator[](std::size_t idx) const { return gen_(idx); }
+
+    const Generator &generator() const { return gen_; }
+
+   private:
+    std::size_t count_;
+    Generator gen_;
+  };
+
+  /// @return a lazy range of \p count keys `gen(0)`, ..., `gen(count-1)`
+  template <typename Generator>
+  auto make_generated_range(std::size_t count, Generator &&gen) {
+    return generated_range<std::decay_t<Generator>>(count, std::forward<Generator>(gen));
+  }
+
+  namespace detail {
+    /// @return `start + idx * stride` evaluated in the unsigned counterpart of \c Key , i.e. without signed overflow
+    ///         in the intermediate product; the result is exact whenever it is representable by \c Key
+    template <typename Key>
+    Key advance_key(Key start, std::size_t idx, Key stride) {
+      using ukeyT = std::make_unsigned_t<Key>;
+      return static_cast<Key>(static_cast<ukeyT>(static_cast<ukeyT>(start) +
+                                                 static_cast<ukeyT>(idx) * static_cast<ukeyT>(stride)));
+    }
+
+    /// @return `to - from` evaluated like advance_key, i.e. `advance_key(from, 1, key_difference(from, to)) == to`
+    ///         even if the difference is not representable by \c Key
+    template <typename Key>
+    Key key_difference(Key from, Key to) {
+      using ukeyT = std::make_unsigned_t<Key>;
+      return static_cast<Key>(static_cast<ukeyT>(static_cast<ukeyT>(to) - static_cast<ukeyT>(from)));
+    }
+
+    template <typename Key>
+    struct strided_key_generator {
+      static_assert(std::is_integral_v<Key> && !std::is_same_v<Key, bool>,
+                    "strided_key_generator<Key>: Key must be an integral type");
+      Key start;
+      Key stride;
+      Key operator()(std::size_t idx) const { return advance_key(start, idx, stride); }
+    };
+  }  // namespace detail
+
+  /// A lazy range of integral keys `start, start+stride, ..., start+(count-1)*stride`; backends can send the
+  /// {start, stride, count} triple instead of the keys (see ttg::In::broadcast)
+  template <typename Key>
+  using strided_range = generated_range<detail::strided_key_generator<Key>>;
+
+  /// evaluates to true if \c T is a ttg::strided_range
+  template <typename T>
+  struct is_strided_range : std::false_type {};
+
+  template <typename Key>
+  struct is_strided_range<strided_range<Key>> : std::true_type {};
+
+  template <typename T>
+  constexpr bool is_strided_range_v = is_strided_range<T>::value;
+
+  /// @return the lazy range of \p count keys `start, start+stride, ...`
+  template <typename Key>
+  auto make_strided_range(Key start, Key stride, std::size_t count) {
+    return strided_range<Key>(count, detail::strided_key_generator<Key>{start, stride});
+  }
+
+}  // namespace ttg
+
+#endif  // TTG_UTIL_KEY_RANGE_H
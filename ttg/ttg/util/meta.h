@@ -2,6 +2,7 @@
 #define TTG_UTIL_META_H
 
 #include <functional>
+#include <iterator>
 #include <type_traits>
 
 #include "ttg/util/span.h"
@@ -728,6 +729,53 @@ namespace ttg {
       template <typename Key, typename Value>
       using move_callback_t = typename move_callback<Key, Value>::type;
 
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      // static_send_callback_t<key,value> = void(*)(void*, const key&, const value&), protected against void key or value
+      // static_move_callback_t<key,value> = void(*)(void*, const key&, value&&), protected against void key or value
+      // the first argument is the object the callback is bound to
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      template <typename Key, typename Value, typename Enabler = void>
+      struct static_send_callback;
+      template <typename Key, typename Value>
+      struct static_send_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && !is_void_v<Value>>> {
+        using type = void (*)(void *, const Key &, const Value &);
+      };
+      template <typename Key, typename Value>
+      struct static_send_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && is_void_v<Value>>> {
+        using type = void (*)(void *, const Key &);
+      };
+      template <typename Key, typename Value>
+      struct static_send_callback<Key, Value, std::enable_if_t<is_void_v<Key> && !is_void_v<Value>>> {
+        using type = void (*)(void *, const Value &);
+      };
+      template <typename Key, typename Value>
+      struct static_send_callback<Key, Value, std::enable_if_t<is_void_v<Key> && is_void_v<Value>>> {
+        using type = void (*)(void *);
+      };
+      template <typename Key, typename Value>
+      using static_send_callback_t = typename static_send_callback<Key, Value>::type;
+
+      template <typename Key, typename Value, typename Enabler = void>
+      struct static_move_callback;
+      template <typename Key, typename Value>
+      struct static_move_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && !is_void_v<Value>>> {
+        using type = void (*)(void *, const Key &, Value &&);
+      };
+      template <typename Key, typename Value>
+      struct static_move_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && is_void_v<Value>>> {
+        using type = void (*)(void *, const Key &);
+      };
+      template <typename Key, typename Value>
+      struct static_move_callback<Key, Value, std::enable_if_t<is_void_v<Key> && !is_void_v<Value>>> {
+        using type = void (*)(void *, Value &&);
+      };
+      template <typename Key, typename Value>
+      struct static_move_callback<Key, Value, std::enable_if_t<is_void_v<Key> && is_void_v<Value>>> {
+        using type = void (*)(void *);
+      };
+      template <typename Key, typename Value>
+      using static_move_callback_t = typename static_move_callback<Key, Value>::type;
+
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       // broadcast_callback_t<key,value> = std::function<void(const key&, value&&>, protected against void key or value
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -752,6 +800,46 @@ namespace ttg {
       template <typename Key, typename Value>
       using broadcast_callback_t = typename broadcast_callback<Key, Value>::type;
 
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      // move_broadcast_callback_t<key,value> = std::function<void(const span<key>&, value&&>, protected against void key
+      // or value
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      template <typename Key, typename Value, typename Enabler = void>
+      struct move_broadcast_callback;
+      template <typename Key, typename Value>
+      struct move_broadcast_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && !is_void_v<Value>>> {
+        using type = std::function<void(const ttg::span<const Key> &, Value &&)>;
+      };
+      template <typename Key, typename Value>
+      struct move_broadcast_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && is_void_v<Value>>> {
+        using type = std::function<void(const ttg::span<const Key> &)>;
+      };
+      template <typename Key, typename Value>
+      struct move_broadcast_callback<Key, Value, std::enable_if_t<is_void_v<Key> && !is_void_v<Value>>> {
+        using type = std::function<void(Value &&)>;
+      };
+      template <typename Key, typename Value>
+      struct move_broadcast_callback<Key, Value, std::enable_if_t<is_void_v<Key> && is_void_v<Value>>> {
+        using type = std::function<void()>;
+      };
+      template <typename Key, typename Value>
+      using move_broadcast_callback_t = typename move_broadcast_callback<Key, Value>::type;
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      // strided_broadcast_callback_t<key,value> = std::function<void(const key& start, const key& stride, std::size_t
+      // count, const value&)>, protected against void key or value (only meaningful for integral keys)
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      template <typename Key, typename Value, typename Enabler = void>
+      struct strided_broadcast_callback {
+        using type = std::function<void()>;
+      };
+      template <typename Key, typename Value>
+      struct strided_broadcast_callback<Key, Value, std::enable_if_t<!is_void_v<Key> && !is_void_v<Value>>> {
+        using type = std::function<void(const Key &, const Key &, std::size_t, const Value &)>;
+      };
+      template <typename Key, typename Value>
+      using strided_broadcast_callback_t = typename strided_broadcast_callback<Key, Value>::type;
+
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       // setsize_callback_t<key> = std::function<void(const keyT &, std::size_t)> protected against void key
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -844,6 +932,20 @@ namespace ttg {
     template <typename T>
     constexpr bool is_iterable_v = is_iterable<T>::value;
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // check whether a type is a contiguous range, i.e. std::data() and std::size() can be called on it
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename T, typename = void>
+    struct is_contiguous_range : std::false_type {};
+
+    template <typename T>
+    struct is_contiguous_range<
+        T, std::void_t<decltype(std::data(std::declval<T &>())), decltype(std::size(std::declval<T &>()))>>
+        : std::is_pointer<decltype(std::data(std::declval<T &>()))> {};
+
+    template <typename T>
+    constexpr bool is_contiguous_range_v = is_contiguous_range<T>::value;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // check whether a Callable is invocable with the arguments given as a typelist
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
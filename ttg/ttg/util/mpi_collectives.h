@@ -0,0 +1,425 @@
+#ifndef TTG_UTIL_MPI_COLLECTIVES_H
+#define TTG_UTIL_MPI_COLLECTIVES_H
+
+#include <algorithm>
+#include <climits>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include "ttg/serialization/data_descriptor.h"
+
+/// MPI implementation of the collective operations of ttg::World, shared by the backends
+
+/// Objects of bitcopyable types (see ttg::detail::is_bitcopy_serialized_v) are communicated as bytes, reductions of
+/// arithmetic and complex types with the standard function objects (`std::plus`, `std::multiplies`,
+/// `std::logical_{and,or}`, `std::bit_{and,or,xor}`) use the predefined MPI datatypes and operations, and other
+/// reductions of bitcopyable types use MPI operations created for them. Other types are serialized once, preceded by
+/// their size; reductions of such objects follow a binomial tree. Messages longer than segment_size are split into
+/// segments whose (nonblocking) collectives are pipelined.
+/// All functions must be called by every process of the communicator in the same order, by one thread at a time.
+/// If other threads of the runtime make MPI calls and MPI does not support concurrent calls, the communicator comes
+/// with the mutex that serializes them (see comm).
+namespace ttg::detail::mpi {
+
+  /// messages longer than this are split into segments; this also keeps the element counts within the range of `int`
+  inline constexpr std::size_t segment_size = std::size_t(1) << 22;
+  /// the maximum number of segment collectives in flight
+  inline constexpr std::size_t max_segments_in_flight = 4;
+  /// a serialized object is broadcast together with its size if it is at most this long (including the size)
+  inline constexpr std::size_t eager_size = 4096;
+
+  /// A communicator, and the mutex that serializes the MPI calls of the collectives with those of the other threads of
+  /// the runtime, if MPI was initialized with less than `MPI_THREAD_MULTIPLE`
+
+  /// With a mutex, every MPI call is made while holding it, and the blocking operations are replaced by nonblocking
+  /// ones whose completion is tested, releasing the mutex in between, so that the other threads (e.g. the thread that
+  /// serves the active messages of the runtime) are not blocked while a collective waits for the other processes.
+  class comm {
+   public:
+    /// a communicator whose MPI calls need no serialization
+    comm(MPI_Comm c) : comm_(c) {}
+
+    /// a communicator whose MPI calls are serialized with \p mutex (a BasicLockable that must outlive this)
+    template <typename Mutex>
+    comm(MPI_Comm c, Mutex &mutex)
+        : comm_(c), lock_([&mutex] { mutex.lock(); }), unlock_([&mutex] { mutex.unlock(); }) {}
+
+    MPI_Comm get() const { return comm_; }
+
+    /// @return the result of `f()`, which makes MPI calls, called while holding the mutex, if any
+    template <typename F>
+    auto call(F &&f) const {
+      if (!lock_) return f();
+      lock_();
+      struct unlock_at_exit {
+        const std::function<void()> &unlock;
+        ~unlock_at_exit() { unlock(); }
+      } unlock{unlock_};
+      return f();
+    }
+
+    /// waits for the completion of \p request
+    void wait(MPI_Request *request) const {
+      if (!lock_) {
+        MPI_Wait(request, MPI_STATUS_IGNORE);
+        return;
+      }
+      int done = 0;
+      while (call([&] { return MPI_Test(request, &done, MPI_STATUS_IGNORE); }), !done) std::this_thread::yield();
+    }
+
+    int rank() const {
+      int result;
+      call([&] { return MPI_Comm_rank(comm_, &result); });
+      return result;
+    }
+
+    int size() const {
+      int result;
+      call([&] { return MPI_Comm_size(comm_, &result); });
+      return result;
+    }
+
+   private:
+    MPI_Comm comm_;
+    std::function<void()> lock_, unlock_;
+  };
+
+  template <typename T>
+  inline constexpr bool has_predefined_datatype_v =
+      std::is_same_v<T, bool> || std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+      std::is_same_v<T, unsigned char> || std::is_same_v<T, short> || std::is_same_v<T, unsigned short> ||
+      std::is_same_v<T, int> || std::is_same_v<T, unsigned int> || std::is_same_v<T, long> ||
+      std::is_same_v<T, unsigned long> || std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long> ||
+      std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, long double> ||
+      std::is_same_v<T, std::complex<float>> || std::is_same_v<T, std::complex<double>> ||
+      std::is_same_v<T, std::complex<long double>>;
+
+  /// @return the predefined MPI datatype of @p T
+  template <typename T>
+  inline MPI_Datatype predefined_datatype() {
+    static_assert(has_predefined_datatype_v<T>);
+    if constexpr (std::is_same_v<T, bool>) return MPI_CXX_BOOL;
+    else if constexpr (std::is_same_v<T, char>) return MPI_CHAR;
+    else if constexpr (std::is_same_v<T, signed char>) return MPI_SIGNED_CHAR;
+    else if constexpr (std::is_same_v<T, unsigned char>) return MPI_UNSIGNED_CHAR;
+    else if constexpr (std::is_same_v<T, short>) return MPI_SHORT;
+    else if constexpr (std::is_same_v<T, unsigned short>) return MPI_UNSIGNED_SHORT;
+    else if constexpr (std::is_same_v<T, int>) return MPI_INT;
+    else if constexpr (std::is_same_v<T, unsigned int>) return MPI_UNSIGNED;
+    else if constexpr (std::is_same_v<T, long>) return MPI_LONG;
+    else if constexpr (std::is_same_v<T, unsigned long>) return MPI_UNSIGNED_LONG;
+    else if constexpr (std::is_same_v<T, long long>) return MPI_LONG_LONG;
+    else if constexpr (std::is_same_v<T, unsigned long long>) return MPI_UNSIGNED_LONG_LONG;
+    else if constexpr (std::is_same_v<T, float>) return MPI_FLOAT;
+    else if constexpr (std::is_same_v<T, double>) return MPI_DOUBLE;
+    else if constexpr (std::is_same_v<T, long double>) return MPI_LONG_DOUBLE;
+    else if constexpr (std::is_same_v<T, std::complex<float>>) return MPI_CXX_FLOAT_COMPLEX;
+    else if constexpr (std::is_same_v<T, std::complex<double>>) return MPI_CXX_DOUBLE_COMPLEX;
+    else return MPI_CXX_LONG_DOUBLE_COMPLEX;
+  }
+
+  template <typename Op, template <typename> typename StdOp, typename T>
+  inline constexpr bool is_std_op_v = std::is_same_v<Op, StdOp<T>> || std::is_same_v<Op, StdOp<void>>;
+
+  /// whether reducing objects of type @p T with @p Op maps to a predefined MPI operation
+  template <typename T, typename Op, typename Op_ = std::decay_t<Op>>
+  inline constexpr bool has_predefined_op_v =
+      has_predefined_datatype_v<T> &&
+      (((is_std_op_v<Op_, std::plus, T> || is_std_op_v<Op_, std::multiplies, T>) && !std::is_same_v<T, bool>) ||
+       ((is_std_op_v<Op_, std::logical_and, T> || is_std_op_v<Op_, std::logical_or, T>) && std::is_integral_v<T>) ||
+       ((is_std_op_v<Op_, std::bit_and, T> || is_std_op_v<Op_, std::bit_or, T> ||
+         is_std_op_v<Op_, std::bit_xor, T>) &&
+        std::is_integral_v<T> && !std::is_same_v<T, bool>));
+
+  /// @return the predefined MPI operation that reduces objects of type @p T with @p Op
+  template <typename T, typename Op, typename Op_ = std::decay_t<Op>>
+  inline MPI_Op predefined_op() {
+    static_assert(has_predefined_op_v<T, Op>);
+    if constexpr (is_std_op_v<Op_, std::plus, T>) return MPI_SUM;
+    else if constexpr (is_std_op_v<Op_, std::multiplies, T>) return MPI_PROD;
+    else if constexpr (is_std_op_v<Op_, std::logical_and, T>) return MPI_LAND;
+    else if constexpr (is_std_op_v<Op_, std::logical_or, T>) return MPI_LOR;
+    else if constexpr (is_std_op_v<Op_, std::bit_and, T>) return MPI_BAND;
+    else if constexpr (is_std_op_v<Op_, std::bit_or, T>) return MPI_BOR;
+    else return MPI_BXOR;
+  }
+
+  /// The MPI datatype and operation that reduce objects of bitcopyable type @p T with @p Op
+
+  /// Unless they are predefined, the datatype is a contiguous sequence of `sizeof(T)` bytes, and the operation calls
+  /// `op(a, b)` with `a` from the lower rank, hence need not be commutative.
+  template <typename T, typename Op>
+  class reduction {
+    static_assert(is_bitcopy_serialized_v<T>);
+
+    static inline std::remove_reference_t<Op> *user_op = nullptr;
+
+    static void apply(void *in, void *inout, int *len, MPI_Datatype *) {
+      const auto *a = static_cast<const unsigned char *>(in);
+      auto *b = static_cast<unsigned char *>(inout);
+      for (int i = 0; i != *len; ++i, a += sizeof(T), b += sizeof(T)) {
+        alignas(T) unsigned char x[sizeof(T)], y[sizeof(T)];
+        std::memcpy(x, a, sizeof(T));
+        std::memcpy(y, b, sizeof(T));
+        const T result = (*user_op)(*reinterpret_cast<const T *>(x), *reinterpret_cast<const T *>(y));
+        std::memcpy(b, &result, sizeof(T));
+      }
+    }
+
+   public:
+    reduction(std::remove_reference_t<Op> &op, const comm &c) : comm_(c) {
+      if constexpr (has_predefined_op_v<T, Op>) {
+        type_ = predefined_datatype<T>();
+        op_ = predefined_op<T, Op>();
+      } else {
+        user_op = &op;
+        comm_.call([&] {
+          MPI_Type_contiguous(sizeof(T), MPI_BYTE, &type_);
+          MPI_Type_commit(&type_);
+          return MPI_Op_create(&apply, /* commute = */ 0, &op_);
+        });
+      }
+    }
+
+    reduction(const reduction &) = delete;
+    reduction &operator=(const reduction &) = delete;
+
+    ~reduction() {
+      if constexpr (!has_predefined_op_v<T, Op>) {
+        comm_.call([&] {
+          MPI_Op_free(&op_);
+          return MPI_Type_free(&type_);
+        });
+        user_op = nullptr;
+      }
+    }
+
+    MPI_Datatype type() const { return type_; }
+    MPI_Op op() const { return op_; }
+
+   private:
+    const comm &comm_;
+    MPI_Datatype type_;
+    MPI_Op op_;
+  };
+
+  /// starts a nonblocking operation with `start(request)` and waits for its completion
+  template <typename StartOp>
+  void blocking(const comm &c, StartOp &&start) {
+    MPI_Request request;
+    c.call([&] { return start(&request); });
+    c.wait(&request);
+  }
+
+  /// Splits @p n elements into segments of at most @p segment elements and calls `start(first, count, request)` to
+  /// start the nonblocking collective of each, keeping at most max_segments_in_flight of them in flight
+  template <typename StartSegment>
+  void pipeline(std::size_t n, std::size_t segment, const comm &c, StartSegment &&start) {
+    MPI_Request requests[max_segments_in_flight];
+    std::size_t s = 0;
+    for (std::size_t first = 0; first < n; first += segment, ++s) {
+      auto &request = requests[s % max_segments_in_flight];
+      if (s >= max_segments_in_flight) c.wait(&request);
+      c.call([&] { return start(first, static_cast<int>(std::min(segment, n - first)), &request); });
+    }
+    // wait for the segments still in flight
+    for (std::size_t i = s - std::min(s, max_segments_in_flight); i != s; ++i)
+      c.wait(&requests[i % max_segments_in_flight]);
+  }
+
+  /// broadcasts @p size bytes of @p buf from @p root
+  inline void broadcast_bytes(void *buf, std::size_t size, int root, const comm &c) {
+    auto *bytes = static_cast<unsigned char *>(buf);
+    if (size <= segment_size)
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Ibcast(bytes, static_cast<int>(size), MPI_BYTE, root, c.get(), request);
+      });
+    else
+      pipeline(size, segment_size, c, [&](std::size_t first, int count, MPI_Request *request) {
+        return MPI_Ibcast(bytes + first, count, MPI_BYTE, root, c.get(), request);
+      });
+  }
+
+  /// broadcasts @p value from @p root
+  template <typename T>
+  void broadcast(T &value, int root, const comm &c) {
+    if constexpr (is_bitcopy_serialized_v<T>) {
+      broadcast_bytes(&value, sizeof(T), root, c);
+    } else {
+      const int rank = c.rank();
+      // the size, followed by the serialized representation; the first eager_size bytes are broadcast together
+      std::uint64_t size = 0;
+      std::vector<unsigned char> buf(sizeof(size));
+      if (rank == root) {
+        size = pack_payload_growable(value, buf);
+        std::memcpy(buf.data(), &size, sizeof(size));
+      }
+      buf.resize(std::max(buf.size(), eager_size));
+      broadcast_bytes(buf.data(), eager_size, root, c);
+      if (rank != root) std::memcpy(&size, buf.data(), sizeof(size));
+      const std::size_t total = sizeof(size) + size;
+      if (total > eager_size) {
+        if (rank != root) buf.resize(total);
+        broadcast_bytes(buf.data() + eager_size, total - eager_size, root, c);
+      }
+      if (rank != root) data_descriptor_t<T>::unpack_payload(&value, size, sizeof(size), buf.data());
+    }
+  }
+
+  /// @return the values of all processes on @p root , in the order of their ranks; empty on other processes
+  /// @throw std::length_error on every process if the serialized representations of the values are together longer
+  ///        than INT_MAX bytes
+  /// @throw the exception thrown by the serialization of @p value , on the process where it was thrown; the other
+  ///        processes throw std::runtime_error
+  template <typename T>
+  std::vector<T> gather(const T &value, int root, const comm &c) {
+    const int rank = c.rank(), size = c.size();
+    std::vector<T> result(rank == root ? size : 0);
+    if constexpr (is_bitcopy_serialized_v<T>) {
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Igather(&value, sizeof(T), MPI_BYTE, result.data(), sizeof(T), MPI_BYTE, root, c.get(), request);
+      });
+    } else {
+      std::vector<unsigned char> buf;
+      std::uint64_t nbytes = 0;
+      std::exception_ptr error;
+      try {
+        nbytes = pack_payload_growable(value, buf);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      // the total size and the number of failed processes, known to all so that they either all proceed or all throw
+      std::uint64_t status[2] = {nbytes, error ? 1u : 0u};
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Iallreduce(MPI_IN_PLACE, status, 2, MPI_UINT64_T, MPI_SUM, c.get(), request);
+      });
+      if (error) std::rethrow_exception(error);
+      if (status[1] != 0)
+        throw std::runtime_error("ttg::detail::mpi::gather: the serialization failed on another process");
+      // the counts and displacements are ints
+      if (status[0] > INT_MAX)
+        throw std::length_error("ttg::detail::mpi::gather: the serialized values are longer than INT_MAX bytes");
+      const int count = static_cast<int>(nbytes);
+      std::vector<int> counts(rank == root ? size : 0), displs(counts.size());
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Igather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, c.get(), request);
+      });
+      for (std::size_t r = 1; r < counts.size(); ++r) displs[r] = displs[r - 1] + counts[r - 1];
+      std::vector<unsigned char> all(rank == root ? status[0] : 0);
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Igatherv(buf.data(), count, MPI_BYTE, all.data(), counts.data(), displs.data(), MPI_BYTE, root,
+                            c.get(), request);
+      });
+      for (std::size_t r = 0; r != counts.size(); ++r)
+        data_descriptor_t<T>::unpack_payload(&result[r], counts[r], displs[r], all.data());
+    }
+    return result;
+  }
+
+  /// sends @p value to process @p dest , serialized and preceded by its size, in messages of at most segment_size bytes
+  template <typename T>
+  void send_serialized(const T &value, int dest, int tag, const comm &c) {
+    std::vector<unsigned char> buf;
+    const std::uint64_t size = pack_payload_growable(value, buf);
+    blocking(c, [&](MPI_Request *request) { return MPI_Isend(&size, 1, MPI_UINT64_T, dest, tag, c.get(), request); });
+    for (std::size_t first = 0; first < size; first += segment_size)
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Isend(buf.data() + first, static_cast<int>(std::min<std::uint64_t>(segment_size, size - first)),
+                         MPI_BYTE, dest, tag, c.get(), request);
+      });
+  }
+
+  /// receives into @p value an object sent by send_serialized() from process @p source
+  template <typename T>
+  void recv_serialized(T &value, int source, int tag, const comm &c) {
+    std::uint64_t size;
+    blocking(c, [&](MPI_Request *request) { return MPI_Irecv(&size, 1, MPI_UINT64_T, source, tag, c.get(), request); });
+    std::vector<unsigned char> buf(size);
+    for (std::size_t first = 0; first < size; first += segment_size)
+      blocking(c, [&](MPI_Request *request) {
+        return MPI_Irecv(buf.data() + first, static_cast<int>(std::min<std::uint64_t>(segment_size, size - first)),
+                         MPI_BYTE, source, tag, c.get(), request);
+      });
+    data_descriptor_t<T>::unpack_payload(&value, size, 0, buf.data());
+  }
+
+  /// reduces @p n elements of @p values of all processes elementwise with @p op into @p values of @p root
+  template <typename T, typename Op>
+  void reduce(T *values, std::size_t n, Op &&op, int root, const comm &c) {
+    const int rank = c.rank();
+    reduction<T, Op> r(op, c);
+    const std::size_t segment = std::max<std::size_t>(1, segment_size / sizeof(T));
+    pipeline(n, segment, c, [&](std::size_t first, int count, MPI_Request *request) {
+      return MPI_Ireduce(rank == root ? MPI_IN_PLACE : static_cast<void *>(values + first), values + first, count,
+                         r.type(), r.op(), root, c.get(), request);
+    });
+  }
+
+  /// reduces @p n elements of @p values of all processes elementwise with @p op into @p values of every process
+  template <typename T, typename Op>
+  void allreduce(T *values, std::size_t n, Op &&op, const comm &c) {
+    reduction<T, Op> r(op, c);
+    const std::size_t segment = std::max<std::size_t>(1, segment_size / sizeof(T));
+    pipeline(n, segment, c, [&](std::size_t first, int count, MPI_Request *request) {
+      return MPI_Iallreduce(MPI_IN_PLACE, values + first, count, r.type(), r.op(), c.get(), request);
+    });
+  }
+
+  /// reduces @p value of all processes with @p op into @p value of @p root ; @p op combines the values in the order of
+  /// the ranks, hence need be associative but not commutative
+
+  /// Objects of types that are not bitcopyable are reduced along a binomial tree rooted at rank 0 (then sent to
+  /// @p root ), so that every process holds at most two of them at a time and the reduction takes O(log P) steps.
+  /// The tree sends point-to-point messages with tag 0, hence @p c must not be used for other point-to-point
+  /// messages; the backends pass a duplicate of the communicator of the world, made once per world.
+  /// @warning an exception thrown by @p op or by the serialization on some processes leaves the others blocked
+  template <typename T, typename Op>
+  void reduce(T &value, Op &&op, int root, const comm &c) {
+    if constexpr (is_bitcopy_serialized_v<T>) {
+      reduce(&value, 1, op, root, c);
+    } else {
+      const int rank = c.rank(), size = c.size();
+      constexpr int tag = 0;
+      // after step k , process r holds the reduction of the values of ranks [r, r + 2^k)
+      for (int mask = 1; mask < size; mask <<= 1) {
+        if (rank & mask) {
+          send_serialized(value, rank - mask, tag, c);
+          break;
+        }
+        if (rank + mask < size) {
+          T other;
+          recv_serialized(other, rank + mask, tag, c);
+          value = op(value, other);
+        }
+      }
+      if (root != 0) {
+        if (rank == 0) send_serialized(value, root, tag, c);
+        if (rank == root) recv_serialized(value, 0, tag, c);
+      }
+    }
+  }
+
+  /// reduces @p value of all processes with @p op into @p value of every process (see reduce())
+  template <typename T, typename Op>
+  void allreduce(T &value, Op &&op, const comm &c) {
+    if constexpr (is_bitcopy_serialized_v<T>) {
+      allreduce(&value, 1, op, c);
+    } else {
+      reduce(value, op, 0, c);
+      broadcast(value, 0, c);
+    }
+  }
+
+}  // namespace ttg::detail::mpi
+
+#endif  // TTG_UTIL_MPI_COLLECTIVES_H
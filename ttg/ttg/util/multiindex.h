@@ -5,6 +5,13 @@
 #ifndef TTG_UTIL_MULTIINDEX_H
 #define TTG_UTIL_MULTIINDEX_H
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <initializer_list>
+#include <ostream>
+#include <type_traits>
+
 namespace ttg {
 
   template <std::size_t Rank, typename Int = int>
@@ -5,8 +5,10 @@
 #ifndef TTG_TREE_H
 #define TTG_TREE_H
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 namespace ttg {
 
@@ -59,6 +61,90 @@ namespace ttg {
     int root_;
   };
 
+  /// the shapes of SpanningTree
+  enum class TreeShape {
+    /// each node has (up to) 2 children; same as BinarySpanningTree
+    binary,
+    /// each node has (up to) @c arity children
+    kary,
+    /// node @c r (relative to the root) has children @c r+2^j for all @c 2^j smaller than the lowest set bit of @c r
+    /// (all @c 2^j for the root); the depth is @c ceil(log2(size)) but the root has that many children
+    binomial
+  };
+
+  /// @brief a spanning tree of integers in the @c [0,size) interval, of a selectable shape
+  ///
+  /// This is a spanning tree of the complete graph of the @c [0,size) set of <em>keys</em>,
+  /// rooted at a particular key. The binary tree is the same as BinarySpanningTree.
+  class SpanningTree {
+   public:
+    /// @param[in] size the number of keys
+    /// @param[in] root the root key
+    /// @param[in] shape the shape of the tree
+    /// @param[in] arity the (maximum) number of children of a node of a TreeShape::kary tree; ignored otherwise
+    SpanningTree(int size, int root, TreeShape shape = TreeShape::binary, int arity = 2)
+        : size_(size), root_(root), shape_(shape), arity_(shape == TreeShape::binary ? 2 : arity) {
+      assert(root >= 0 && root < size);
+      assert(size >= 0);
+      assert(shape != TreeShape::kary || arity >= 1);
+    }
+    ~SpanningTree() = default;
+
+    /// @return the size of the tree
+    int size() const { return size_; }
+    /// @return the root of the tree
+    int root() const { return root_; }
+    /// @return the shape of the tree
+    TreeShape shape() const { return shape_; }
+
+    /// @param[in] child_key the key of the child
+    /// @return the parent key (-1 if there is no parent)
+    int parent_key(const int child_key) const {
+      const auto child_rank = rank(child_key);
+      if (child_rank == 0) return -1;
+      // the binomial parent has the lowest set bit cleared
+      const auto parent_rank =
+          shape_ == TreeShape::binomial ? child_rank & (child_rank - 1) : (child_rank - 1) / arity_;
+      return key(parent_rank);
+    }
+
+    /// @param[in] parent_key the key of the parent
+    /// @return the number of children of @p parent_key
+    int num_children(const int parent_key) const {
+      const auto parent_rank = rank(parent_key);
+      if (shape_ == TreeShape::binomial) {
+        int n = 0;
+        for (int mask = 1; mask < size_ && (parent_rank & mask) == 0 && (parent_rank | mask) < size_; mask <<= 1) ++n;
+        return n;
+      }
+      const long first_child = static_cast<long>(parent_rank) * arity_ + 1;
+      return static_cast<int>(std::max(0L, std::min(static_cast<long>(arity_), size_ - first_child)));
+    }
+
+    /// @param[in] parent_key the key of the parent
+    /// @return the child keys
+    std::vector<int> child_keys(const int parent_key) const {
+      const auto parent_rank = rank(parent_key);
+      const auto n = num_children(parent_key);
+      std::vector<int> children;
+      children.reserve(n);
+      for (int c = 0; c != n; ++c)
+        children.push_back(key(shape_ == TreeShape::binomial ? parent_rank | (1 << c) : parent_rank * arity_ + 1 + c));
+      return children;
+    }
+
+   private:
+    int size_;
+    int root_;
+    TreeShape shape_;
+    int arity_;
+
+    /// @return @p key cyclically shifted such that the root's is 0
+    int rank(int key) const { return (key + size_ - root_) % size_; }
+    /// the inverse of rank()
+    int key(int rank) const { return (rank + root_) % size_; }
+  };
+
 }  // namespace ttg
 
 #endif  // TTG_TREE_H
@@ -3,8 +3,11 @@
 
 #include "ttg/impl_selector.h"
 
-#include <stdexcept>
 #include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "ttg/base/world.h"
 #include "ttg/base/keymap.h"
@@ -16,6 +19,58 @@ namespace ttg {
   /* Slim wrapper to allow for forward declaration */
   class World : public ttg::base::World<TTG_IMPL_NS::WorldImpl> {
     using ttg::base::World<TTG_IMPL_NS::WorldImpl>::World;
+
+   public:
+    /// @name Collective operations
+    /// These must be called by every process of this World, in the same order, outside of tasks. Values of
+    /// bitcopyable types are communicated as bytes, values of other types are serialized. A reduction operation
+    /// `op(a, b)` returns the combination of `a` and `b`, and is called with `a` from the lower rank; it must be
+    /// associative, but need not be commutative.
+    /// @{
+
+    /// reduces @p value of all processes with @p op into @p value of every process
+    template <typename T, typename Op>
+    void allreduce(T &value, Op &&op) {
+      TTG_IMPL_NS::ttg_allreduce(*this, value, std::forward<Op>(op));
+    }
+
+    /// reduces @p n elements of @p values of all processes elementwise with @p op into @p values of every process
+    /// @note @p T must be bitcopyable; long arrays are reduced in pipelined segments
+    template <typename T, typename Op>
+    void allreduce(T *values, std::size_t n, Op &&op) {
+      TTG_IMPL_NS::ttg_allreduce(*this, values, n, std::forward<Op>(op));
+    }
+
+    /// reduces @p value of all processes with @p op into @p value of process @p root
+    /// @note values of types that are not bitcopyable are reduced along a tree, with O(log P) steps
+    template <typename T, typename Op>
+    void reduce(T &value, Op &&op, int root = 0) {
+      TTG_IMPL_NS::ttg_reduce(*this, value, std::forward<Op>(op), root);
+    }
+
+    /// reduces @p n elements of @p values of all processes elementwise with @p op into @p values of process @p root
+    /// @note @p T must be bitcopyable; long arrays are reduced in pipelined segments
+    template <typename T, typename Op>
+    void reduce(T *values, std::size_t n, Op &&op, int root = 0) {
+      TTG_IMPL_NS::ttg_reduce(*this, values, n, std::forward<Op>(op), root);
+    }
+
+    /// broadcasts @p value from process @p root to every process
+    template <typename T>
+    void broadcast(T &value, int root = 0) {
+      TTG_IMPL_NS::ttg_broadcast(*this, value, root);
+    }
+
+    /// @return the values of all processes, in the order of their ranks, on process @p root ; empty on other processes
+    /// @throw std::length_error on every process if the serialized values are together longer than INT_MAX bytes
+    /// @throw std::runtime_error (or the exception of the serialization, where it failed) on every process if
+    ///        serializing @p value failed on any
+    template <typename T>
+    std::vector<T> gather(const T &value, int root = 0) {
+      return TTG_IMPL_NS::ttg_gather(*this, value, root);
+    }
+
+    /// @}
   };
 
   namespace detail {